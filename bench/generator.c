@@ -0,0 +1,471 @@
+/// @file generator.c
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Deterministic generator of synthetic MRF, SAM, BED and wig inputs used by
+/// the benchmarks. The same configuration and seed always produce the same
+/// bytes, so results of different builds can be compared.
+
+#include <bios/log.h>
+#include <bios/format.h>
+
+#include "mrf/mrf.h"
+#include "mrf/sam.h"
+#include "generator.h"
+
+#define GEN_MAX_READ_LENGTH 10000
+#define GEN_MIN_INTRON 50
+#define GEN_MAX_INTRON 5000
+#define GEN_MIN_INSERT 150
+#define GEN_MAX_INSERT 450
+
+typedef struct {
+  int numBlocks;
+  char strand;
+  int targetStart[2];
+  int targetEnd[2];
+  int queryStart[2];
+  int queryEnd[2];
+  char sequence[GEN_MAX_READ_LENGTH + 1];
+  char qualityScores[GEN_MAX_READ_LENGTH + 1];
+} GenRead;
+
+static unsigned long long rngState;
+
+static void gen_seed (unsigned long seed)
+{
+  rngState = 0x9E3779B97F4A7C15ULL ^ (unsigned long long)seed;
+  if (rngState == 0) {
+    rngState = 1;
+  }
+}
+
+// xorshift64*: fast, deterministic and identical on every platform
+static unsigned long long gen_next (void)
+{
+  rngState ^= rngState >> 12;
+  rngState ^= rngState << 25;
+  rngState ^= rngState >> 27;
+  return rngState * 0x2545F4914F6CDD1DULL;
+}
+
+static int gen_uniform (int lo, int hi)
+{
+  return lo + (int)(gen_next () % (unsigned long long)(hi - lo + 1));
+}
+
+static double gen_fraction (void)
+{
+  return (gen_next () >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * Fill a GenConfig with the default parameters.
+ */
+void gen_initConfig (GenConfig *config)
+{
+  config->numRecords = 1000000;
+  config->readLength = 76;
+  config->spliceRate = 0.2;
+  config->pairedFraction = 0.5;
+  config->numTargets = 24;
+  config->targetLength = 100000000;
+  config->seed = 1;
+  config->columns = (1 << MRF_COLUMN_TYPE_BLOCKS) |
+                    (1 << MRF_COLUMN_TYPE_SEQUENCE) |
+                    (1 << MRF_COLUMN_TYPE_QUALITY_SCORES) |
+                    (1 << MRF_COLUMN_TYPE_QUERY_ID);
+}
+
+/**
+ * Map a format name (mrf, sam, bed, wig, bedgraph) to its GEN_FORMAT code.
+ */
+int gen_parseFormat (char *format)
+{
+  if (strEqual (format,"mrf")) {
+    return GEN_FORMAT_MRF;
+  }
+  else if (strEqual (format,"sam")) {
+    return GEN_FORMAT_SAM;
+  }
+  else if (strEqual (format,"bed")) {
+    return GEN_FORMAT_BED;
+  }
+  else if (strEqual (format,"wig")) {
+    return GEN_FORMAT_WIG;
+  }
+  else if (strEqual (format,"bedgraph")) {
+    return GEN_FORMAT_BEDGRAPH;
+  }
+  die ("Unknown format: %s",format);
+  return 0;
+}
+
+/**
+ * Convert a comma-separated list of MRF column names into a column bitmask.
+ * AlignmentBlocks is always included.
+ */
+int gen_parseColumns (char *columnList)
+{
+  Texta tokens;
+  int i;
+  int columns;
+
+  columns = 1 << MRF_COLUMN_TYPE_BLOCKS;
+  tokens = textFieldtok (columnList,",");
+  for (i = 0; i < arrayMax (tokens); i++) {
+    if (strEqual (textItem (tokens,i),MRF_COLUMN_NAME_BLOCKS)) {
+      continue;
+    }
+    else if (strEqual (textItem (tokens,i),MRF_COLUMN_NAME_SEQUENCE)) {
+      columns |= 1 << MRF_COLUMN_TYPE_SEQUENCE;
+    }
+    else if (strEqual (textItem (tokens,i),MRF_COLUMN_NAME_QUALITY_SCORES)) {
+      columns |= 1 << MRF_COLUMN_TYPE_QUALITY_SCORES;
+    }
+    else if (strEqual (textItem (tokens,i),MRF_COLUMN_NAME_QUERY_ID)) {
+      columns |= 1 << MRF_COLUMN_TYPE_QUERY_ID;
+    }
+    else {
+      die ("Unknown column: %s",textItem (tokens,i));
+    }
+  }
+  textDestroy (tokens);
+  return columns;
+}
+
+static void gen_makeRead (GenConfig *config, int start, char strand, GenRead *read)
+{
+  static const char bases[] = "ACGT";
+  int length,split,intron;
+  int i;
+
+  length = config->readLength;
+  read->strand = strand;
+  if (length >= 10 && gen_fraction () < config->spliceRate) {
+    split = gen_uniform (5,length - 5);
+    intron = gen_uniform (GEN_MIN_INTRON,GEN_MAX_INTRON);
+    read->numBlocks = 2;
+    read->targetStart[0] = start;
+    read->targetEnd[0] = start + split - 1;
+    read->queryStart[0] = 1;
+    read->queryEnd[0] = split;
+    read->targetStart[1] = read->targetEnd[0] + intron + 1;
+    read->targetEnd[1] = read->targetStart[1] + length - split - 1;
+    read->queryStart[1] = split + 1;
+    read->queryEnd[1] = length;
+  }
+  else {
+    read->numBlocks = 1;
+    read->targetStart[0] = start;
+    read->targetEnd[0] = start + length - 1;
+    read->queryStart[0] = 1;
+    read->queryEnd[0] = length;
+  }
+  for (i = 0; i < length; i++) {
+    read->sequence[i] = gen_uniform (0,199) == 0 ? 'N' : bases[gen_next () & 3];
+    // Illumina 1.8+ style qualities, mostly high with a tail towards the 3' end
+    read->qualityScores[i] = (char)(33 + 40 - gen_uniform (0,2 + (i * 20) / length));
+  }
+  read->sequence[length] = '\0';
+  read->qualityScores[length] = '\0';
+}
+
+static int gen_readEnd (GenRead *read)
+{
+  return read->targetEnd[read->numBlocks - 1];
+}
+
+static void gen_writeMrfBlocks (FILE *fp, char *targetName, GenRead *read)
+{
+  int i;
+
+  for (i = 0; i < read->numBlocks; i++) {
+    fprintf (fp,"%s%s:%c:%d:%d:%d:%d",i > 0 ? "," : "",targetName,read->strand,
+             read->targetStart[i],read->targetEnd[i],
+             read->queryStart[i],read->queryEnd[i]);
+  }
+}
+
+static void gen_writeMrfColumn (FILE *fp, int columnType, char *targetName,
+                                long id, int isPairedEnd, GenRead *read1, GenRead *read2)
+{
+  if (columnType == MRF_COLUMN_TYPE_BLOCKS) {
+    gen_writeMrfBlocks (fp,targetName,read1);
+    if (isPairedEnd) {
+      fputc ('|',fp);
+      gen_writeMrfBlocks (fp,targetName,read2);
+    }
+  }
+  else if (columnType == MRF_COLUMN_TYPE_SEQUENCE) {
+    fputs (read1->sequence,fp);
+    if (isPairedEnd) {
+      fprintf (fp,"|%s",read2->sequence);
+    }
+  }
+  else if (columnType == MRF_COLUMN_TYPE_QUALITY_SCORES) {
+    fputs (read1->qualityScores,fp);
+    if (isPairedEnd) {
+      fprintf (fp,"|%s",read2->qualityScores);
+    }
+  }
+  else if (columnType == MRF_COLUMN_TYPE_QUERY_ID) {
+    fprintf (fp,"GEN_1:1:%ld:%ld",id / 100000,id % 100000);
+    if (isPairedEnd) {
+      fprintf (fp,"|GEN_1:1:%ld:%ld",id / 100000,id % 100000);
+    }
+  }
+}
+
+static void gen_writeMrf (FILE *fp, GenConfig *config)
+{
+  static const int columnOrder[] = {MRF_COLUMN_TYPE_BLOCKS,MRF_COLUMN_TYPE_SEQUENCE,
+                                    MRF_COLUMN_TYPE_QUALITY_SCORES,MRF_COLUMN_TYPE_QUERY_ID};
+  static const char *columnNames[] = {MRF_COLUMN_NAME_BLOCKS,MRF_COLUMN_NAME_SEQUENCE,
+                                      MRF_COLUMN_NAME_QUALITY_SCORES,MRF_COLUMN_NAME_QUERY_ID};
+  static GenRead read1,read2;
+  char targetName[32];
+  long id,perTarget,n;
+  int t,c,first,start,isPairedEnd,spacing;
+
+  fprintf (fp,"# Synthetic MRF, seed %lu\n",config->seed);
+  first = 1;
+  for (c = 0; c < 4; c++) {
+    if (config->columns & (1 << columnOrder[c])) {
+      fprintf (fp,"%s%s",first ? "" : "\t",columnNames[c]);
+      first = 0;
+    }
+  }
+  fputc ('\n',fp);
+  perTarget = (config->numRecords + config->numTargets - 1) / config->numTargets;
+  spacing = (int)(config->targetLength / (perTarget + 1));
+  if (spacing < 1) {
+    spacing = 1;
+  }
+  id = 0;
+  for (t = 1; t <= config->numTargets && id < config->numRecords; t++) {
+    sprintf (targetName,"chr%d",t);
+    start = 1;
+    for (n = 0; n < perTarget && id < config->numRecords; n++) {
+      start += gen_uniform (0,2 * spacing - 1) / 2;
+      isPairedEnd = gen_fraction () < config->pairedFraction;
+      gen_makeRead (config,start,gen_next () & 1 ? '+' : '-',&read1);
+      if (isPairedEnd) {
+        gen_makeRead (config,start + gen_uniform (GEN_MIN_INSERT,GEN_MAX_INSERT),
+                      read1.strand == '+' ? '-' : '+',&read2);
+      }
+      first = 1;
+      for (c = 0; c < 4; c++) {
+        if (config->columns & (1 << columnOrder[c])) {
+          if (!first) {
+            fputc ('\t',fp);
+          }
+          gen_writeMrfColumn (fp,columnOrder[c],targetName,id,isPairedEnd,&read1,&read2);
+          first = 0;
+        }
+      }
+      fputc ('\n',fp);
+      id++;
+    }
+  }
+}
+
+static void gen_writeCigar (FILE *fp, GenRead *read)
+{
+  int i;
+
+  for (i = 0; i < read->numBlocks; i++) {
+    if (i > 0) {
+      fprintf (fp,"%dN",read->targetStart[i] - read->targetEnd[i - 1] - 1);
+    }
+    fprintf (fp,"%dM",read->queryEnd[i] - read->queryStart[i] + 1);
+  }
+}
+
+static int gen_pairedFlags (GenRead *read, GenRead *mate)
+{
+  int flags;
+
+  flags = S_READ_PAIRED | S_PAIR_MAPPED;
+  if (read->strand == '-') {
+    flags |= S_QUERY_STRAND;
+  }
+  if (mate->strand == '-') {
+    flags |= S_MATE_STRAND;
+  }
+  return flags;
+}
+
+static void gen_writeSamLine (FILE *fp, char *targetName, long id, int flags,
+                              GenRead *read, GenRead *mate)
+{
+  int isize;
+
+  fprintf (fp,"GEN_1:1:%ld:%ld\t%d\t%s\t%d\t%d\t",id / 100000,id % 100000,flags,
+           targetName,read->targetStart[0],gen_uniform (0,60));
+  gen_writeCigar (fp,read);
+  if (mate != NULL) {
+    isize = read->targetStart[0] <= mate->targetStart[0] ?
+      gen_readEnd (mate) - read->targetStart[0] + 1 :
+      -(gen_readEnd (read) - mate->targetStart[0] + 1);
+    fprintf (fp,"\t=\t%d\t%d",mate->targetStart[0],isize);
+  }
+  else {
+    fputs ("\t*\t0\t0",fp);
+  }
+  fprintf (fp,"\t%s\t%s\tNM:i:0\tNH:i:1\n",read->sequence,read->qualityScores);
+}
+
+static void gen_writeSam (FILE *fp, GenConfig *config)
+{
+  static GenRead read1,read2;
+  char targetName[32];
+  long id,perTarget,n;
+  int t,start,flags,spacing;
+
+  fprintf (fp,"@HD\tVN:1.4\tSO:unsorted\n");
+  for (t = 1; t <= config->numTargets; t++) {
+    fprintf (fp,"@SQ\tSN:chr%d\tLN:%d\n",t,config->targetLength);
+  }
+  fprintf (fp,"@PG\tID:mrfGen\tPN:mrfGen\n");
+  perTarget = (config->numRecords + config->numTargets - 1) / config->numTargets;
+  spacing = (int)(config->targetLength / (perTarget + 1));
+  if (spacing < 1) {
+    spacing = 1;
+  }
+  id = 0;
+  for (t = 1; t <= config->numTargets && id < config->numRecords; t++) {
+    sprintf (targetName,"chr%d",t);
+    start = 1;
+    for (n = 0; n < perTarget && id < config->numRecords; n++) {
+      start += gen_uniform (0,2 * spacing - 1) / 2;
+      gen_makeRead (config,start,gen_next () & 1 ? '+' : '-',&read1);
+      if (gen_fraction () < config->pairedFraction) {
+        gen_makeRead (config,start + gen_uniform (GEN_MIN_INSERT,GEN_MAX_INSERT),
+                      read1.strand == '+' ? '-' : '+',&read2);
+        flags = gen_pairedFlags (&read1,&read2);
+        gen_writeSamLine (fp,targetName,id,flags | S_FIRST,&read1,&read2);
+        flags = gen_pairedFlags (&read2,&read1);
+        gen_writeSamLine (fp,targetName,id,flags | S_SECOND,&read2,&read1);
+      }
+      else {
+        gen_writeSamLine (fp,targetName,id,read1.strand == '-' ? S_QUERY_STRAND : 0,
+                          &read1,NULL);
+      }
+      id++;
+    }
+  }
+}
+
+static void gen_writeBed (FILE *fp, GenConfig *config)
+{
+  long id,perTarget,n;
+  int t,start,spacing;
+
+  fprintf (fp,"track name=synthetic description=\"Synthetic TARs\"\n");
+  perTarget = (config->numRecords + config->numTargets - 1) / config->numTargets;
+  spacing = (int)(config->targetLength / (perTarget + 1));
+  if (spacing < 2) {
+    spacing = 2;
+  }
+  id = 0;
+  for (t = 1; t <= config->numTargets && id < config->numRecords; t++) {
+    start = 0;
+    for (n = 0; n < perTarget && id < config->numRecords; n++) {
+      start += gen_uniform (1,2 * spacing - 1);
+      fprintf (fp,"chr%d\t%d\t%d\ttar%ld\n",t,start,start + gen_uniform (1,spacing),id);
+      id++;
+    }
+  }
+}
+
+// Piecewise-constant signal with islands of expression on a noisy background
+static float gen_signal (int *runLeft, float *level)
+{
+  if (*runLeft == 0) {
+    *runLeft = gen_uniform (1,500);
+    *level = gen_uniform (0,3) == 0 ? (float)gen_uniform (5,200) : 0.0f;
+  }
+  (*runLeft)--;
+  return *level > 0 ? *level + (float)gen_uniform (0,100) / 100.0f :
+    (float)gen_uniform (0,50) / 100.0f;
+}
+
+static void gen_writeWig (FILE *fp, GenConfig *config)
+{
+  long id,perTarget,n;
+  int t,runLeft;
+  float level;
+
+  fprintf (fp,"track type=wiggle_0 name=synthetic\n");
+  perTarget = (config->numRecords + config->numTargets - 1) / config->numTargets;
+  id = 0;
+  runLeft = 0;
+  level = 0;
+  for (t = 1; t <= config->numTargets && id < config->numRecords; t++) {
+    fprintf (fp,"fixedStep chrom=chr%d start=1 step=1\n",t);
+    for (n = 0; n < perTarget && id < config->numRecords; n++) {
+      fprintf (fp,"%.2f\n",gen_signal (&runLeft,&level));
+      id++;
+    }
+  }
+}
+
+static void gen_writeBedGraph (FILE *fp, GenConfig *config)
+{
+  long id,perTarget,n;
+  int t,start,length;
+  float level;
+
+  fprintf (fp,"track type=bedGraph name=synthetic\n");
+  perTarget = (config->numRecords + config->numTargets - 1) / config->numTargets;
+  id = 0;
+  for (t = 1; t <= config->numTargets && id < config->numRecords; t++) {
+    start = 0;
+    for (n = 0; n < perTarget && id < config->numRecords; n++) {
+      length = gen_uniform (1,200);
+      level = gen_uniform (0,3) == 0 ? (float)gen_uniform (5,200) :
+        (float)gen_uniform (0,50) / 100.0f;
+      fprintf (fp,"chr%d\t%d\t%d\t%.2f\n",t,start,start + length,level);
+      start += length;
+      id++;
+    }
+  }
+}
+
+/**
+ * Write a synthetic data set.
+ * @param[in] fp Output stream
+ * @param[in] format One of the GEN_FORMAT codes
+ * @param[in] config Parameters of the data set
+ */
+void gen_write (FILE *fp, int format, GenConfig *config)
+{
+  if (config->readLength < 1 || config->readLength > GEN_MAX_READ_LENGTH) {
+    die ("Read length must be between 1 and %d",GEN_MAX_READ_LENGTH);
+  }
+  if (config->numTargets < 1) {
+    die ("At least one target is required");
+  }
+  gen_seed (config->seed);
+  if (format == GEN_FORMAT_MRF) {
+    gen_writeMrf (fp,config);
+  }
+  else if (format == GEN_FORMAT_SAM) {
+    gen_writeSam (fp,config);
+  }
+  else if (format == GEN_FORMAT_BED) {
+    gen_writeBed (fp,config);
+  }
+  else if (format == GEN_FORMAT_WIG) {
+    gen_writeWig (fp,config);
+  }
+  else if (format == GEN_FORMAT_BEDGRAPH) {
+    gen_writeBedGraph (fp,config);
+  }
+  else {
+    die ("Unknown format: %d",format);
+  }
+}
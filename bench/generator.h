@@ -0,0 +1,39 @@
+/// @file generator.h
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Deterministic generator of synthetic MRF, SAM, BED and wig inputs used by
+/// the benchmarks.
+
+#ifndef DEF_GENERATOR_H
+#define DEF_GENERATOR_H
+
+#include <stdio.h>
+
+#define GEN_FORMAT_MRF 1
+#define GEN_FORMAT_SAM 2
+#define GEN_FORMAT_BED 3
+#define GEN_FORMAT_WIG 4
+#define GEN_FORMAT_BEDGRAPH 5
+
+/// @struct GenConfig
+/// @brief Parameters of a synthetic data set.
+typedef struct {
+  long numRecords;        // Reads, intervals or wig positions to emit
+  int readLength;         // Length of each read in bases
+  double spliceRate;      // Fraction of reads split into two blocks
+  double pairedFraction;  // Fraction of entries that are paired-end
+  int numTargets;         // Number of chromosomes (chr1 .. chrN)
+  int targetLength;       // Length of each chromosome
+  unsigned long seed;     // Seed of the pseudo random number generator
+  int columns;            // Bitmask of MRF column types (1 << type)
+} GenConfig;
+
+void gen_initConfig (GenConfig *config);
+int gen_parseFormat (char *format);
+int gen_parseColumns (char *columnList);
+void gen_write (FILE *fp, int format, GenConfig *config);
+
+#endif /* DEF_GENERATOR_H */
@@ -0,0 +1,750 @@
+/// @file mrfBench.c
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Benchmark harness for the public entry points of libmrf. Synthetic inputs
+/// are generated into a scratch directory, every benchmark runs in its own
+/// child process and one JSON object per benchmark is written to the output,
+/// e.g.
+///
+/// {"benchmark":"mrf_nextEntry","records":1000000,"bytes":311458312,
+///  "seconds":1.52,"records_per_s":657894.7,"mb_per_s":195.4,
+///  "allocations":9000012,"alloc_bytes":301234567,"peak_rss_kb":3120}
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include <bios/log.h>
+#include <bios/format.h>
+#include <bios/common.h>
+
+#include "mrf/mrf.h"
+#include "mrf/mrfStore.h"
+#include "mrf/pipeline.h"
+#include "mrf/dedup.h"
+#include "mrf/convert.h"
+#include "mrf/junction.h"
+#include "mrf/sam.h"
+#include "mrf/mrfUtil.h"
+#include "mrf/segmentationUtil.h"
+#include "mrf/wigParser.h"
+#include "mrf/qc.h"
+#include "mrf/idIndex.h"
+#include "mrf/tarCache.h"
+#include "generator.h"
+
+typedef struct {
+  char name[64];
+  long records;
+  long long bytes;
+  double seconds;
+  long long allocations;
+  long long allocBytes;
+} BenchResult;
+
+typedef struct {
+  char *name;
+  void (*run) (BenchResult *result);
+} Benchmark;
+
+static char mrfFile[4096];
+static char samFile[4096];
+static char bedFile[4096];
+static char wigFile[4096];
+
+/*
+ * Allocation accounting. The harness replaces the malloc family, which glibc
+ * supports, so that allocations made inside libmrf and libbios are counted
+ * as well. Counting is only active inside the timed section and is atomic
+ * because the pipeline benchmark allocates on several threads.
+ */
+
+extern void *__libc_malloc (size_t size);
+extern void *__libc_calloc (size_t nmemb, size_t size);
+extern void *__libc_realloc (void *ptr, size_t size);
+extern void *__libc_memalign (size_t alignment, size_t size);
+extern void __libc_free (void *ptr);
+
+static int countAllocations = 0;
+static long long numAllocations = 0;
+static long long numAllocatedBytes = 0;
+
+void *malloc (size_t size)
+{
+  if (countAllocations) {
+    __atomic_add_fetch (&numAllocations,1,__ATOMIC_RELAXED);
+    __atomic_add_fetch (&numAllocatedBytes,size,__ATOMIC_RELAXED);
+  }
+  return __libc_malloc (size);
+}
+
+void *calloc (size_t nmemb, size_t size)
+{
+  if (countAllocations) {
+    __atomic_add_fetch (&numAllocations,1,__ATOMIC_RELAXED);
+    __atomic_add_fetch (&numAllocatedBytes,nmemb * size,__ATOMIC_RELAXED);
+  }
+  return __libc_calloc (nmemb,size);
+}
+
+void *realloc (void *ptr, size_t size)
+{
+  if (countAllocations) {
+    __atomic_add_fetch (&numAllocations,1,__ATOMIC_RELAXED);
+    __atomic_add_fetch (&numAllocatedBytes,size,__ATOMIC_RELAXED);
+  }
+  return __libc_realloc (ptr,size);
+}
+
+void *memalign (size_t alignment, size_t size)
+{
+  if (countAllocations) {
+    __atomic_add_fetch (&numAllocations,1,__ATOMIC_RELAXED);
+    __atomic_add_fetch (&numAllocatedBytes,size,__ATOMIC_RELAXED);
+  }
+  return __libc_memalign (alignment,size);
+}
+
+int posix_memalign (void **ptr, size_t alignment, size_t size)
+{
+  *ptr = memalign (alignment,size);
+  return *ptr == NULL ? ENOMEM : 0;
+}
+
+void *aligned_alloc (size_t alignment, size_t size)
+{
+  return memalign (alignment,size);
+}
+
+void free (void *ptr)
+{
+  __libc_free (ptr);
+}
+
+static double bench_now (void)
+{
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC,&ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static double startTime;
+
+static void bench_start (void)
+{
+  numAllocations = 0;
+  numAllocatedBytes = 0;
+  countAllocations = 1;
+  startTime = bench_now ();
+}
+
+static void bench_stop (BenchResult *result)
+{
+  result->seconds = bench_now () - startTime;
+  countAllocations = 0;
+  result->allocations = numAllocations;
+  result->allocBytes = numAllocatedBytes;
+}
+
+static long long bench_fileSize (char *fileName)
+{
+  struct stat st;
+
+  if (stat (fileName,&st) != 0) {
+    die ("Unable to stat %s",fileName);
+  }
+  return st.st_size;
+}
+
+static void bench_mrfNextEntry (BenchResult *result)
+{
+  bench_start ();
+  mrf_init (mrfFile);
+  while (mrf_nextEntry ()) {
+    result->records++;
+  }
+  mrf_deInit ();
+  bench_stop (result);
+  result->bytes = bench_fileSize (mrfFile);
+}
+
+static void bench_mrfNextEntryBlocks (BenchResult *result)
+{
+  bench_start ();
+  mrf_initWithColumns (mrfFile,MRF_COLUMN_MASK (MRF_COLUMN_TYPE_BLOCKS));
+  while (mrf_nextEntry ()) {
+    result->records++;
+  }
+  mrf_deInit ();
+  bench_stop (result);
+  result->bytes = bench_fileSize (mrfFile);
+}
+
+static void bench_mrfParse (BenchResult *result)
+{
+  Array entries;
+
+  bench_start ();
+  mrf_init (mrfFile);
+  entries = mrf_parse ();
+  mrf_deInit ();
+  bench_stop (result);
+  result->records = arrayMax (entries);
+  result->bytes = bench_fileSize (mrfFile);
+}
+
+static void bench_mrfStoreParse (BenchResult *result)
+{
+  MrfStore *store;
+
+  bench_start ();
+  mrf_init (mrfFile);
+  store = mrfStore_parse ();
+  mrf_deInit ();
+  bench_stop (result);
+  result->records = mrfStore_numEntries (store);
+  result->bytes = bench_fileSize (mrfFile);
+  mrfStore_destroy (store);
+}
+
+static void bench_mrfStoreParsePacked (BenchResult *result)
+{
+  MrfStore *store;
+
+  bench_start ();
+  mrf_init (mrfFile);
+  store = mrfStore_parsePacked (MRF_STORE_PACK_SEQUENCES | MRF_STORE_BIN_QUALITIES);
+  mrf_deInit ();
+  bench_stop (result);
+  result->records = mrfStore_numEntries (store);
+  result->bytes = bench_fileSize (mrfFile);
+  mrfStore_destroy (store);
+}
+
+static void bench_mrfWriteEntry (BenchResult *result)
+{
+  Array entries;
+  int i;
+
+  mrf_init (mrfFile);
+  entries = mrf_parse ();
+  bench_start ();
+  for (i = 0; i < arrayMax (entries); i++) {
+    result->bytes += strlen (mrf_writeEntry (arrp (entries,i,MrfEntry))) + 1;
+  }
+  bench_stop (result);
+  result->records = arrayMax (entries);
+  mrf_deInit ();
+}
+
+static void bench_mrfDedupNextEntry (BenchResult *result)
+{
+  bench_start ();
+  mrf_init (mrfFile);
+  mrfDedup_init (MRF_DEDUP_MARK);
+  while (mrfDedup_nextEntry (NULL)) {
+    result->records++;
+  }
+  mrfDedup_deInit ();
+  mrf_deInit ();
+  bench_stop (result);
+  result->bytes = bench_fileSize (mrfFile);
+}
+
+static void bench_mrfJunctionAddEntry (BenchResult *result)
+{
+  MrfJunctionTable *table;
+  MrfEntry *currEntry;
+
+  bench_start ();
+  mrf_init (mrfFile);
+  table = mrfJunction_createTable (1);
+  while (currEntry = mrf_nextEntry ()) {
+    mrfJunction_addEntry (table,currEntry);
+    result->records++;
+  }
+  mrf_deInit ();
+  bench_stop (result);
+  result->bytes = bench_fileSize (mrfFile);
+  mrfJunction_destroyTable (table);
+}
+
+static void bench_mrfQcAddEntry (BenchResult *result)
+{
+  MrfEntry *currEntry;
+  MrfQc *qc;
+
+  bench_start ();
+  mrf_init (mrfFile);
+  qc = mrfQc_create ();
+  while (currEntry = mrf_nextEntry ()) {
+    mrfQc_addEntry (qc,currEntry);
+    result->records++;
+  }
+  mrfQc_flush (qc);
+  mrf_deInit ();
+  bench_stop (result);
+  result->bytes = bench_fileSize (mrfFile);
+  mrfQc_destroy (qc);
+}
+
+// Fetch a sparse batch of every 97th read ID through a fresh index
+static void bench_mrfFetchById (BenchResult *result)
+{
+  Stringa indexFileName;
+  IdIndex *index;
+  MrfEntry *currEntry;
+  Texta ids;
+  Array entries;
+  long numEntries;
+  int i;
+
+  indexFileName = stringCreate (100);
+  stringPrintf (indexFileName,"%s.iidx",mrfFile);
+  idIndex_build (mrfFile,string (indexFileName));
+  ids = textCreate (1000);
+  mrf_init (mrfFile);
+  numEntries = 0;
+  while (currEntry = mrf_nextEntry ()) {
+    if (numEntries++ % 97 == 0 && currEntry->read1.queryId != NULL) {
+      textAdd (ids,currEntry->read1.queryId);
+    }
+  }
+  mrf_deInit ();
+  bench_start ();
+  mrf_init (mrfFile);
+  index = idIndex_open (string (indexFileName));
+  entries = mrf_fetchById (index,mrfFile,ids);
+  result->records = arrayMax (entries);
+  for (i = 0; i < arrayMax (entries); i++) {
+    mrf_freeEntry (arru (entries,i,MrfEntry*));
+  }
+  idIndex_close (index);
+  mrf_deInit ();
+  bench_stop (result);
+  arrayDestroy (entries);
+  textDestroy (ids);
+  unlink (string (indexFileName));
+  stringDestroy (indexFileName);
+}
+
+// Drop entries with a spliced first read, a stand-in for a filter tool
+static void bench_dropSpliced (MrfBatch *batch, void *userData)
+{
+  int i;
+
+  __atomic_add_fetch ((long*)userData,batch->numEntries,__ATOMIC_RELAXED);
+  for (i = 0; i < batch->numEntries; i++) {
+    batch->keep[i] = arrayMax (batch->entries[i]->read1.blocks) == 1;
+  }
+}
+
+static void bench_mrfPipelineRun (BenchResult *result)
+{
+  MrfPipelineConfig config;
+  FILE *out;
+
+  out = fopen ("/dev/null","w");
+  if (out == NULL) {
+    die ("Unable to open /dev/null");
+  }
+  mrfPipeline_initConfig (&config);
+  bench_start ();
+  mrf_init (mrfFile);
+  fprintf (out,"%s\n",mrf_writeHeader ());
+  mrfPipeline_run (&config,bench_dropSpliced,&result->records,out);
+  mrf_deInit ();
+  bench_stop (result);
+  fclose (out);
+  result->bytes = bench_fileSize (mrfFile);
+}
+
+static void bench_genCigar (BenchResult *result)
+{
+  Array entries;
+  MrfEntry *currEntry;
+  Stringa cigar;
+  int i;
+
+  mrf_init (mrfFile);
+  entries = mrf_parse ();
+  bench_start ();
+  for (i = 0; i < arrayMax (entries); i++) {
+    currEntry = arrp (entries,i,MrfEntry);
+    cigar = genCigar (&currEntry->read1);
+    result->bytes += stringLen (cigar);
+    stringDestroy (cigar);
+    result->records++;
+    if (currEntry->isPairedEnd) {
+      cigar = genCigar (&currEntry->read2);
+      result->bytes += stringLen (cigar);
+      stringDestroy (cigar);
+      result->records++;
+    }
+  }
+  bench_stop (result);
+  mrf_deInit ();
+}
+
+static void bench_mrfConvertWriteSam (BenchResult *result)
+{
+  Array entries;
+  MrfEntry **pointers;
+  FILE *out;
+  int i;
+
+  out = fopen ("/dev/null","w");
+  if (out == NULL) {
+    die ("Unable to open /dev/null");
+  }
+  mrf_init (mrfFile);
+  entries = mrf_parse ();
+  pointers = (MrfEntry**)needMem (arrayMax (entries) * sizeof (MrfEntry*));
+  for (i = 0; i < arrayMax (entries); i++) {
+    pointers[i] = arrp (entries,i,MrfEntry);
+  }
+  bench_start ();
+  result->bytes = mrfConvert_writeSamBatch (pointers,arrayMax (entries),
+                                            sysconf (_SC_NPROCESSORS_ONLN),out);
+  bench_stop (result);
+  result->records = arrayMax (entries);
+  fclose (out);
+  mrf_deInit ();
+}
+
+static void bench_samNextEntry (BenchResult *result)
+{
+  bench_start ();
+  samParser_initFromFile (samFile);
+  while (samParser_nextEntry ()) {
+    result->records++;
+  }
+  samParser_deInit ();
+  bench_stop (result);
+  result->bytes = bench_fileSize (samFile);
+}
+
+// The usual downstream filter: primary, passing, non-duplicate alignments
+// with MAPQ 20 or more
+static void bench_samNextEntryFiltered (BenchResult *result)
+{
+  SamFilter filter;
+
+  filter.requiredFlags = 0;
+  filter.excludedFlags = S_QUERY_UNMAPPED | S_NOT_PRIMARY | S_FAILS_CHECKS | S_DUPLICATE;
+  filter.minMapq = 20;
+  filter.targetNames = NULL;
+  bench_start ();
+  samParser_initFromFile (samFile);
+  samParser_setFilter (&filter);
+  while (samParser_nextEntry ()) {
+    result->records++;
+  }
+  samParser_deInit ();
+  bench_stop (result);
+  result->bytes = bench_fileSize (samFile);
+}
+
+static void bench_samGetCigar (BenchResult *result)
+{
+  Texta cigars;
+  Array operations;
+  SamEntry *currSamEntry;
+  int i;
+
+  cigars = textCreate (100000);
+  samParser_initFromFile (samFile);
+  while ((currSamEntry = samParser_nextEntry ()) != NULL) {
+    textAdd (cigars,currSamEntry->cigar);
+  }
+  samParser_deInit ();
+  bench_start ();
+  for (i = 0; i < arrayMax (cigars); i++) {
+    operations = samParser_getCigar (textItem (cigars,i));
+    result->bytes += strlen (textItem (cigars,i));
+    arrayDestroy (operations);
+  }
+  bench_stop (result);
+  result->records = arrayMax (cigars);
+  textDestroy (cigars);
+}
+
+static void bench_readTarsFromBedFile (BenchResult *result)
+{
+  Array tars;
+
+  bench_start ();
+  tars = readTarsFromBedFile (bedFile);
+  bench_stop (result);
+  result->records = arrayMax (tars);
+  result->bytes = bench_fileSize (bedFile);
+}
+
+// Attach a published cache and take its tars, the cached counterpart of
+// readTarsFromBedFile
+static void bench_tarCacheAttach (BenchResult *result)
+{
+  Stringa cacheFileName;
+  TarCache *cache;
+  Array tars;
+
+  cacheFileName = stringCreate (100);
+  stringPrintf (cacheFileName,"%s.tcache",bedFile);
+  tarCache_build (bedFile,string (cacheFileName));
+  bench_start ();
+  cache = tarCache_attach (bedFile,string (cacheFileName));
+  tars = tarCache_getTars (cache);
+  bench_stop (result);
+  result->records = arrayMax (tars);
+  result->bytes = bench_fileSize (string (cacheFileName));
+  arrayDestroy (tars);
+  tarCache_close (cache);
+  unlink (string (cacheFileName));
+  stringDestroy (cacheFileName);
+}
+
+static void bench_wigNextTarget (BenchResult *result)
+{
+  Array wigs;
+
+  wigs = arrayCreate (1000000,Wig);
+  bench_start ();
+  wigParser_init (wigFile);
+  while (wigParser_nextTarget (wigs) != NULL) {
+    result->records += arrayMax (wigs);
+  }
+  wigParser_deInit ();
+  bench_stop (result);
+  result->bytes = bench_fileSize (wigFile);
+  arrayDestroy (wigs);
+}
+
+static void bench_performSegmentation (BenchResult *result)
+{
+  Texta targetNames;
+  Array wigsPerTarget;
+  Array wigs,tars;
+  char *targetName;
+  int i;
+
+  // Setup: load the fixedStep file written by the generator, one Array per target
+  targetNames = textCreate (32);
+  wigsPerTarget = arrayCreate (32,Array);
+  wigParser_init (wigFile);
+  wigs = arrayCreate (1000000,Wig);
+  while ((targetName = wigParser_nextTarget (wigs)) != NULL) {
+    textAdd (targetNames,targetName);
+    array (wigsPerTarget,arrayMax (wigsPerTarget),Array) = wigs;
+    wigs = arrayCreate (1000000,Wig);
+  }
+  arrayDestroy (wigs);
+  wigParser_deInit ();
+  tars = arrayCreate (100000,Tar);
+  bench_start ();
+  for (i = 0; i < arrayMax (wigsPerTarget); i++) {
+    wigs = arru (wigsPerTarget,i,Array);
+    performSegmentation (tars,wigs,textItem (targetNames,i),5.0,25,50);
+    result->records += arrayMax (wigs);
+    result->bytes += (long long)arrayMax (wigs) * sizeof (Wig);
+  }
+  bench_stop (result);
+}
+
+static Benchmark benchmarks[] = {
+  {"mrf_nextEntry",bench_mrfNextEntry},
+  {"mrf_nextEntry_blocksOnly",bench_mrfNextEntryBlocks},
+  {"mrf_parse",bench_mrfParse},
+  {"mrfStore_parse",bench_mrfStoreParse},
+  {"mrfStore_parsePacked",bench_mrfStoreParsePacked},
+  {"mrf_writeEntry",bench_mrfWriteEntry},
+  {"mrfPipeline_run",bench_mrfPipelineRun},
+  {"mrfDedup_nextEntry",bench_mrfDedupNextEntry},
+  {"mrfJunction_addEntry",bench_mrfJunctionAddEntry},
+  {"mrfQc_addEntry",bench_mrfQcAddEntry},
+  {"mrf_fetchById",bench_mrfFetchById},
+  {"genCigar",bench_genCigar},
+  {"mrfConvert_writeSamBatch",bench_mrfConvertWriteSam},
+  {"samParser_nextEntry",bench_samNextEntry},
+  {"samParser_nextEntry_filtered",bench_samNextEntryFiltered},
+  {"samParser_getCigar",bench_samGetCigar},
+  {"readTarsFromBedFile",bench_readTarsFromBedFile},
+  {"tarCache_attach",bench_tarCacheAttach},
+  {"wigParser_nextTarget",bench_wigNextTarget},
+  {"performSegmentation",bench_performSegmentation},
+  {NULL,NULL}
+};
+
+static void bench_generate (char *fileName, int format, GenConfig *config)
+{
+  FILE *fp;
+
+  if ((fp = fopen (fileName,"w")) == NULL) {
+    die ("Unable to create %s",fileName);
+  }
+  gen_write (fp,format,config);
+  fclose (fp);
+}
+
+// Run one benchmark in a child process so that peak RSS is per benchmark
+static void bench_run (Benchmark *benchmark, FILE *out)
+{
+  BenchResult result;
+  struct rusage usage;
+  int fd[2];
+  int status;
+  pid_t pid;
+
+  if (pipe (fd) != 0) {
+    die ("Unable to create pipe");
+  }
+  fflush (out);
+  pid = fork ();
+  if (pid < 0) {
+    die ("Unable to fork");
+  }
+  if (pid == 0) {
+    close (fd[0]);
+    memset (&result,0,sizeof (result));
+    snprintf (result.name,sizeof (result.name),"%s",benchmark->name);
+    benchmark->run (&result);
+    if (write (fd[1],&result,sizeof (result)) != sizeof (result)) {
+      _exit (1);
+    }
+    _exit (0);
+  }
+  close (fd[1]);
+  if (read (fd[0],&result,sizeof (result)) != sizeof (result)) {
+    die ("Benchmark %s failed",benchmark->name);
+  }
+  close (fd[0]);
+  if (wait4 (pid,&status,0,&usage) != pid || !WIFEXITED (status) ||
+      WEXITSTATUS (status) != 0) {
+    die ("Benchmark %s failed",benchmark->name);
+  }
+  fprintf (out,"{\"benchmark\":\"%s\",\"records\":%ld,\"bytes\":%lld,"
+           "\"seconds\":%.6f,\"records_per_s\":%.1f,\"mb_per_s\":%.2f,"
+           "\"allocations\":%lld,\"alloc_bytes\":%lld,\"peak_rss_kb\":%ld}\n",
+           result.name,result.records,result.bytes,result.seconds,
+           result.seconds > 0 ? result.records / result.seconds : 0.0,
+           result.seconds > 0 ? result.bytes / result.seconds / 1e6 : 0.0,
+           result.allocations,result.allocBytes,usage.ru_maxrss);
+}
+
+static void usage (void)
+{
+  die ("Usage: mrfBench [options]\n"
+       "  -n <int>     number of records (default 1000000)\n"
+       "  -l <int>     read length (default 76)\n"
+       "  -s <float>   fraction of spliced reads (default 0.2)\n"
+       "  -p <float>   fraction of paired-end entries (default 0.5)\n"
+       "  -c <list>    comma-separated MRF columns (default all)\n"
+       "  -r <int>     random seed (default 1)\n"
+       "  -b <name>    only run the named benchmark\n"
+       "  -d <dir>     scratch directory (default: fresh directory in $TMPDIR)\n"
+       "  -k           keep the generated inputs\n"
+       "  -o <file>    write results to file (default stdout)");
+}
+
+int main (int argc, char *argv[])
+{
+  GenConfig config;
+  Benchmark *benchmark;
+  FILE *out;
+  char *only,*dir,*tmp;
+  char dirTemplate[4096];
+  int c,keep,ran;
+
+  gen_initConfig (&config);
+  only = NULL;
+  dir = NULL;
+  keep = 0;
+  out = stdout;
+  while ((c = getopt (argc,argv,"n:l:s:p:c:r:b:d:ko:")) != -1) {
+    switch (c) {
+    case 'n':
+      config.numRecords = atol (optarg);
+      break;
+    case 'l':
+      config.readLength = atoi (optarg);
+      break;
+    case 's':
+      config.spliceRate = atof (optarg);
+      break;
+    case 'p':
+      config.pairedFraction = atof (optarg);
+      break;
+    case 'c':
+      config.columns = gen_parseColumns (optarg);
+      break;
+    case 'r':
+      config.seed = strtoul (optarg,NULL,10);
+      break;
+    case 'b':
+      only = optarg;
+      break;
+    case 'd':
+      dir = optarg;
+      break;
+    case 'k':
+      keep = 1;
+      break;
+    case 'o':
+      if ((out = fopen (optarg,"w")) == NULL) {
+        die ("Unable to create %s",optarg);
+      }
+      break;
+    default:
+      usage ();
+    }
+  }
+  if (dir == NULL) {
+    tmp = getenv ("TMPDIR");
+    snprintf (dirTemplate,sizeof (dirTemplate),"%s/mrfBench.XXXXXX",
+              tmp != NULL ? tmp : "/tmp");
+    if ((dir = mkdtemp (dirTemplate)) == NULL) {
+      die ("Unable to create scratch directory");
+    }
+  }
+  snprintf (mrfFile,sizeof (mrfFile),"%s/bench.mrf",dir);
+  snprintf (samFile,sizeof (samFile),"%s/bench.sam",dir);
+  snprintf (bedFile,sizeof (bedFile),"%s/bench.bed",dir);
+  snprintf (wigFile,sizeof (wigFile),"%s/bench.wig",dir);
+  bench_generate (mrfFile,GEN_FORMAT_MRF,&config);
+  bench_generate (samFile,GEN_FORMAT_SAM,&config);
+  bench_generate (bedFile,GEN_FORMAT_BED,&config);
+  bench_generate (wigFile,GEN_FORMAT_WIG,&config);
+  ran = 0;
+  for (benchmark = benchmarks; benchmark->name != NULL; benchmark++) {
+    if (only == NULL || strEqual (only,benchmark->name)) {
+      bench_run (benchmark,out);
+      ran++;
+    }
+  }
+  if (!keep) {
+    unlink (mrfFile);
+    unlink (samFile);
+    unlink (bedFile);
+    unlink (wigFile);
+    if (dir == dirTemplate) {
+      rmdir (dir);
+    }
+  }
+  if (out != stdout) {
+    fclose (out);
+  }
+  if (ran == 0) {
+    die ("Unknown benchmark: %s",only);
+  }
+  return 0;
+}
@@ -0,0 +1,68 @@
+/// @file mrfGen.c
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Command line front end of the synthetic data generator.
+
+#define _GNU_SOURCE
+
+#include <unistd.h>
+
+#include <bios/log.h>
+#include <bios/format.h>
+
+#include "generator.h"
+
+static void usage (void)
+{
+  die ("Usage: mrfGen [options] <mrf|sam|bed|wig|bedgraph>\n"
+       "  -n <int>     number of records (default 1000000)\n"
+       "  -l <int>     read length (default 76)\n"
+       "  -s <float>   fraction of spliced reads (default 0.2)\n"
+       "  -p <float>   fraction of paired-end entries (default 0.5)\n"
+       "  -c <list>    comma-separated MRF columns (default all)\n"
+       "  -t <int>     number of targets (default 24)\n"
+       "  -r <int>     random seed (default 1)");
+}
+
+int main (int argc, char *argv[])
+{
+  GenConfig config;
+  int c;
+
+  gen_initConfig (&config);
+  while ((c = getopt (argc,argv,"n:l:s:p:c:t:r:")) != -1) {
+    switch (c) {
+    case 'n':
+      config.numRecords = atol (optarg);
+      break;
+    case 'l':
+      config.readLength = atoi (optarg);
+      break;
+    case 's':
+      config.spliceRate = atof (optarg);
+      break;
+    case 'p':
+      config.pairedFraction = atof (optarg);
+      break;
+    case 'c':
+      config.columns = gen_parseColumns (optarg);
+      break;
+    case 't':
+      config.numTargets = atoi (optarg);
+      break;
+    case 'r':
+      config.seed = strtoul (optarg,NULL,10);
+      break;
+    default:
+      usage ();
+    }
+  }
+  if (optind != argc - 1) {
+    usage ();
+  }
+  gen_write (stdout,gen_parseFormat (argv[optind]),&config);
+  return 0;
+}
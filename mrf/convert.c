@@ -0,0 +1,453 @@
+/// @file convert.c
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Conversion between MRF entries and SAM records without intermediate
+/// allocations.
+
+#define _GNU_SOURCE
+
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+
+#include <bios/log.h>
+#include <bios/format.h>
+#include <bios/common.h>
+
+#include "convert.h"
+#include "tokenizer.h"
+
+#define CONVERT_MAPQ_UNAVAILABLE 255
+#define CONVERT_CHUNK_SIZE (1 << 20)
+
+// Bounded output with snprintf semantics
+typedef struct {
+  char *buffer;
+  int size;
+  int length;
+} ConvertOutput;
+
+typedef struct {
+  MrfEntry **entries;
+  int numEntries;
+  char *buffer;
+  long length;
+  long capacity;
+} ConvertChunk;
+
+static void convert_append (ConvertOutput *out, const char *s, int n)
+{
+  int room;
+
+  room = out->size - 1 - out->length;
+  if (room > 0) {
+    memcpy (out->buffer + out->length,s,n < room ? n : room);
+  }
+  out->length += n;
+}
+
+static void convert_appendChar (ConvertOutput *out, char c)
+{
+  if (out->length < out->size - 1) {
+    out->buffer[out->length] = c;
+  }
+  out->length++;
+}
+
+static void convert_appendString (ConvertOutput *out, const char *s)
+{
+  convert_append (out,s,strlen (s));
+}
+
+static void convert_appendInt (ConvertOutput *out, int value)
+{
+  char digits[12];
+  unsigned int magnitude;
+  int pos;
+
+  pos = sizeof (digits);
+  magnitude = value < 0 ? 0u - (unsigned int)value : (unsigned int)value;
+  do {
+    digits[--pos] = (char)('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude != 0);
+  if (value < 0) {
+    digits[--pos] = '-';
+  }
+  convert_append (out,digits + pos,sizeof (digits) - pos);
+}
+
+static void convert_appendOperation (ConvertOutput *out, int length, char operation)
+{
+  convert_appendInt (out,length);
+  convert_appendChar (out,operation);
+}
+
+static int convert_finish (ConvertOutput *out)
+{
+  if (out->size > 0) {
+    out->buffer[out->length < out->size ? out->length : out->size - 1] = '\0';
+  }
+  return out->length;
+}
+
+static void convert_cigar (ConvertOutput *out, MrfRead *currRead)
+{
+  MrfBlock *currBlock,*prevBlock;
+  int i,gap,readLength;
+
+  prevBlock = NULL;
+  for (i = 0; i < arrayMax (currRead->blocks); i++) {
+    currBlock = arrp (currRead->blocks,i,MrfBlock);
+    if (prevBlock == NULL) {
+      if (currBlock->queryStart > 1) {
+        convert_appendOperation (out,currBlock->queryStart - 1,'S');
+      }
+    }
+    else {
+      gap = currBlock->queryStart - prevBlock->queryEnd - 1;
+      if (gap > 0) {
+        convert_appendOperation (out,gap,'I');
+      }
+      gap = currBlock->targetStart - prevBlock->targetEnd - 1;
+      if (gap > 0) {
+        convert_appendOperation (out,gap,'N');
+      }
+    }
+    convert_appendOperation (out,currBlock->queryEnd - currBlock->queryStart + 1,'M');
+    prevBlock = currBlock;
+  }
+  if (prevBlock != NULL && currRead->sequence != NULL) {
+    readLength = strlen (currRead->sequence);
+    if (readLength > prevBlock->queryEnd) {
+      convert_appendOperation (out,readLength - prevBlock->queryEnd,'S');
+    }
+  }
+}
+
+// Mates on one target form a proper pair if they face each other: opposite
+// strands and the forward mate not starting after the end of the reverse one
+static int convert_isProperPair (MrfRead *currRead, MrfRead *mateRead)
+{
+  MrfBlock *first,*mateFirst,*forward;
+  MrfRead *reverse;
+
+  first = arrp (currRead->blocks,0,MrfBlock);
+  mateFirst = arrp (mateRead->blocks,0,MrfBlock);
+  if (first->strand == mateFirst->strand) {
+    return 0;
+  }
+  forward = first->strand == '+' ? first : mateFirst;
+  reverse = first->strand == '+' ? mateRead : currRead;
+  return forward->targetStart <=
+    arrp (reverse->blocks,arrayMax (reverse->blocks) - 1,MrfBlock)->targetEnd;
+}
+
+static void convert_samLine (ConvertOutput *out, MrfEntry *currEntry, int mate)
+{
+  MrfRead *currRead,*mateRead;
+  MrfBlock *first,*mateFirst,*mateLast,*last;
+  int flags,sameTarget,tlen,left,right;
+
+  currRead = mate == R_FIRST ? &currEntry->read1 : &currEntry->read2;
+  mateRead = mate == R_FIRST ? &currEntry->read2 : &currEntry->read1;
+  first = arrp (currRead->blocks,0,MrfBlock);
+  last = arrp (currRead->blocks,arrayMax (currRead->blocks) - 1,MrfBlock);
+  flags = first->strand == '-' ? S_QUERY_STRAND : 0;
+  mateFirst = NULL;
+  sameTarget = 0;
+  tlen = 0;
+  if (currEntry->isPairedEnd == 1) {
+    mateFirst = arrp (mateRead->blocks,0,MrfBlock);
+    mateLast = arrp (mateRead->blocks,arrayMax (mateRead->blocks) - 1,MrfBlock);
+    flags |= S_READ_PAIRED | (mate == R_FIRST ? S_FIRST : S_SECOND);
+    if (mateFirst->strand == '-') {
+      flags |= S_MATE_STRAND;
+    }
+    sameTarget = strEqual (first->targetName,mateFirst->targetName);
+    if (sameTarget) {
+      if (convert_isProperPair (currRead,mateRead)) {
+        flags |= S_PAIR_MAPPED;
+      }
+      left = first->targetStart < mateFirst->targetStart ? first->targetStart : mateFirst->targetStart;
+      right = last->targetEnd > mateLast->targetEnd ? last->targetEnd : mateLast->targetEnd;
+      tlen = right - left + 1;
+      // The leftmost mate gets the positive length; ties go to the first read
+      if (first->targetStart > mateFirst->targetStart ||
+          (first->targetStart == mateFirst->targetStart && mate == R_SECOND)) {
+        tlen = -tlen;
+      }
+    }
+  }
+  convert_appendString (out,currEntry->read1.queryId != NULL ? currEntry->read1.queryId : "*");
+  convert_appendChar (out,'\t');
+  convert_appendInt (out,flags);
+  convert_appendChar (out,'\t');
+  convert_appendString (out,first->targetName);
+  convert_appendChar (out,'\t');
+  convert_appendInt (out,first->targetStart);
+  convert_appendChar (out,'\t');
+  convert_appendInt (out,CONVERT_MAPQ_UNAVAILABLE);
+  convert_appendChar (out,'\t');
+  convert_cigar (out,currRead);
+  convert_appendChar (out,'\t');
+  if (mateFirst == NULL) {
+    convert_appendString (out,"*\t0\t0\t");
+  }
+  else {
+    convert_appendString (out,sameTarget ? "=" : mateFirst->targetName);
+    convert_appendChar (out,'\t');
+    convert_appendInt (out,mateFirst->targetStart);
+    convert_appendChar (out,'\t');
+    convert_appendInt (out,tlen);
+    convert_appendChar (out,'\t');
+  }
+  convert_appendString (out,currRead->sequence != NULL ? currRead->sequence : "*");
+  convert_appendChar (out,'\t');
+  convert_appendString (out,currRead->qualityScores != NULL ? currRead->qualityScores : "*");
+  convert_appendChar (out,'\n');
+}
+
+/**
+ * Write the CIGAR string of an MRF read.
+ * @param[in] currRead Read with at least one block
+ * @param[out] buffer Receives the NUL-terminated CIGAR string
+ * @param[in] size Size of buffer
+ * @return Length of the CIGAR string; the output was truncated if this is
+ * size or more
+ */
+int mrfConvert_writeCigar (MrfRead *currRead, char *buffer, int size)
+{
+  ConvertOutput out;
+
+  out.buffer = buffer;
+  out.size = size;
+  out.length = 0;
+  convert_cigar (&out,currRead);
+  return convert_finish (&out);
+}
+
+/**
+ * Write an MRF entry as SAM lines, one per read, each ending in a newline.
+ * @param[out] buffer Receives the NUL-terminated lines
+ * @param[in] size Size of buffer
+ * @return Length of the lines; the output was truncated if this is size or
+ * more
+ */
+int mrfConvert_writeSam (MrfEntry *currEntry, char *buffer, int size)
+{
+  ConvertOutput out;
+
+  out.buffer = buffer;
+  out.size = size;
+  out.length = 0;
+  convert_samLine (&out,currEntry,R_FIRST);
+  if (currEntry->isPairedEnd == 1) {
+    convert_samLine (&out,currEntry,R_SECOND);
+  }
+  return convert_finish (&out);
+}
+
+static void* convert_writeChunk (void *arg)
+{
+  ConvertChunk *chunk;
+  char *buffer;
+  long room;
+  int i,length;
+
+  chunk = (ConvertChunk*)arg;
+  for (i = 0; i < chunk->numEntries; i++) {
+    for (;;) {
+      room = chunk->capacity - chunk->length;
+      length = mrfConvert_writeSam (chunk->entries[i],chunk->buffer + chunk->length,
+                                    room < INT_MAX ? (int)room : INT_MAX);
+      if (length < room) {
+        chunk->length += length;
+        break;
+      }
+      chunk->capacity = 2 * (chunk->length + length + 1);
+      buffer = hlr_malloc (chunk->capacity);
+      if (buffer == NULL) {
+        die ("Unable to grow the SAM output buffer to %ld bytes",chunk->capacity);
+      }
+      memcpy (buffer,chunk->buffer,chunk->length);
+      hlr_free (chunk->buffer);
+      chunk->buffer = buffer;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Write MRF entries as SAM lines, converting on several threads.
+ * @param[in] entries Entries to convert
+ * @param[in] numEntries Number of entries
+ * @param[in] numThreads Number of threads; every thread converts a
+ * contiguous range of entries into its own buffer
+ * @param[in] out Destination; lines are written in the order of entries
+ * @return Number of bytes written
+ */
+long mrfConvert_writeSamBatch (MrfEntry **entries, int numEntries, int numThreads, FILE *out)
+{
+  ConvertChunk *chunks;
+  pthread_t *threads;
+  long numWritten;
+  int i,start;
+
+  if (numThreads < 1) {
+    numThreads = 1;
+  }
+  if (numThreads > numEntries) {
+    numThreads = numEntries > 0 ? numEntries : 1;
+  }
+  chunks = (ConvertChunk*)needMem (numThreads * sizeof (ConvertChunk));
+  threads = (pthread_t*)needMem (numThreads * sizeof (pthread_t));
+  start = 0;
+  for (i = 0; i < numThreads; i++) {
+    chunks[i].entries = entries + start;
+    chunks[i].numEntries = (int)((long)numEntries * (i + 1) / numThreads) - start;
+    start += chunks[i].numEntries;
+    chunks[i].capacity = CONVERT_CHUNK_SIZE;
+    chunks[i].length = 0;
+    chunks[i].buffer = hlr_malloc (chunks[i].capacity);
+    if (chunks[i].buffer == NULL) {
+      die ("Unable to allocate the SAM output buffer");
+    }
+  }
+  for (i = 1; i < numThreads; i++) {
+    if (pthread_create (&threads[i],NULL,convert_writeChunk,&chunks[i]) != 0) {
+      die ("Unable to create conversion thread");
+    }
+  }
+  convert_writeChunk (&chunks[0]);
+  numWritten = 0;
+  for (i = 0; i < numThreads; i++) {
+    if (i > 0) {
+      pthread_join (threads[i],NULL);
+    }
+    if (fwrite (chunks[i].buffer,1,chunks[i].length,out) != (size_t)chunks[i].length) {
+      die ("Unable to write SAM output");
+    }
+    numWritten += chunks[i].length;
+    hlr_free (chunks[i].buffer);
+  }
+  freeMem (threads);
+  freeMem (chunks);
+  return numWritten;
+}
+
+/**
+ * Convert the alignment of a SAM record into MRF blocks.
+ * @param[in] currSamEntry SAM record; a CIGAR of '*' yields no blocks
+ * @param[out] blocks Receives up to maxBlocks blocks; targetName points to
+ * currSamEntry->rname
+ * @param[in] maxBlocks Capacity of blocks; may be 0 to count the blocks
+ * @return Number of blocks of the alignment, which may exceed maxBlocks
+ */
+int mrfConvert_samToBlocks (SamEntry *currSamEntry, MrfBlock *blocks, int maxBlocks)
+{
+  MrfBlock *currBlock;
+  char *pos;
+  unsigned int value;
+  int length,targetPos,queryPos,numBlocks,isOpen;
+
+  if (strEqual (currSamEntry->cigar,"*")) {
+    return 0;
+  }
+  targetPos = currSamEntry->pos;
+  queryPos = 1;
+  numBlocks = 0;
+  isOpen = 0;
+  pos = currSamEntry->cigar;
+  while (*pos != '\0') {
+    // Every operation needs a length that fits an int
+    if (!isdigit ((unsigned char)*pos)) {
+      die ("Invalid CIGAR string: %s",currSamEntry->cigar);
+    }
+    errno = 0;
+    value = tokenizer_parseUnsigned (pos,&pos);
+    if (errno == ERANGE || value > INT_MAX) {
+      die ("Invalid CIGAR string: %s",currSamEntry->cigar);
+    }
+    length = (int)value;
+    switch (*pos) {
+    case 'M': case '=': case 'X':
+      if (!isOpen) {
+        if (numBlocks < maxBlocks) {
+          currBlock = &blocks[numBlocks];
+          currBlock->targetName = currSamEntry->rname;
+          currBlock->strand = (currSamEntry->flags & S_QUERY_STRAND) ? '-' : '+';
+          currBlock->targetStart = targetPos;
+          currBlock->queryStart = queryPos;
+        }
+        numBlocks++;
+        isOpen = 1;
+      }
+      if (numBlocks <= maxBlocks) {
+        blocks[numBlocks - 1].targetEnd = targetPos + length - 1;
+        blocks[numBlocks - 1].queryEnd = queryPos + length - 1;
+      }
+      targetPos += length;
+      queryPos += length;
+      break;
+    case 'I': case 'S':
+      queryPos += length;
+      isOpen = 0;
+      break;
+    case 'D': case 'N':
+      targetPos += length;
+      isOpen = 0;
+      break;
+    case 'H': case 'P':
+      break;
+    default:
+      die ("Invalid CIGAR string: %s",currSamEntry->cigar);
+    }
+    pos++;
+  }
+  return numBlocks;
+}
+
+/**
+ * Convert a SAM record into an MRF read.
+ * @param[in] currSamEntry SAM record
+ * @param[out] currRead Its blocks Array is created if NULL and otherwise
+ * reused; sequence, qualityScores and queryId point into currSamEntry
+ * @note Reads filled by this routine must not be passed to mrf_freeEntry().
+ */
+void mrfConvert_samToRead (SamEntry *currSamEntry, MrfRead *currRead)
+{
+  int numBlocks;
+
+  if (currRead->blocks == NULL) {
+    currRead->blocks = arrayCreate (4,MrfBlock);
+  }
+  arrayClear (currRead->blocks);
+  numBlocks = mrfConvert_samToBlocks (currSamEntry,NULL,0);
+  if (numBlocks > 0) {
+    arrayp (currRead->blocks,numBlocks - 1,MrfBlock);  // grow to numBlocks
+    mrfConvert_samToBlocks (currSamEntry,arrp (currRead->blocks,0,MrfBlock),numBlocks);
+  }
+  currRead->sequence = currSamEntry->seq;
+  currRead->qualityScores = currSamEntry->qual;
+  currRead->queryId = currSamEntry->qname;
+}
+
+/**
+ * Convert one SAM record, or the two records of a pair, into an MRF entry.
+ * @param[in] first SAM record of the first read
+ * @param[in] second SAM record of the second read; NULL if unpaired
+ * @param[out] currEntry Filled as by mrfConvert_samToRead()
+ */
+void mrfConvert_samToEntry (SamEntry *first, SamEntry *second, MrfEntry *currEntry)
+{
+  mrfConvert_samToRead (first,&currEntry->read1);
+  currEntry->isPairedEnd = second != NULL;
+  if (second != NULL) {
+    mrfConvert_samToRead (second,&currEntry->read2);
+  }
+}
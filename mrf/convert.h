@@ -0,0 +1,40 @@
+/// @file convert.h
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Conversion between MRF entries and SAM records without intermediate
+/// allocations.
+///
+/// MRF to SAM: every read becomes one SAM line. Gaps between blocks become
+/// N (target) and I (query) operations, and query positions before the
+/// first block or after the last block become soft clips. Mates get the
+/// paired, first/second and mate strand flags and the mate fields, and the
+/// proper pair flag if they lie on one target on opposite strands with the
+/// forward mate not starting after the end of the reverse mate. QNAME is
+/// the query id of the first read (or '*'), MAPQ is 255, and SEQ and QUAL
+/// are copied as stored. The writers follow snprintf(): they return the
+/// length of the complete output, and the output is truncated if the
+/// buffer is smaller.
+///
+/// SAM to MRF: alignment match operations form blocks, and any I, D, N or S
+/// operation starts a new block. Deletions therefore become target gaps.
+/// Target names and strings are not copied; they point into the SamEntry.
+
+#ifndef DEF_MRF_CONVERT_H
+#define DEF_MRF_CONVERT_H
+
+#include <stdio.h>
+
+#include "mrf.h"
+#include "sam.h"
+
+int mrfConvert_writeCigar (MrfRead *currRead, char *buffer, int size);
+int mrfConvert_writeSam (MrfEntry *currEntry, char *buffer, int size);
+long mrfConvert_writeSamBatch (MrfEntry **entries, int numEntries, int numThreads, FILE *out);
+int mrfConvert_samToBlocks (SamEntry *currSamEntry, MrfBlock *blocks, int maxBlocks);
+void mrfConvert_samToRead (SamEntry *currSamEntry, MrfRead *currRead);
+void mrfConvert_samToEntry (SamEntry *first, SamEntry *second, MrfEntry *currEntry);
+
+#endif /* DEF_MRF_CONVERT_H */
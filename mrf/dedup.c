@@ -0,0 +1,229 @@
+/// @file dedup.c
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Streaming duplicate detection for MRF entries.
+
+#include <bios/log.h>
+#include <bios/format.h>
+#include <bios/common.h>
+
+#include "dedup.h"
+#include "targetDict.h"
+
+#define DEDUP_INITIAL_SLOTS 64
+
+typedef struct {
+  int end1;
+  int target2;
+  int start2;
+  int end2;
+  char strand1;
+  char strand2;
+  char isPaired;
+  char used;
+} DedupKey;
+
+static int dedupMode = MRF_DEDUP_MARK;
+static TargetDict *targets = NULL;
+static Array slots = NULL;       // of DedupKey, size is a power of 2
+static Array usedSlots = NULL;   // of int, slots to clear at the next position
+static int currTarget = -1;
+static int currStart = 0;
+static int warnedUnsorted = 0;
+static MrfDedupStats dedupStats;
+
+static unsigned int dedup_hashKey (DedupKey *key)
+{
+  unsigned int hash;
+
+  hash = (unsigned int)key->end1 * 2654435761u;
+  hash ^= (unsigned int)key->strand1 + ((unsigned int)key->isPaired << 8);
+  if (key->isPaired) {
+    hash = (hash ^ (unsigned int)key->target2) * 2246822519u;
+    hash = (hash ^ (unsigned int)key->start2) * 3266489917u;
+    hash = (hash ^ (unsigned int)key->end2) * 668265263u;
+    hash ^= (unsigned int)key->strand2;
+  }
+  return hash ^ (hash >> 15);
+}
+
+static int dedup_equalKeys (DedupKey *a, DedupKey *b)
+{
+  return a->end1 == b->end1 && a->strand1 == b->strand1 && a->isPaired == b->isPaired &&
+    (!a->isPaired || (a->target2 == b->target2 && a->start2 == b->start2 &&
+                      a->end2 == b->end2 && a->strand2 == b->strand2));
+}
+
+static void dedup_createSlots (int size)
+{
+  int i;
+
+  slots = arrayCreate (size,DedupKey);
+  for (i = 0; i < size; i++) {
+    arrayp (slots,i,DedupKey)->used = 0;
+  }
+}
+
+// Returns the slot holding key, or the empty slot where it belongs
+static int dedup_findSlot (DedupKey *key)
+{
+  DedupKey *currKey;
+  int mask,slot;
+
+  mask = arrayMax (slots) - 1;
+  slot = dedup_hashKey (key) & mask;
+  while ((currKey = arrp (slots,slot,DedupKey))->used) {
+    if (dedup_equalKeys (currKey,key)) {
+      break;
+    }
+    slot = (slot + 1) & mask;
+  }
+  return slot;
+}
+
+static void dedup_grow (void)
+{
+  Array oldSlots;
+  DedupKey *currKey;
+  int i,slot;
+
+  oldSlots = slots;
+  dedup_createSlots (2 * arrayMax (oldSlots));
+  for (i = 0; i < arrayMax (usedSlots); i++) {
+    currKey = arrp (oldSlots,arru (usedSlots,i,int),DedupKey);
+    slot = dedup_findSlot (currKey);
+    *arrp (slots,slot,DedupKey) = *currKey;
+    arru (usedSlots,i,int) = slot;
+  }
+  arrayDestroy (oldSlots);
+}
+
+// Forget the keys of the previous start position
+static void dedup_flush (void)
+{
+  int i;
+
+  for (i = 0; i < arrayMax (usedSlots); i++) {
+    arrp (slots,arru (usedSlots,i,int),DedupKey)->used = 0;
+  }
+  arrayClear (usedSlots);
+}
+
+/**
+ * Initialize the duplicate detection.
+ * @param[in] mode MRF_DEDUP_MARK: mrfDedup_nextEntry() returns every entry
+ * and reports whether it is a duplicate; MRF_DEDUP_REMOVE: duplicates are
+ * skipped
+ * @pre The MRF module has been initialized using mrf_init().
+ */
+void mrfDedup_init (int mode)
+{
+  dedupMode = mode;
+  targets = targetDict_create ();
+  dedup_createSlots (DEDUP_INITIAL_SLOTS);
+  usedSlots = arrayCreate (DEDUP_INITIAL_SLOTS,int);
+  currTarget = -1;
+  currStart = 0;
+  warnedUnsorted = 0;
+  memset (&dedupStats,0,sizeof (MrfDedupStats));
+}
+
+/**
+ * Deinitialize the duplicate detection.
+ */
+void mrfDedup_deInit (void)
+{
+  targetDict_destroy (targets);
+  targets = NULL;
+  arrayDestroy (slots);
+  arrayDestroy (usedSlots);
+}
+
+/**
+ * Check whether an entry duplicates an earlier one and remember its key.
+ * @pre Entries are passed in order of the target and start of the first
+ * read, as written by sorted MRF tools.
+ */
+int mrfDedup_isDuplicate (MrfEntry *currEntry)
+{
+  MrfBlock *first,*last;
+  DedupKey key;
+  int targetId,slot,isDuplicate;
+
+  first = arrp (currEntry->read1.blocks,0,MrfBlock);
+  last = arrp (currEntry->read1.blocks,arrayMax (currEntry->read1.blocks) - 1,MrfBlock);
+  targetId = targetDict_getId (targets,first->targetName);
+  if (targetId != currTarget || first->targetStart != currStart) {
+    if (targetId == currTarget && first->targetStart < currStart && !warnedUnsorted) {
+      warn ("MRF input is not sorted by position; duplicates may be missed");
+      warnedUnsorted = 1;
+    }
+    dedup_flush ();
+    currTarget = targetId;
+    currStart = first->targetStart;
+  }
+  memset (&key,0,sizeof (DedupKey));
+  key.end1 = last->targetEnd;
+  key.strand1 = first->strand;
+  key.isPaired = currEntry->isPairedEnd == 1;
+  if (key.isPaired) {
+    first = arrp (currEntry->read2.blocks,0,MrfBlock);
+    last = arrp (currEntry->read2.blocks,arrayMax (currEntry->read2.blocks) - 1,MrfBlock);
+    key.target2 = targetDict_getId (targets,first->targetName);
+    key.start2 = first->targetStart;
+    key.end2 = last->targetEnd;
+    key.strand2 = first->strand;
+  }
+  slot = dedup_findSlot (&key);
+  isDuplicate = arrp (slots,slot,DedupKey)->used;
+  if (!isDuplicate) {
+    key.used = 1;
+    *arrp (slots,slot,DedupKey) = key;
+    array (usedSlots,arrayMax (usedSlots),int) = slot;
+    if (2 * arrayMax (usedSlots) > arrayMax (slots)) {
+      dedup_grow ();
+    }
+  }
+  dedupStats.entries++;
+  dedupStats.duplicates += isDuplicate;
+  dedupStats.pairedEntries += key.isPaired;
+  dedupStats.pairedDuplicates += key.isPaired && isDuplicate;
+  return isDuplicate;
+}
+
+/**
+ * Returns the next entry of the MRF reader, skipping duplicates in
+ * MRF_DEDUP_REMOVE mode.
+ * @param[out] isDuplicate If not NULL, receives 1 for a duplicate entry
+ * @note The memory belongs to the MRF reader, as for mrf_nextEntry().
+ */
+MrfEntry* mrfDedup_nextEntry (int *isDuplicate)
+{
+  MrfEntry *currEntry;
+  int duplicate;
+
+  while (currEntry = mrf_nextEntry ()) {
+    duplicate = mrfDedup_isDuplicate (currEntry);
+    if (duplicate && dedupMode == MRF_DEDUP_REMOVE) {
+      continue;
+    }
+    if (isDuplicate != NULL) {
+      *isDuplicate = duplicate;
+    }
+    return currEntry;
+  }
+  return NULL;
+}
+
+/**
+ * Copy the counts of the entries checked so far.
+ */
+void mrfDedup_getStats (MrfDedupStats *stats)
+{
+  *stats = dedupStats;
+  stats->duplicateRate = dedupStats.entries > 0 ?
+    (double)dedupStats.duplicates / dedupStats.entries : 0.0;
+}
@@ -0,0 +1,42 @@
+/// @file dedup.h
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Streaming duplicate detection for MRF entries.
+///
+/// Two entries are duplicates if their first reads start at the same
+/// position of the same target and agree in strand and in the end of the
+/// last block, and, for paired-end entries, their second reads agree in
+/// target, strand, start and end. The first entry of a set of duplicates is
+/// kept. Keys are held in an open addressing table that is cleared whenever
+/// the start of the first read changes, so the input must be sorted by the
+/// target and start of the first read; memory then depends only on the
+/// number of entries sharing one start position.
+
+#ifndef DEF_MRF_DEDUP_H
+#define DEF_MRF_DEDUP_H
+
+#include "mrf.h"
+
+#define MRF_DEDUP_MARK 0
+#define MRF_DEDUP_REMOVE 1
+
+/// @struct MrfDedupStats
+/// @brief Counts of the entries seen so far.
+typedef struct {
+  long entries;
+  long duplicates;
+  long pairedEntries;
+  long pairedDuplicates;
+  double duplicateRate;   // duplicates / entries
+} MrfDedupStats;
+
+void mrfDedup_init (int mode);
+void mrfDedup_deInit (void);
+int mrfDedup_isDuplicate (MrfEntry *currEntry);
+MrfEntry* mrfDedup_nextEntry (int *isDuplicate);
+void mrfDedup_getStats (MrfDedupStats *stats);
+
+#endif /* DEF_MRF_DEDUP_H */
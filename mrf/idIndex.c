@@ -0,0 +1,533 @@
+/// @file idIndex.c
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// On-disk index from read ID to the MRF entry that holds the read.
+///
+/// An index file holds an IdIndexHeader, 2^bucketBits + 1 bucket starts
+/// and the slots. Batch fetches sort the candidate entries by offset and
+/// read them with pread() through a window that is reused for entries that
+/// are close together.
+
+#define _GNU_SOURCE
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <bios/log.h>
+#include <bios/format.h>
+#include <bios/common.h>
+
+#include "idIndex.h"
+#include "mrf.h"
+
+#define ID_INDEX_MAGIC "MrfIdIx"
+#define ID_INDEX_VERSION 2
+#define ID_INDEX_SLOTS_PER_BUCKET 4
+#define ID_INDEX_READ_SIZE 65536
+
+typedef struct {
+  char magic[8];
+  uint32_t version;
+  uint32_t bucketBits;
+  uint64_t numSlots;
+  uint64_t fileSize;
+  int64_t fileMtime;
+  int64_t fileMtimeNsec;
+  uint64_t queryIdColumn;
+} IdIndexHeader;
+
+typedef struct {
+  long offset;
+  int id;   // index into the requested IDs
+} IdIndexCandidate;
+
+typedef struct {
+  char *fileName;
+  int fd;
+  char *data;
+  long start;     // file offset of data
+  long length;
+  long capacity;
+} IdIndexReader;
+
+// An MRF file has changed if its size or its modification time differs
+static void idIndex_checkFile (IdIndex *index, char *fileName)
+{
+  struct stat st;
+
+  if (stat (fileName,&st) != 0) {
+    die ("Unable to stat %s",fileName);
+  }
+  if ((long)st.st_size != index->fileSize || (long)st.st_mtim.tv_sec != index->fileMtime ||
+      (long)st.st_mtim.tv_nsec != index->fileMtimeNsec) {
+    die ("ID index does not match %s; rebuild it",fileName);
+  }
+}
+
+// FNV-1a followed by a 64-bit finalizer, so that the leading bits used for
+// buckets depend on every byte
+static uint64_t idIndex_hash (char *id, int length)
+{
+  uint64_t hash;
+  int i;
+
+  hash = 14695981039346656037ULL;
+  for (i = 0; i < length; i++) {
+    hash ^= (unsigned char)id[i];
+    hash *= 1099511628211ULL;
+  }
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+static uint64_t idIndex_getBucket (uint64_t hash, int bucketBits)
+{
+  return bucketBits == 0 ? 0 : hash >> (64 - bucketBits);
+}
+
+// Returns the start of a tab-delimited column and sets its length, or
+// returns NULL if the line has fewer columns
+static char* idIndex_getColumn (char *line, int column, int *length)
+{
+  char *end;
+
+  while (column-- > 0) {
+    if ((line = strchr (line,'\t')) == NULL) {
+      return NULL;
+    }
+    line++;
+  }
+  end = line;
+  while (*end != '\t' && *end != '\0' && *end != '\n') {
+    end++;
+  }
+  *length = end - line;
+  return line;
+}
+
+// Split a QueryId value into the IDs of read1 and read2; length2 is -1 for
+// single-end entries
+static void idIndex_splitMates (char *value, int length, int *length1, char **id2,
+                                int *length2)
+{
+  char *bar;
+
+  bar = memchr (value,'|',length);
+  if (bar == NULL) {
+    *length1 = length;
+    *id2 = NULL;
+    *length2 = -1;
+    return;
+  }
+  *length1 = bar - value;
+  *id2 = bar + 1;
+  *length2 = length - *length1 - 1;
+}
+
+static void idIndex_addSlot (Array slots, char *id, int length, long offset)
+{
+  IdIndexSlot *currSlot;
+
+  currSlot = arrayp (slots,arrayMax (slots),IdIndexSlot);
+  currSlot->hash = idIndex_hash (id,length);
+  currSlot->offset = offset;
+}
+
+static int idIndex_sortSlots (IdIndexSlot *a, IdIndexSlot *b)
+{
+  if (a->hash != b->hash) {
+    return a->hash < b->hash ? -1 : 1;
+  }
+  if (a->offset != b->offset) {
+    return a->offset < b->offset ? -1 : 1;
+  }
+  return 0;
+}
+
+static void idIndex_writeData (FILE *fp, void *data, size_t size, char *indexFileName)
+{
+  if (size > 0 && fwrite (data,size,1,fp) != 1) {
+    die ("Unable to write %s",indexFileName);
+  }
+}
+
+/**
+ * Index the QueryId column of an uncompressed MRF file.
+ * @param[in] mrfFileName MRF file with a QueryId column
+ * @param[in] indexFileName Index file to create, e.g. <mrfFileName>.iidx
+ */
+void idIndex_build (char *mrfFileName, char *indexFileName)
+{
+  IdIndexHeader header;
+  Array slots,buckets;
+  Texta tokens;
+  FILE *fp;
+  struct stat st;
+  char *line,*headerLine,*value,*id2;
+  size_t size;
+  ssize_t length;
+  long offset,lineOffset,i;
+  uint64_t bucket,numBuckets;
+  int column,valueLength,length1,length2,c1,c2;
+
+  if ((fp = fopen (mrfFileName,"r")) == NULL) {
+    die ("Unable to open %s",mrfFileName);
+  }
+  c1 = getc (fp);
+  c2 = getc (fp);
+  if (c1 == 0x1f && c2 == 0x8b) {
+    die ("Compressed files cannot be indexed: %s",mrfFileName);
+  }
+  rewind (fp);
+  if (fstat (fileno (fp),&st) != 0) {
+    die ("Unable to stat %s",mrfFileName);
+  }
+  slots = arrayCreate (100000,IdIndexSlot);
+  line = NULL;
+  size = 0;
+  headerLine = NULL;
+  column = -1;
+  offset = 0;
+  while ((length = getline (&line,&size,fp)) != -1) {
+    lineOffset = offset;
+    offset += length;
+    if (length > 0 && line[length - 1] == '\n') {
+      line[length - 1] = '\0';
+    }
+    // Same skip rules as mrf_nextEntry ()
+    if (headerLine == NULL) {
+      if (line[0] != '#') {
+        headerLine = hlr_strdup (line);
+        tokens = textFieldtokP (line,"\t");
+        for (i = 0; i < arrayMax (tokens); i++) {
+          if (strEqual (textItem (tokens,i),MRF_COLUMN_NAME_QUERY_ID)) {
+            column = i;
+          }
+        }
+        textDestroy (tokens);
+        if (column < 0) {
+          die ("No %s column in %s",MRF_COLUMN_NAME_QUERY_ID,mrfFileName);
+        }
+      }
+      continue;
+    }
+    if (line[0] == '\0' || line[0] == '#' || strEqual (line,headerLine)) {
+      continue;
+    }
+    if ((value = idIndex_getColumn (line,column,&valueLength)) == NULL) {
+      die ("Missing %s in MRF entry: %s",MRF_COLUMN_NAME_QUERY_ID,line);
+    }
+    idIndex_splitMates (value,valueLength,&length1,&id2,&length2);
+    idIndex_addSlot (slots,value,length1,lineOffset);
+    if (id2 != NULL && (length2 != length1 || memcmp (value,id2,length1) != 0)) {
+      idIndex_addSlot (slots,id2,length2,lineOffset);
+    }
+  }
+  fclose (fp);
+  free (line);
+  hlr_free (headerLine);
+  arraySort (slots,(ARRAYORDERF)idIndex_sortSlots);
+
+  memset (&header,0,sizeof (header));
+  memcpy (header.magic,ID_INDEX_MAGIC,sizeof (ID_INDEX_MAGIC));
+  header.version = ID_INDEX_VERSION;
+  while ((1L << header.bucketBits) * ID_INDEX_SLOTS_PER_BUCKET < arrayMax (slots)) {
+    header.bucketBits++;
+  }
+  header.numSlots = arrayMax (slots);
+  header.fileSize = offset;
+  header.fileMtime = st.st_mtim.tv_sec;
+  header.fileMtimeNsec = st.st_mtim.tv_nsec;
+  header.queryIdColumn = column;
+  numBuckets = 1UL << header.bucketBits;
+  buckets = arrayCreate (numBuckets + 1,uint64_t);
+  i = 0;
+  for (bucket = 0; bucket <= numBuckets; bucket++) {
+    while (i < arrayMax (slots) &&
+           idIndex_getBucket (arru (slots,i,IdIndexSlot).hash,header.bucketBits) < bucket) {
+      i++;
+    }
+    array (buckets,arrayMax (buckets),uint64_t) = i;
+  }
+  if ((fp = fopen (indexFileName,"w")) == NULL) {
+    die ("Unable to create %s",indexFileName);
+  }
+  idIndex_writeData (fp,&header,sizeof (header),indexFileName);
+  idIndex_writeData (fp,arrp (buckets,0,uint64_t),arrayMax (buckets) * sizeof (uint64_t),
+                     indexFileName);
+  if (arrayMax (slots) > 0) {
+    idIndex_writeData (fp,arrp (slots,0,IdIndexSlot),arrayMax (slots) * sizeof (IdIndexSlot),
+                       indexFileName);
+  }
+  if (fclose (fp) != 0) {
+    die ("Unable to write %s",indexFileName);
+  }
+  arrayDestroy (buckets);
+  arrayDestroy (slots);
+}
+
+/**
+ * Map an index written by idIndex_build().
+ * @post Use idIndex_close to release the mapping
+ */
+IdIndex* idIndex_open (char *indexFileName)
+{
+  IdIndex *index;
+  IdIndexHeader *header;
+  struct stat st;
+  char *data;
+  uint64_t numBuckets;
+  int fd;
+
+  if ((fd = open (indexFileName,O_RDONLY)) < 0) {
+    die ("Unable to open %s",indexFileName);
+  }
+  if (fstat (fd,&st) != 0) {
+    die ("Unable to stat %s",indexFileName);
+  }
+  if ((size_t)st.st_size < sizeof (IdIndexHeader)) {
+    die ("Invalid ID index: %s",indexFileName);
+  }
+  data = mmap (NULL,st.st_size,PROT_READ,MAP_SHARED,fd,0);
+  if (data == MAP_FAILED) {
+    die ("Unable to map %s",indexFileName);
+  }
+  close (fd);
+  // Lookups touch a few pages each
+  madvise (data,st.st_size,MADV_RANDOM);
+  header = (IdIndexHeader*)data;
+  numBuckets = header->bucketBits < 64 ? 1UL << header->bucketBits : 0;
+  if (memcmp (header->magic,ID_INDEX_MAGIC,sizeof (ID_INDEX_MAGIC)) != 0 ||
+      header->version != ID_INDEX_VERSION || numBuckets == 0 ||
+      (uint64_t)st.st_size != sizeof (IdIndexHeader) + (numBuckets + 1) * sizeof (uint64_t) +
+      header->numSlots * sizeof (IdIndexSlot)) {
+    die ("Invalid ID index: %s",indexFileName);
+  }
+  AllocVar (index);
+  index->data = data;
+  index->length = st.st_size;
+  index->numSlots = header->numSlots;
+  index->bucketBits = header->bucketBits;
+  index->queryIdColumn = header->queryIdColumn;
+  index->fileSize = header->fileSize;
+  index->fileMtime = header->fileMtime;
+  index->fileMtimeNsec = header->fileMtimeNsec;
+  index->buckets = (uint64_t*)(data + sizeof (IdIndexHeader));
+  index->slots = (IdIndexSlot*)(index->buckets + numBuckets + 1);
+  return index;
+}
+
+/**
+ * Unmap an index.
+ */
+void idIndex_close (IdIndex *index)
+{
+  if (index == NULL) {
+    return;
+  }
+  munmap (index->data,index->length);
+  freeMem (index);
+}
+
+// Set first to the first slot with a hash and last to the slot after the
+// last one
+static void idIndex_findHash (IdIndex *index, uint64_t hash, long *first, long *last)
+{
+  uint64_t bucket;
+  long low,high,mid;
+
+  bucket = idIndex_getBucket (hash,index->bucketBits);
+  low = index->buckets[bucket];
+  high = index->buckets[bucket + 1];
+  while (low < high) {
+    mid = low + (high - low) / 2;
+    if (index->slots[mid].hash < hash) {
+      low = mid + 1;
+    }
+    else {
+      high = mid;
+    }
+  }
+  *first = low;
+  while (low < (long)index->buckets[bucket + 1] && index->slots[low].hash == hash) {
+    low++;
+  }
+  *last = low;
+}
+
+/**
+ * Returns the offsets of the entries that may hold an ID.
+ * @return Array of long in increasing order; entries whose ID only has
+ * the same hash are included, mrf_fetchById() excludes them
+ * @post Use arrayDestroy to de-allocate the memory
+ */
+Array idIndex_lookup (IdIndex *index, char *id)
+{
+  Array offsets;
+  long first,last;
+
+  offsets = arrayCreate (2,long);
+  idIndex_findHash (index,idIndex_hash (id,strlen (id)),&first,&last);
+  while (first < last) {
+    array (offsets,arrayMax (offsets),long) = index->slots[first++].offset;
+  }
+  return offsets;
+}
+
+static int idIndex_sortCandidates (IdIndexCandidate *a, IdIndexCandidate *b)
+{
+  if (a->offset != b->offset) {
+    return a->offset < b->offset ? -1 : 1;
+  }
+  return a->id - b->id;
+}
+
+static void idIndex_growReader (IdIndexReader *reader)
+{
+  char *data;
+
+  reader->capacity = reader->capacity == 0 ? ID_INDEX_READ_SIZE : 2 * reader->capacity;
+  data = hlr_malloc (reader->capacity);
+  if (data == NULL) {
+    die ("Unable to grow the read buffer to %ld bytes",reader->capacity);
+  }
+  if (reader->length > 0) {
+    memcpy (data,reader->data,reader->length);
+  }
+  hlr_free (reader->data);
+  reader->data = data;
+}
+
+// Returns the line at offset with its newline replaced by '\0'; the window
+// is refilled from offset unless it already holds the whole line
+static char* idIndex_readLine (IdIndexReader *reader, long offset)
+{
+  char *line,*end;
+  ssize_t n;
+
+  if (offset >= reader->start && offset < reader->start + reader->length) {
+    line = reader->data + (offset - reader->start);
+    end = memchr (line,'\n',reader->start + reader->length - offset);
+    if (end != NULL) {
+      *end = '\0';
+      return line;
+    }
+  }
+  reader->start = offset;
+  reader->length = 0;
+  for (;;) {
+    if (reader->length == reader->capacity) {
+      idIndex_growReader (reader);
+    }
+    n = pread (reader->fd,reader->data + reader->length,reader->capacity - reader->length,
+               offset + reader->length);
+    if (n < 0) {
+      die ("Unable to read %s",reader->fileName);
+    }
+    if (n == 0) {
+      if (reader->length == 0) {
+        die ("Unexpected end of %s",reader->fileName);
+      }
+      // Last line without a newline
+      if (reader->length == reader->capacity) {
+        idIndex_growReader (reader);
+      }
+      reader->data[reader->length] = '\0';
+      return reader->data;
+    }
+    end = memchr (reader->data + reader->length,'\n',n);
+    reader->length += n;
+    if (end != NULL) {
+      *end = '\0';
+      return reader->data;
+    }
+  }
+}
+
+// Check whether either ID of an entry line is id
+static int idIndex_hasId (IdIndex *index, char *line, char *id)
+{
+  char *value,*id2;
+  int valueLength,length,length1,length2;
+
+  if ((value = idIndex_getColumn (line,index->queryIdColumn,&valueLength)) == NULL) {
+    return 0;
+  }
+  idIndex_splitMates (value,valueLength,&length1,&id2,&length2);
+  length = strlen (id);
+  return (length == length1 && memcmp (value,id,length) == 0) ||
+    (length == length2 && memcmp (id2,id,length) == 0);
+}
+
+/**
+ * Fetch the entries that hold any of a batch of read IDs. The entries are
+ * read in file order, so a batch costs at most one read per entry.
+ * @param[in] index Index of mrfFileName
+ * @param[in] mrfFileName Indexed MRF file
+ * @param[in] ids Read IDs; IDs that are not found are skipped
+ * @return Array of MrfEntry* in file order, one per entry
+ * @pre The MRF module has been initialized with mrfFileName, e.g. using
+ * mrf_initWithColumns(); entries are parsed with mrf_parseLine().
+ * @post Release the entries with mrf_freeEntry() and the Array with
+ * arrayDestroy
+ */
+Array mrf_fetchById (IdIndex *index, char *mrfFileName, Texta ids)
+{
+  Array candidates,entries;
+  IdIndexCandidate *currCandidate;
+  IdIndexReader reader;
+  char *line,*id;
+  long first,last;
+  int i,j,found;
+
+  idIndex_checkFile (index,mrfFileName);
+  candidates = arrayCreate (arrayMax (ids),IdIndexCandidate);
+  for (i = 0; i < arrayMax (ids); i++) {
+    id = textItem (ids,i);
+    idIndex_findHash (index,idIndex_hash (id,strlen (id)),&first,&last);
+    while (first < last) {
+      currCandidate = arrayp (candidates,arrayMax (candidates),IdIndexCandidate);
+      currCandidate->offset = index->slots[first++].offset;
+      currCandidate->id = i;
+    }
+  }
+  arraySort (candidates,(ARRAYORDERF)idIndex_sortCandidates);
+  memset (&reader,0,sizeof (reader));
+  reader.fileName = mrfFileName;
+  if ((reader.fd = open (mrfFileName,O_RDONLY)) < 0) {
+    die ("Unable to open %s",mrfFileName);
+  }
+  posix_fadvise (reader.fd,0,0,POSIX_FADV_RANDOM);
+  entries = arrayCreate (arrayMax (candidates),MrfEntry*);
+  i = 0;
+  while (i < arrayMax (candidates)) {
+    currCandidate = arrp (candidates,i,IdIndexCandidate);
+    line = idIndex_readLine (&reader,currCandidate->offset);
+    found = 0;
+    for (j = i; j < arrayMax (candidates) &&
+           arrp (candidates,j,IdIndexCandidate)->offset == currCandidate->offset; j++) {
+      if (!found) {
+        found = idIndex_hasId (index,line,textItem (ids,arrp (candidates,j,IdIndexCandidate)->id));
+      }
+    }
+    if (found) {
+      array (entries,arrayMax (entries),MrfEntry*) = mrf_parseLine (line);
+    }
+    i = j;
+  }
+  close (reader.fd);
+  hlr_free (reader.data);
+  arrayDestroy (candidates);
+  return entries;
+}
@@ -0,0 +1,54 @@
+/// @file idIndex.h
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// On-disk index from read ID to the MRF entry that holds the read.
+///
+/// The index is a sorted-hash table: one slot per distinct ID of an entry,
+/// holding a 64-bit hash of the ID and the offset of the entry line, sorted
+/// by hash, with a directory of bucket starts keyed by the leading bits of
+/// the hash. Index files, e.g. <file>.iidx, are memory-mapped; a lookup
+/// touches one directory entry and a few slots. Both IDs of a paired-end
+/// entry are indexed. Hash collisions are resolved by comparing the
+/// QueryId column of the entry line. Index files use the native byte order.
+/// Only uncompressed files can be indexed, and fetching from a file whose
+/// size or modification time has changed since indexing is an error.
+
+#ifndef DEF_ID_INDEX_H
+#define DEF_ID_INDEX_H
+
+#include <stdint.h>
+
+#include <bios/format.h>
+
+/// @struct IdIndexSlot
+/// @brief An indexed ID.
+typedef struct {
+  uint64_t hash;
+  uint64_t offset;   // of the entry line
+} IdIndexSlot;
+
+/// @struct IdIndex
+/// @brief A mapped index file.
+typedef struct {
+  char *data;            // mapped file
+  long length;
+  long numSlots;
+  int bucketBits;
+  int queryIdColumn;     // 0-based column of QueryId in the MRF file
+  long fileSize;         // size and modification time of the MRF file
+  long fileMtime;        // detect a changed file
+  long fileMtimeNsec;
+  uint64_t *buckets;     // slots of bucket b start at buckets[b]
+  IdIndexSlot *slots;    // sorted by hash, then offset
+} IdIndex;
+
+void idIndex_build (char *mrfFileName, char *indexFileName);
+IdIndex* idIndex_open (char *indexFileName);
+void idIndex_close (IdIndex *index);
+Array idIndex_lookup (IdIndex *index, char *id);
+Array mrf_fetchById (IdIndex *index, char *mrfFileName, Texta ids);
+
+#endif /* DEF_ID_INDEX_H */
@@ -0,0 +1,330 @@
+/// @file junction.c
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Splice junction counting over MRF blocks. mrfJunction_count() runs the
+/// read/transform pipeline with one junction table per worker thread and
+/// merges the tables when the input is exhausted.
+
+#define _GNU_SOURCE
+
+#include <pthread.h>
+
+#include <bios/log.h>
+#include <bios/format.h>
+#include <bios/common.h>
+
+#include "junction.h"
+#include "pipeline.h"
+
+#define JUNCTION_INITIAL_SLOTS 4096
+
+typedef struct {
+  int minIntronLength;
+  pthread_key_t tableKey;
+  pthread_mutex_t mutex;
+  Array tables;   // of MrfJunctionTable*, one per worker
+} JunctionCounter;
+
+static unsigned int junction_hash (int targetId, int donor, int acceptor, char strand)
+{
+  unsigned int hash;
+
+  hash = (unsigned int)targetId * 2654435761u;
+  hash = (hash ^ (unsigned int)donor) * 2246822519u;
+  hash = (hash ^ (unsigned int)acceptor) * 3266489917u;
+  hash ^= (unsigned int)(unsigned char)strand;
+  return hash ^ (hash >> 16);
+}
+
+static Array junction_createSlots (int size)
+{
+  Array slots;
+  int i;
+
+  slots = arrayCreate (size,MrfJunction);
+  for (i = 0; i < size; i++) {
+    arrayp (slots,i,MrfJunction)->count = 0;
+  }
+  return slots;
+}
+
+// Returns the slot of a junction, which is empty (count 0) if it is new
+static MrfJunction* junction_find (Array slots, int targetId, int donor, int acceptor,
+                                   char strand)
+{
+  MrfJunction *currJunction;
+  int mask,slot;
+
+  mask = arrayMax (slots) - 1;
+  slot = junction_hash (targetId,donor,acceptor,strand) & mask;
+  while ((currJunction = arrp (slots,slot,MrfJunction))->count > 0) {
+    if (currJunction->donor == donor && currJunction->acceptor == acceptor &&
+        currJunction->targetId == targetId && currJunction->strand == strand) {
+      break;
+    }
+    slot = (slot + 1) & mask;
+  }
+  return currJunction;
+}
+
+static void junction_grow (MrfJunctionTable *table)
+{
+  Array oldSlots;
+  MrfJunction *currJunction;
+  int i;
+
+  oldSlots = table->slots;
+  table->slots = junction_createSlots (2 * arrayMax (oldSlots));
+  for (i = 0; i < arrayMax (oldSlots); i++) {
+    currJunction = arrp (oldSlots,i,MrfJunction);
+    if (currJunction->count > 0) {
+      *junction_find (table->slots,currJunction->targetId,currJunction->donor,
+                      currJunction->acceptor,currJunction->strand) = *currJunction;
+    }
+  }
+  arrayDestroy (oldSlots);
+}
+
+static void junction_add (MrfJunctionTable *table, int targetId, int donor, int acceptor,
+                          char strand, int count, int minAnchor, int maxAnchor)
+{
+  MrfJunction *currJunction;
+
+  currJunction = junction_find (table->slots,targetId,donor,acceptor,strand);
+  if (currJunction->count == 0) {
+    currJunction->targetId = targetId;
+    currJunction->donor = donor;
+    currJunction->acceptor = acceptor;
+    currJunction->strand = strand;
+    currJunction->count = count;
+    currJunction->minAnchor = minAnchor;
+    currJunction->maxAnchor = maxAnchor;
+    table->numJunctions++;
+    if (2 * table->numJunctions > arrayMax (table->slots)) {
+      junction_grow (table);
+    }
+    return;
+  }
+  currJunction->count += count;
+  if (minAnchor < currJunction->minAnchor) {
+    currJunction->minAnchor = minAnchor;
+  }
+  if (maxAnchor > currJunction->maxAnchor) {
+    currJunction->maxAnchor = maxAnchor;
+  }
+}
+
+/**
+ * Create an empty junction table.
+ * @param[in] minIntronLength Shortest target gap counted as a junction
+ */
+MrfJunctionTable* mrfJunction_createTable (int minIntronLength)
+{
+  MrfJunctionTable *table;
+
+  AllocVar (table);
+  table->targets = targetDict_create ();
+  table->slots = junction_createSlots (JUNCTION_INITIAL_SLOTS);
+  table->numJunctions = 0;
+  table->minIntronLength = minIntronLength;
+  return table;
+}
+
+/**
+ * Deallocate a junction table.
+ */
+void mrfJunction_destroyTable (MrfJunctionTable *table)
+{
+  if (table == NULL) {
+    return;
+  }
+  targetDict_destroy (table->targets);
+  arrayDestroy (table->slots);
+  freeMem (table);
+}
+
+/**
+ * Count the junctions of a read.
+ */
+void mrfJunction_addRead (MrfJunctionTable *table, MrfRead *currRead)
+{
+  MrfBlock *prevBlock,*currBlock;
+  int i,anchor,length;
+
+  for (i = 1; i < arrayMax (currRead->blocks); i++) {
+    prevBlock = arrp (currRead->blocks,i - 1,MrfBlock);
+    currBlock = arrp (currRead->blocks,i,MrfBlock);
+    if (currBlock->targetStart - prevBlock->targetEnd - 1 < table->minIntronLength ||
+        currBlock->queryStart != prevBlock->queryEnd + 1 ||
+        !strEqual (currBlock->targetName,prevBlock->targetName)) {
+      continue;
+    }
+    anchor = prevBlock->queryEnd - prevBlock->queryStart + 1;
+    length = currBlock->queryEnd - currBlock->queryStart + 1;
+    if (length < anchor) {
+      anchor = length;
+    }
+    junction_add (table,targetDict_getId (table->targets,prevBlock->targetName),
+                  prevBlock->targetEnd,currBlock->targetStart,prevBlock->strand,1,anchor,anchor);
+  }
+}
+
+/**
+ * Count the junctions of both reads of an entry.
+ */
+void mrfJunction_addEntry (MrfJunctionTable *table, MrfEntry *currEntry)
+{
+  mrfJunction_addRead (table,&currEntry->read1);
+  if (currEntry->isPairedEnd == 1) {
+    mrfJunction_addRead (table,&currEntry->read2);
+  }
+}
+
+/**
+ * Add the counts of other to table; other is unchanged.
+ */
+void mrfJunction_merge (MrfJunctionTable *table, MrfJunctionTable *other)
+{
+  MrfJunction *currJunction;
+  int i;
+
+  for (i = 0; i < arrayMax (other->slots); i++) {
+    currJunction = arrp (other->slots,i,MrfJunction);
+    if (currJunction->count > 0) {
+      junction_add (table,
+                    targetDict_getId (table->targets,
+                                      targetDict_getName (other->targets,currJunction->targetId)),
+                    currJunction->donor,currJunction->acceptor,currJunction->strand,
+                    currJunction->count,currJunction->minAnchor,currJunction->maxAnchor);
+    }
+  }
+}
+
+static void junction_countBatch (MrfBatch *batch, void *userData)
+{
+  JunctionCounter *counter;
+  MrfJunctionTable *table;
+  int i;
+
+  counter = (JunctionCounter*)userData;
+  table = (MrfJunctionTable*)pthread_getspecific (counter->tableKey);
+  if (table == NULL) {
+    table = mrfJunction_createTable (counter->minIntronLength);
+    pthread_setspecific (counter->tableKey,table);
+    pthread_mutex_lock (&counter->mutex);
+    array (counter->tables,arrayMax (counter->tables),MrfJunctionTable*) = table;
+    pthread_mutex_unlock (&counter->mutex);
+  }
+  for (i = 0; i < batch->numEntries; i++) {
+    mrfJunction_addEntry (table,batch->entries[i]);
+    batch->keep[i] = 0;
+  }
+}
+
+/**
+ * Count the junctions of all remaining entries of the MRF reader.
+ * @param[in] numThreads Number of counting threads
+ * @param[in] minIntronLength Shortest target gap counted as a junction
+ * @pre The module has been initialized using mrf_init().
+ * @post Use mrfJunction_destroyTable to de-allocate the memory
+ */
+MrfJunctionTable* mrfJunction_count (int numThreads, int minIntronLength)
+{
+  JunctionCounter counter;
+  MrfPipelineConfig config;
+  MrfJunctionTable *table,*threadTable;
+  int i;
+
+  counter.minIntronLength = minIntronLength;
+  counter.tables = arrayCreate (numThreads,MrfJunctionTable*);
+  if (pthread_key_create (&counter.tableKey,NULL) != 0) {
+    die ("Unable to create thread-specific junction tables");
+  }
+  pthread_mutex_init (&counter.mutex,NULL);
+  mrfPipeline_initConfig (&config);
+  config.numWorkers = numThreads > 0 ? numThreads : 1;
+  config.numBatches = 4 * config.numWorkers;
+  mrfPipeline_run (&config,junction_countBatch,&counter,NULL);
+  table = mrfJunction_createTable (minIntronLength);
+  for (i = 0; i < arrayMax (counter.tables); i++) {
+    threadTable = arru (counter.tables,i,MrfJunctionTable*);
+    mrfJunction_merge (table,threadTable);
+    mrfJunction_destroyTable (threadTable);
+  }
+  arrayDestroy (counter.tables);
+  pthread_key_delete (counter.tableKey);
+  pthread_mutex_destroy (&counter.mutex);
+  return table;
+}
+
+static TargetDict *sortTargets = NULL;
+
+static int junction_compare (MrfJunction *a, MrfJunction *b)
+{
+  int diff;
+
+  if (a->targetId != b->targetId) {
+    diff = strcmp (targetDict_getName (sortTargets,a->targetId),
+                   targetDict_getName (sortTargets,b->targetId));
+    if (diff != 0) {
+      return diff;
+    }
+  }
+  if (a->donor != b->donor) {
+    return a->donor < b->donor ? -1 : 1;
+  }
+  if (a->acceptor != b->acceptor) {
+    return a->acceptor < b->acceptor ? -1 : 1;
+  }
+  return a->strand - b->strand;
+}
+
+/**
+ * Returns the junctions sorted by target name, donor, acceptor and strand.
+ * @post Use arrayDestroy to de-allocate the Array; targetId refers to
+ * table->targets
+ */
+Array mrfJunction_getJunctions (MrfJunctionTable *table)
+{
+  Array junctions;
+  MrfJunction *currJunction;
+  int i;
+
+  junctions = arrayCreate (table->numJunctions,MrfJunction);
+  for (i = 0; i < arrayMax (table->slots); i++) {
+    currJunction = arrp (table->slots,i,MrfJunction);
+    if (currJunction->count > 0) {
+      array (junctions,arrayMax (junctions),MrfJunction) = *currJunction;
+    }
+  }
+  sortTargets = table->targets;
+  arraySort (junctions,(ARRAYORDERF)junction_compare);
+  sortTargets = NULL;
+  return junctions;
+}
+
+/**
+ * Write the junctions as BED lines, sorted as by mrfJunction_getJunctions().
+ * Each line spans the intron (0-based start, exclusive end) and holds the
+ * read count as score, followed by the minimum and maximum anchor:
+ * target, donor, acceptor - 1, name, count, strand, minAnchor, maxAnchor.
+ */
+void mrfJunction_writeBed (MrfJunctionTable *table, FILE *out)
+{
+  Array junctions;
+  MrfJunction *currJunction;
+  int i;
+
+  junctions = mrfJunction_getJunctions (table);
+  for (i = 0; i < arrayMax (junctions); i++) {
+    currJunction = arrp (junctions,i,MrfJunction);
+    fprintf (out,"%s\t%d\t%d\tJ%d\t%d\t%c\t%d\t%d\n",
+             targetDict_getName (table->targets,currJunction->targetId),
+             currJunction->donor,currJunction->acceptor - 1,i + 1,currJunction->count,
+             currJunction->strand,currJunction->minAnchor,currJunction->maxAnchor);
+  }
+  arrayDestroy (junctions);
+}
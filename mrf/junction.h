@@ -0,0 +1,55 @@
+/// @file junction.h
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Splice junction counting over MRF blocks.
+///
+/// A junction is a target gap between consecutive blocks of a read that is
+/// at least minIntronLength long and has no query gap. It is identified by
+/// target, donor (last position of the upstream block), acceptor (first
+/// position of the downstream block) and the alignment strand. Every read
+/// spanning a junction adds one to its count, so both mates of a pair can
+/// support the same junction. The anchor of a read is the shorter of the two
+/// blocks flanking the junction; minimum and maximum anchors are recorded.
+
+#ifndef DEF_MRF_JUNCTION_H
+#define DEF_MRF_JUNCTION_H
+
+#include <stdio.h>
+
+#include "mrf.h"
+#include "targetDict.h"
+
+/// @struct MrfJunction
+/// @brief A junction and its read support.
+typedef struct {
+  int targetId;
+  int donor;
+  int acceptor;
+  char strand;
+  int count;       // 0 marks an empty hash slot
+  int minAnchor;
+  int maxAnchor;
+} MrfJunction;
+
+/// @struct MrfJunctionTable
+/// @brief Junction counts keyed by target, donor, acceptor and strand.
+typedef struct {
+  TargetDict *targets;
+  Array slots;          // of MrfJunction, open addressing
+  int numJunctions;
+  int minIntronLength;
+} MrfJunctionTable;
+
+MrfJunctionTable* mrfJunction_createTable (int minIntronLength);
+void mrfJunction_destroyTable (MrfJunctionTable *table);
+void mrfJunction_addRead (MrfJunctionTable *table, MrfRead *currRead);
+void mrfJunction_addEntry (MrfJunctionTable *table, MrfEntry *currEntry);
+void mrfJunction_merge (MrfJunctionTable *table, MrfJunctionTable *other);
+MrfJunctionTable* mrfJunction_count (int numThreads, int minIntronLength);
+Array mrfJunction_getJunctions (MrfJunctionTable *table);
+void mrfJunction_writeBed (MrfJunctionTable *table, FILE *out);
+
+#endif /* DEF_MRF_JUNCTION_H */
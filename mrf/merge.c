@@ -0,0 +1,478 @@
+/// @file merge.c
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// k-way merge of sorted MRF or SAM files. The first MRF input is read by
+/// the mrf module, which defines the columns; the other inputs are read
+/// with their own line streams and parsed with mrf_parseLine(). SAM inputs
+/// are all read with their own line streams.
+
+#include <ctype.h>
+#include <limits.h>
+
+#include <bios/log.h>
+#include <bios/format.h>
+#include <bios/linestream.h>
+#include <bios/common.h>
+
+#include "merge.h"
+#include "targetDict.h"
+
+#define MERGE_FORMAT_MRF 1
+#define MERGE_FORMAT_SAM 2
+
+typedef struct {
+  char *fileName;
+  LineStream ls;            // NULL for the first MRF input
+  MrfEntry *mrfEntry;       // Head entry of an MRF input
+  SamEntry samEntries[2];   // Head entry and entry returned last
+  int current;              // Index of the head in samEntries
+  int rank;                 // Rank of the reference of the SAM head
+} MergeInput;
+
+static int format = 0;
+static int order = MRF_MERGE_BY_POSITION;
+static Array inputs = NULL;                // of MergeInput
+static int *heap = NULL;                   // indices of the inputs with a head
+static int heapSize = 0;
+static MrfEntry *lastEntry = NULL;
+static TargetDict *references = NULL;      // @SQ names in order
+static Texta sequenceLines = NULL;         // @SQ names and lengths
+static Stringa samHeader = NULL;
+
+// Natural order of read names as used by samtools sort -n: runs of digits
+// compare by numeric value, ignoring leading zeros, everything else by
+// character; names that only differ in leading zeros are ordered by length
+static int merge_compareNames (char *nameA, char *nameB)
+{
+  unsigned char *a,*b;
+  int diff;
+
+  a = (unsigned char*)nameA;
+  b = (unsigned char*)nameB;
+  while (*a != '\0' && *b != '\0') {
+    if (!isdigit (*a) || !isdigit (*b)) {
+      if (*a != *b) {
+        return (int)*a - (int)*b;
+      }
+      a++;
+      b++;
+      continue;
+    }
+    while (*a == '0') {
+      a++;
+    }
+    while (*b == '0') {
+      b++;
+    }
+    while (isdigit (*a) && *a == *b) {
+      a++;
+      b++;
+    }
+    // The longer number is larger; of two equally long ones, the first
+    // differing digit decides
+    diff = (int)*a - (int)*b;
+    while (isdigit (*a) && isdigit (*b)) {
+      a++;
+      b++;
+    }
+    if (isdigit (*a)) {
+      return 1;
+    }
+    if (isdigit (*b)) {
+      return -1;
+    }
+    if (diff != 0) {
+      return diff;
+    }
+  }
+  if (*a == *b) {
+    diff = (int)((char*)a - nameA) - (int)((char*)b - nameB);
+    return (diff > 0) - (diff < 0);
+  }
+  return *a != '\0' ? 1 : -1;
+}
+
+static int merge_compareMrf (MrfEntry *a, MrfEntry *b)
+{
+  MrfBlock *blockA,*blockB;
+  int diff;
+
+  if (order == MRF_MERGE_BY_NAME) {
+    return merge_compareNames (a->read1.queryId,b->read1.queryId);
+  }
+  blockA = arrp (a->read1.blocks,0,MrfBlock);
+  blockB = arrp (b->read1.blocks,0,MrfBlock);
+  diff = strcmp (blockA->targetName,blockB->targetName);
+  if (diff != 0) {
+    return diff;
+  }
+  return (blockA->targetStart > blockB->targetStart) - (blockA->targetStart < blockB->targetStart);
+}
+
+static int merge_compareSam (SamEntry *a, int rankA, SamEntry *b, int rankB)
+{
+  int diff;
+
+  if (order == MRF_MERGE_BY_NAME) {
+    diff = merge_compareNames (a->qname,b->qname);
+    if (diff != 0) {
+      return diff;
+    }
+    // Then the first read of a pair before the second
+    return (a->flags & (S_FIRST | S_SECOND)) - (b->flags & (S_FIRST | S_SECOND));
+  }
+  if (rankA != rankB) {
+    return rankA < rankB ? -1 : 1;
+  }
+  if (rankA != INT_MAX && targetDict_size (references) == 0) {
+    diff = strcmp (a->rname,b->rname);
+    if (diff != 0) {
+      return diff;
+    }
+  }
+  return (a->pos > b->pos) - (a->pos < b->pos);
+}
+
+// Returns 1 if the head of input i precedes the head of input j
+static int merge_precedes (int i, int j)
+{
+  MergeInput *a,*b;
+  int diff;
+
+  a = arrp (inputs,i,MergeInput);
+  b = arrp (inputs,j,MergeInput);
+  if (format == MERGE_FORMAT_MRF) {
+    diff = merge_compareMrf (a->mrfEntry,b->mrfEntry);
+  }
+  else {
+    diff = merge_compareSam (&a->samEntries[a->current],a->rank,
+                             &b->samEntries[b->current],b->rank);
+  }
+  return diff != 0 ? diff < 0 : i < j;
+}
+
+static void merge_siftDown (int pos)
+{
+  int child,input;
+
+  input = heap[pos];
+  while ((child = 2 * pos + 1) < heapSize) {
+    if (child + 1 < heapSize && merge_precedes (heap[child + 1],heap[child])) {
+      child++;
+    }
+    if (!merge_precedes (heap[child],input)) {
+      break;
+    }
+    heap[pos] = heap[child];
+    pos = child;
+  }
+  heap[pos] = input;
+}
+
+static void merge_buildHeap (void)
+{
+  int i;
+
+  heap = needMem (arrayMax (inputs) * sizeof (int));
+  heapSize = 0;
+  for (i = 0; i < arrayMax (inputs); i++) {
+    if (format == MERGE_FORMAT_MRF ? arrp (inputs,i,MergeInput)->mrfEntry != NULL :
+        arrp (inputs,i,MergeInput)->rank >= 0) {
+      heap[heapSize++] = i;
+    }
+  }
+  for (i = heapSize / 2 - 1; i >= 0; i--) {
+    merge_siftDown (i);
+  }
+}
+
+// Restore the heap after the head of the top input has been replaced
+static void merge_updateTop (int hasHead)
+{
+  if (!hasHead) {
+    heap[0] = heap[--heapSize];
+  }
+  if (heapSize > 0) {
+    merge_siftDown (0);
+  }
+}
+
+static MrfEntry* merge_readMrf (MergeInput *currInput)
+{
+  char *line;
+
+  if (currInput->ls == NULL) {
+    return mrf_nextDetachedEntry ();
+  }
+  while (line = ls_nextLine (currInput->ls)) {
+    if (line[0] == '\0' || line[0] == '#' || strEqual (line,mrf_getHeaderLine ())) {
+      continue;
+    }
+    return mrf_parseLine (line);
+  }
+  return NULL;
+}
+
+static void merge_init (Texta fileNames, int mergeFormat, int mergeOrder)
+{
+  MergeInput *currInput;
+  int i;
+
+  if (arrayMax (fileNames) == 0) {
+    die ("No files to merge");
+  }
+  if (mergeOrder != MRF_MERGE_BY_POSITION && mergeOrder != MRF_MERGE_BY_NAME) {
+    die ("Unknown merge order: %d",mergeOrder);
+  }
+  format = mergeFormat;
+  order = mergeOrder;
+  inputs = arrayCreate (arrayMax (fileNames),MergeInput);
+  for (i = 0; i < arrayMax (fileNames); i++) {
+    currInput = arrayp (inputs,i,MergeInput);
+    memset (currInput,0,sizeof (MergeInput));
+    currInput->fileName = hlr_strdup (textItem (fileNames,i));
+  }
+}
+
+/**
+ * Initialize the merge of sorted MRF files.
+ * @param[in] fileNames Files sorted in the given order
+ * @param[in] mergeOrder MRF_MERGE_BY_POSITION or MRF_MERGE_BY_NAME
+ * @param[in] columns See mrf_initWithColumns(); MRF_MERGE_BY_NAME requires
+ * the QueryId column
+ * @note The mrf module is initialized with the first file, so
+ * mrf_writeHeader() writes the header of the merged output.
+ */
+void mrfMerge_initMrf (Texta fileNames, int mergeOrder, int columns)
+{
+  MergeInput *currInput;
+  char *line;
+  int i;
+
+  merge_init (fileNames,MERGE_FORMAT_MRF,mergeOrder);
+  mrf_initWithColumns (textItem (fileNames,0),columns);
+  if (order == MRF_MERGE_BY_NAME &&
+      (mrf_getColumns () & MRF_COLUMN_MASK (MRF_COLUMN_TYPE_QUERY_ID)) == 0) {
+    die ("Merging by name requires the %s column",MRF_COLUMN_NAME_QUERY_ID);
+  }
+  for (i = 1; i < arrayMax (inputs); i++) {
+    currInput = arrp (inputs,i,MergeInput);
+    currInput->ls = ls_createFromFile (currInput->fileName);
+    while ((line = ls_nextLine (currInput->ls)) && line[0] == '#') {
+      ;
+    }
+    if (line == NULL || !strEqual (line,mrf_getHeaderLine ())) {
+      die ("Columns of %s and %s differ",currInput->fileName,textItem (fileNames,0));
+    }
+  }
+  for (i = 0; i < arrayMax (inputs); i++) {
+    currInput = arrp (inputs,i,MergeInput);
+    currInput->mrfEntry = merge_readMrf (currInput);
+  }
+  merge_buildHeap ();
+}
+
+/**
+ * Returns the next MRF entry in merged order, or NULL at the end.
+ * @pre The module has been initialized using mrfMerge_initMrf().
+ * @note The memory belongs to this routine.
+ */
+MrfEntry* mrfMerge_nextMrfEntry (void)
+{
+  MergeInput *currInput;
+
+  mrf_freeEntry (lastEntry);
+  lastEntry = NULL;
+  if (heapSize == 0) {
+    return NULL;
+  }
+  currInput = arrp (inputs,heap[0],MergeInput);
+  lastEntry = currInput->mrfEntry;
+  currInput->mrfEntry = merge_readMrf (currInput);
+  if (currInput->mrfEntry != NULL && merge_compareMrf (currInput->mrfEntry,lastEntry) < 0) {
+    die ("%s is not sorted",currInput->fileName);
+  }
+  merge_updateTop (currInput->mrfEntry != NULL);
+  return lastEntry;
+}
+
+// Parse the next alignment into the head slot; the rank is -1 at the end
+static void merge_readSam (MergeInput *currInput)
+{
+  SamEntry *currSamEntry;
+  char *line;
+
+  while ((line = ls_nextLine (currInput->ls)) && line[0] == '@') {
+    ;
+  }
+  if (line == NULL) {
+    currInput->rank = -1;
+    return;
+  }
+  currSamEntry = &currInput->samEntries[currInput->current];
+  samParser_parseLine (line,currSamEntry);
+  if (strEqual (currSamEntry->rname,"*")) {
+    currInput->rank = INT_MAX;
+  }
+  else if (targetDict_size (references) == 0) {
+    currInput->rank = 0;
+  }
+  else if ((currInput->rank = targetDict_lookup (references,currSamEntry->rname)) < 0) {
+    die ("Reference %s of %s is not in the @SQ lines",currSamEntry->rname,currInput->fileName);
+  }
+}
+
+// Read the header of a SAM input; returns its @SQ names and lengths
+static Texta merge_readSamHeader (MergeInput *currInput, int isFirst)
+{
+  Texta sequences,tokens;
+  Stringa buffer;
+  char *line,*name,*length;
+  int i;
+
+  sequences = textCreate (100);
+  buffer = stringCreate (100);
+  while ((line = ls_nextLine (currInput->ls)) && line[0] == '@') {
+    if (isFirst) {
+      stringAppendf (samHeader,"%s\n",line);
+    }
+    if (!strStartsWithC (line,"@SQ\t")) {
+      continue;
+    }
+    name = length = "";
+    tokens = textFieldtokP (line,"\t");
+    for (i = 1; i < arrayMax (tokens); i++) {
+      if (strStartsWithC (textItem (tokens,i),"SN:")) {
+        name = textItem (tokens,i) + 3;
+      }
+      else if (strStartsWithC (textItem (tokens,i),"LN:")) {
+        length = textItem (tokens,i) + 3;
+      }
+    }
+    stringPrintf (buffer,"%s\t%s",name,length);
+    textAdd (sequences,string (buffer));
+    if (isFirst) {
+      targetDict_getId (references,name);
+    }
+    textDestroy (tokens);
+  }
+  if (line != NULL) {
+    ls_back (currInput->ls,1);
+  }
+  stringDestroy (buffer);
+  return sequences;
+}
+
+/**
+ * Initialize the merge of sorted SAM files.
+ * @param[in] fileNames Files sorted in the given order
+ * @param[in] mergeOrder MRF_MERGE_BY_POSITION or MRF_MERGE_BY_NAME
+ */
+void mrfMerge_initSam (Texta fileNames, int mergeOrder)
+{
+  MergeInput *currInput;
+  Texta sequences;
+  int i,j;
+
+  merge_init (fileNames,MERGE_FORMAT_SAM,mergeOrder);
+  references = targetDict_create ();
+  samHeader = stringCreate (1000);
+  for (i = 0; i < arrayMax (inputs); i++) {
+    currInput = arrp (inputs,i,MergeInput);
+    currInput->ls = ls_createFromFile (currInput->fileName);
+    ls_bufferSet (currInput->ls,1);
+    sequences = merge_readSamHeader (currInput,i == 0);
+    if (i == 0) {
+      sequenceLines = sequences;
+    }
+    else {
+      for (j = 0; j < arrayMax (sequences); j++) {
+        if (j >= arrayMax (sequenceLines) ||
+            !strEqual (textItem (sequences,j),textItem (sequenceLines,j))) {
+          break;
+        }
+      }
+      if (j != arrayMax (sequences) || j != arrayMax (sequenceLines)) {
+        die ("@SQ lines of %s and %s differ",currInput->fileName,textItem (fileNames,0));
+      }
+      textDestroy (sequences);
+    }
+    merge_readSam (currInput);
+  }
+  merge_buildHeap ();
+}
+
+/**
+ * Returns the next SAM entry in merged order, or NULL at the end.
+ * @pre The module has been initialized using mrfMerge_initSam().
+ * @note The memory belongs to this routine and is overwritten by the next
+ * call; use samParser_copyEntry to keep an entry.
+ */
+SamEntry* mrfMerge_nextSamEntry (void)
+{
+  MergeInput *currInput;
+  SamEntry *currSamEntry;
+  int rank;
+
+  if (heapSize == 0) {
+    return NULL;
+  }
+  currInput = arrp (inputs,heap[0],MergeInput);
+  currSamEntry = &currInput->samEntries[currInput->current];
+  rank = currInput->rank;
+  currInput->current = 1 - currInput->current;
+  merge_readSam (currInput);
+  if (currInput->rank >= 0 &&
+      merge_compareSam (&currInput->samEntries[currInput->current],currInput->rank,
+                        currSamEntry,rank) < 0) {
+    die ("%s is not sorted",currInput->fileName);
+  }
+  merge_updateTop (currInput->rank >= 0);
+  return currSamEntry;
+}
+
+/**
+ * Returns the header lines of the first SAM file, each ending in a newline.
+ * @pre The module has been initialized using mrfMerge_initSam().
+ */
+char* mrfMerge_getSamHeader (void)
+{
+  return string (samHeader);
+}
+
+/**
+ * Deinitialize the merge module.
+ */
+void mrfMerge_deInit (void)
+{
+  MergeInput *currInput;
+  int i;
+
+  mrf_freeEntry (lastEntry);
+  lastEntry = NULL;
+  for (i = 0; i < arrayMax (inputs); i++) {
+    currInput = arrp (inputs,i,MergeInput);
+    if (currInput->ls != NULL) {
+      ls_destroy (currInput->ls);
+    }
+    mrf_freeEntry (currInput->mrfEntry);
+    hlr_free (currInput->samEntries[0].data);
+    hlr_free (currInput->samEntries[1].data);
+    hlr_free (currInput->fileName);
+  }
+  if (format == MERGE_FORMAT_MRF) {
+    mrf_deInit ();
+  }
+  else {
+    targetDict_destroy (references);
+    references = NULL;
+    textDestroy (sequenceLines);
+    stringDestroy (samHeader);
+  }
+  arrayDestroy (inputs);
+  freeMem (heap);
+  heapSize = 0;
+}
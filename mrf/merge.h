@@ -0,0 +1,41 @@
+/// @file merge.h
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// k-way merge of sorted MRF or SAM files.
+///
+/// All inputs must be sorted in the same order. By position, MRF entries
+/// are ordered by target name (strcmp) and start of the first block of
+/// read1, and SAM entries by the order of the @SQ reference dictionary and
+/// POS, with unmapped entries (RNAME "*") last; SAM files without @SQ
+/// lines are ordered by RNAME. By name, entries are ordered by QueryId or
+/// QNAME in the natural order of samtools sort -n, where digit runs compare
+/// numerically (read2 < read10), and SAM entries of one name have the first
+/// read of a pair before the second. Entries that compare equal keep the
+/// order of the inputs. An input that is found out of order is an error.
+///
+/// MRF inputs must have the same column header line and SAM inputs the
+/// same @SQ names and lengths. The head entry of every input is held in a
+/// binary heap, so each entry is read, parsed and compared once.
+
+#ifndef DEF_MRF_MERGE_H
+#define DEF_MRF_MERGE_H
+
+#include <bios/format.h>
+
+#include "mrf.h"
+#include "sam.h"
+
+#define MRF_MERGE_BY_POSITION 1
+#define MRF_MERGE_BY_NAME 2
+
+void mrfMerge_initMrf (Texta fileNames, int order, int columns);
+MrfEntry* mrfMerge_nextMrfEntry (void);
+void mrfMerge_initSam (Texta fileNames, int order);
+SamEntry* mrfMerge_nextSamEntry (void);
+char* mrfMerge_getSamHeader (void);
+void mrfMerge_deInit (void);
+
+#endif /* DEF_MRF_MERGE_H */
@@ -13,6 +13,8 @@
 #include <bios/bits.h>
 
 #include "mrf.h"
+#include "tokenizer.h"
+#include "statsUtil.h"
 
 #define INIT_MODE_FROM_FILE 1
 #define INIT_MODE_FROM_PIPE 2
@@ -23,6 +25,17 @@ static Array columnTypes = NULL;
 static Texta columnHeaders = NULL;
 static Texta comments = NULL;
 static char *headerLine = NULL;
+static MrfStats mrfStats;
+static int requestedColumns = MRF_COLUMNS_ALL;
+static Array columnHandlers = NULL;
+static int lastHandledColumn = -1;
+
+typedef void (*MrfColumnHandler) (char *token, MrfEntry *currEntry);
+
+static void mrf_processBlocksColumn (char *token, MrfEntry *currEntry);
+static void mrf_processSequenceColumn (char *token, MrfEntry *currEntry);
+static void mrf_processQualityScoresColumn (char *token, MrfEntry *currEntry);
+static void mrf_processQueryIdColumn (char *token, MrfEntry *currEntry);
 
 static void mrf_addColumnType (char *type)
 {
@@ -51,16 +64,61 @@ static void mrf_addColumnType (char *type)
   }
 }
 
-static void mrf_doInit (char *arg, int initMode) 
+static int mrf_isRequested (int columnType)
+{
+  return (requestedColumns & MRF_COLUMN_MASK (columnType)) != 0;
+}
+
+static MrfColumnHandler mrf_getColumnHandler (int columnType)
+{
+  if (!mrf_isRequested (columnType)) {
+    return NULL;
+  }
+  if (columnType == MRF_COLUMN_TYPE_BLOCKS) {
+    return mrf_processBlocksColumn;
+  }
+  else if (columnType == MRF_COLUMN_TYPE_SEQUENCE) {
+    return mrf_processSequenceColumn;
+  }
+  else if (columnType == MRF_COLUMN_TYPE_QUALITY_SCORES) {
+    return mrf_processQualityScoresColumn;
+  }
+  else if (columnType == MRF_COLUMN_TYPE_QUERY_ID) {
+    return mrf_processQueryIdColumn;
+  }
+  die ("Unknown columnType: %d",columnType);
+  return NULL;
+}
+
+// One handler per input column, NULL for columns that are not requested
+static void mrf_buildColumnHandlers (void)
+{
+  MrfColumnHandler handler;
+  int i;
+
+  columnHandlers = arrayCreate (arrayMax (columnTypes),MrfColumnHandler);
+  lastHandledColumn = -1;
+  for (i = 0; i < arrayMax (columnTypes); i++) {
+    handler = mrf_getColumnHandler (arru (columnTypes,i,int));
+    array (columnHandlers,i,MrfColumnHandler) = handler;
+    if (handler != NULL) {
+      lastHandledColumn = i;
+    }
+  }
+}
+
+static void mrf_doInit (char *arg, int initMode, int columns) 
 {
   Texta tokens;
   char *line;
   int i;
 
+  requestedColumns = columns | MRF_COLUMN_MASK (MRF_COLUMN_TYPE_BLOCKS);
   columnTypes = arrayCreate (20,int);
   columnHeaders = textCreate (20);
   presentColumnTypes = bitAlloc (100);
   comments = textCreate (100);
+  mrf_resetStats ();
   if (initMode == INIT_MODE_FROM_FILE) {
     lsMrf = ls_createFromFile (arg);
   }
@@ -73,6 +131,9 @@ static void mrf_doInit (char *arg, int initMode)
   ls_bufferSet (lsMrf,1);
   while (line = ls_nextLine (lsMrf)) {
     if (line[0] == '#') {
+      STATS_ADD (mrfStats,lines,1);
+      STATS_ADD (mrfStats,commentLines,1);
+      STATS_ADD (mrfStats,bytesRead,strlen (line) + 1);
       textAdd (comments,line + 1);
     }
     else {
@@ -81,10 +142,14 @@ static void mrf_doInit (char *arg, int initMode)
     }
   }
   headerLine = hlr_strdup (ls_nextLine (lsMrf));
+  STATS_ADD (mrfStats,lines,1);
+  STATS_ADD (mrfStats,headerLines,1);
+  STATS_ADD (mrfStats,bytesRead,strlen (headerLine) + 1);
   tokens = textFieldtokP (headerLine,"\t");
   for (i = 0; i < arrayMax (tokens); i++) {
     mrf_addColumnType (textItem (tokens,i));
   }
+  mrf_buildColumnHandlers ();
 }
 
 /**
@@ -93,7 +158,22 @@ static void mrf_doInit (char *arg, int initMode)
  */
 void mrf_init (char *fileName) 
 {
-  mrf_doInit (fileName,INIT_MODE_FROM_FILE);
+  mrf_doInit (fileName,INIT_MODE_FROM_FILE,MRF_COLUMNS_ALL);
+}
+
+/**
+ * Initialize the module from a file, loading only some of the columns.
+ * Columns that are not requested are skipped without being copied and
+ * the corresponding MrfRead fields are left NULL; they are not written
+ * by mrf_writeHeader() and mrf_writeEntry() either. Entries with more
+ * columns than the header are an error only if the last column is requested.
+ * @param[in] fileName File name, use "-" to denote stdin
+ * @param[in] columns Bitwise OR of MRF_COLUMN_MASK (type) values, or 
+ * MRF_COLUMNS_ALL. AlignmentBlocks are always loaded.
+ */
+void mrf_initWithColumns (char *fileName, int columns) 
+{
+  mrf_doInit (fileName,INIT_MODE_FROM_FILE,columns);
 }
 
 /**
@@ -102,7 +182,17 @@ void mrf_init (char *fileName)
  */
 void mrf_initFromPipe (char *cmd) 
 {
-  mrf_doInit (cmd,INIT_MODE_FROM_PIPE);
+  mrf_doInit (cmd,INIT_MODE_FROM_PIPE,MRF_COLUMNS_ALL);
+}
+
+/**
+ * Initialize the module from a command, loading only some of the columns.
+ * @param[in] cmd command to be executed
+ * @param[in] columns See mrf_initWithColumns()
+ */
+void mrf_initFromPipeWithColumns (char *cmd, int columns) 
+{
+  mrf_doInit (cmd,INIT_MODE_FROM_PIPE,columns);
 }
 
 /**
@@ -122,6 +212,7 @@ void mrf_addNewColumnType (char* columnName)
   }
   if (i == arrayMax (columnHeaders)) {
     mrf_addColumnType (columnName);
+    requestedColumns |= MRF_COLUMN_MASK (arru (columnTypes,i,int));
   }
 }
 
@@ -132,6 +223,7 @@ void mrf_deInit (void)
 {
   ls_destroy (lsMrf);
   arrayDestroy (columnTypes);
+  arrayDestroy (columnHandlers);
   textDestroy (columnHeaders);
   bitFree (&presentColumnTypes);
   textDestroy (comments);
@@ -148,18 +240,25 @@ static void mrf_freeReadAttributes (MrfRead *currRead)
     hlr_free (currBlock->targetName);
   }
   arrayDestroy (currRead->blocks);
-  if (bitReadOne (presentColumnTypes,MRF_COLUMN_TYPE_SEQUENCE)) {
+  if (bitReadOne (presentColumnTypes,MRF_COLUMN_TYPE_SEQUENCE) &&
+      mrf_isRequested (MRF_COLUMN_TYPE_SEQUENCE)) {
     hlr_free (currRead->sequence);
   }
-  if (bitReadOne (presentColumnTypes,MRF_COLUMN_TYPE_QUALITY_SCORES)) {
+  if (bitReadOne (presentColumnTypes,MRF_COLUMN_TYPE_QUALITY_SCORES) &&
+      mrf_isRequested (MRF_COLUMN_TYPE_QUALITY_SCORES)) {
     hlr_free (currRead->qualityScores);
   }
-  if (bitReadOne (presentColumnTypes,MRF_COLUMN_TYPE_QUERY_ID)) {
+  if (bitReadOne (presentColumnTypes,MRF_COLUMN_TYPE_QUERY_ID) &&
+      mrf_isRequested (MRF_COLUMN_TYPE_QUERY_ID)) {
     hlr_free (currRead->queryId);
   }
 }
 
-static void mrf_freeEntry (MrfEntry* currEntry) 
+/**
+ * Free an MrfEntry returned by mrf_nextDetachedEntry().
+ * @pre The module has been initialized using mrf_init().
+ */
+void mrf_freeEntry (MrfEntry* currEntry) 
 {
   if (currEntry == NULL) {
     return;
@@ -168,117 +267,207 @@ static void mrf_freeEntry (MrfEntry* currEntry)
   if (currEntry->isPairedEnd == 1) {
     mrf_freeReadAttributes (&currEntry->read2);
   }
+  else {
+    // Only the blocks decide whether an entry is paired; a '|' in another
+    // column of a single-end entry still splits it
+    hlr_free (currEntry->read2.sequence);
+    hlr_free (currEntry->read2.qualityScores);
+    hlr_free (currEntry->read2.queryId);
+  }
   freeMem (currEntry);
 }
 
+// Cut the next field at a delimiter in place; returns the remainder or NULL
+static char* mrf_cutField (char *field, int delimiters)
+{
+  char *pos;
+
+  pos = tokenizer_find (field,delimiters);
+  if (*pos == '\0') {
+    return NULL;
+  }
+  *pos = '\0';
+  return pos + 1;
+}
+
+// Returns the start of the block field after field, which must end in a colon
+static char* mrf_nextBlockField (char *field, char *block)
+{
+  char *pos;
+
+  pos = tokenizer_find (field,TOKENIZER_COLON | TOKENIZER_COMMA);
+  if (*pos != ':') {
+    die ("Invalid MRF block: %s",block);
+  }
+  return pos + 1;
+}
+
 static void mrf_processBlocks (char *blockString, MrfRead *currRead)
 {
-  Texta blocks;
-  Texta blockFields;
+  char *block,*pos;
+  char *fields[6];
   int i;
   MrfBlock *currBlock;
 
-  blocks = textFieldtok (blockString,",");
-  for (i = 0; i < arrayMax (blocks); i++) {
+  block = blockString;
+  for (;;) {
+    fields[0] = block;
+    for (i = 1; i < 6; i++) {
+      fields[i] = mrf_nextBlockField (fields[i - 1],block);
+    }
+    fields[1][-1] = '\0';
     currBlock = arrayp (currRead->blocks,arrayMax (currRead->blocks),MrfBlock);
-    blockFields = textFieldtok (textItem (blocks,i),":");
-    currBlock->targetName = hlr_strdup (textItem (blockFields,0));
-    currBlock->strand = textItem (blockFields,1)[0];
-    currBlock->targetStart = atoi (textItem (blockFields,2));
-    currBlock->targetEnd = atoi (textItem (blockFields,3));
-    currBlock->queryStart = atoi (textItem (blockFields,4));
-    currBlock->queryEnd = atoi (textItem (blockFields,5));
-    textDestroy (blockFields);
+    currBlock->targetName = hlr_strdup (fields[0]);
+    STATS_ADD (mrfStats,bytesAllocated,strlen (currBlock->targetName) + 1);
+    currBlock->strand = fields[1][0];
+    currBlock->targetStart = tokenizer_parseInt (fields[2],NULL);
+    currBlock->targetEnd = tokenizer_parseInt (fields[3],NULL);
+    currBlock->queryStart = tokenizer_parseInt (fields[4],NULL);
+    currBlock->queryEnd = tokenizer_parseInt (fields[5],&pos);
+    pos = tokenizer_find (pos,TOKENIZER_COMMA);
+    if (*pos == '\0') {
+      break;
+    }
+    block = pos + 1;
+  }
+}
+
+// Split a paired-end column value at '|'; returns the value of the second mate
+static char* mrf_splitMates (char *token)
+{
+  return mrf_cutField (token,TOKENIZER_PIPE);
+}
+
+static void mrf_processBlocksColumn (char *token, MrfEntry *currEntry)
+{
+  char *mate;
+
+  mate = mrf_splitMates (token);
+  currEntry->read1.blocks = arrayCreate (2,MrfBlock);
+  mrf_processBlocks (token,&currEntry->read1);
+  if (mate != NULL) {
+    currEntry->isPairedEnd = 1;
+    currEntry->read2.blocks = arrayCreate (2,MrfBlock);
+    mrf_processBlocks (mate,&currEntry->read2);
+  }
+}
+
+static char* mrf_copyColumnValue (char *value)
+{
+  STATS_ADD (mrfStats,bytesAllocated,strlen (value) + 1);
+  return hlr_strdup (value);
+}
+
+static void mrf_processSequenceColumn (char *token, MrfEntry *currEntry)
+{
+  char *mate;
+
+  mate = mrf_splitMates (token);
+  currEntry->read1.sequence = mrf_copyColumnValue (token);
+  if (mate != NULL) {
+    currEntry->read2.sequence = mrf_copyColumnValue (mate);
+  }
+}
+
+static void mrf_processQualityScoresColumn (char *token, MrfEntry *currEntry)
+{
+  char *mate;
+
+  mate = mrf_splitMates (token);
+  currEntry->read1.qualityScores = mrf_copyColumnValue (token);
+  if (mate != NULL) {
+    currEntry->read2.qualityScores = mrf_copyColumnValue (mate);
   }
-  textDestroy (blocks);
+}
+
+static void mrf_processQueryIdColumn (char *token, MrfEntry *currEntry)
+{
+  char *mate;
+
+  mate = mrf_splitMates (token);
+  currEntry->read1.queryId = mrf_copyColumnValue (token);
+  if (mate != NULL) {
+    currEntry->read2.queryId = mrf_copyColumnValue (mate);
+  }
+}
+
+// Parse an entry line in place into a new entry
+static MrfEntry* mrf_processLine (char *line)
+{
+  MrfEntry *currEntry;
+  MrfColumnHandler handler;
+  char *token,*next;
+  int index,isLast;
+
+  AllocVar (currEntry);
+  STATS_ADD (mrfStats,bytesAllocated,sizeof (MrfEntry));
+  // Columns are cut in place; nothing after the last requested column is
+  // scanned, so surplus columns are only detected when the last column is
+  // requested
+  token = line;
+  for (index = 0; index <= lastHandledColumn; index++) {
+    next = tokenizer_find (token,TOKENIZER_TAB);
+    isLast = *next == '\0';
+    if (!isLast && index == arrayMax (columnHandlers) - 1) {
+      die ("Too many columns in MRF entry, starting at: %s",next + 1);
+    }
+    handler = arru (columnHandlers,index,MrfColumnHandler);
+    if (handler != NULL) {
+      *next = '\0';
+      handler (token,currEntry);
+    }
+    if (isLast) {
+      break;
+    }
+    token = next + 1;
+  }
+  STATS_ADD (mrfStats,entries,1);
+  STATS_ADD (mrfStats,pairedEntries,currEntry->isPairedEnd == 1);
+  STATS_ADD (mrfStats,singleEntries,currEntry->isPairedEnd != 1);
+  STATS_ADD (mrfStats,blocks,arrayMax (currEntry->read1.blocks) +
+             (currEntry->isPairedEnd == 1 ? arrayMax (currEntry->read2.blocks) : 0));
+  STATS_ADD (mrfStats,bytesAllocated,sizeof (MrfBlock) *
+             (arrayMax (currEntry->read1.blocks) +
+              (currEntry->isPairedEnd == 1 ? arrayMax (currEntry->read2.blocks) : 0)));
+  return currEntry;
 }
 
 static MrfEntry* mrf_processNextEntry (int freeMemory) 
 {
-  static MrfEntry *currEntry = NULL;
-  char *line,*token,*pos;
-  WordIter w;
-  int index,columnType;
+  static MrfEntry *lastEntry = NULL;
+  MrfEntry *currEntry;
+  char *line;
+  STATS_TIMER (t);
 
+  STATS_TIMER_START (t);
   while (line = ls_nextLine (lsMrf)) {
+    STATS_TIMER_STOP (mrfStats,nsRead,t);
+    STATS_ADD (mrfStats,lines,1);
+    STATS_ADD (mrfStats,bytesRead,strlen (line) + 1);
+    STATS_TIMER_START (t);
     if (line[0] == '\0' || line[0] == '#' || strEqual (line,headerLine)) {
+      STATS_ADD (mrfStats,emptyLines,line[0] == '\0');
+      STATS_ADD (mrfStats,commentLines,line[0] == '#');
+      STATS_ADD (mrfStats,headerLines,line[0] != '\0' && line[0] != '#');
       continue;
     }
     if (freeMemory) {
-      mrf_freeEntry (currEntry);
+      mrf_freeEntry (lastEntry);
+      lastEntry = NULL;
     }
-    AllocVar (currEntry);
-    if (strchr (line,'|')) {
-      currEntry->isPairedEnd = 1;
-    }
-    else {
-      currEntry->isPairedEnd = 0;
-    }
-    index = 0;
-    w = wordIterCreate (line,"\t",0);
-    while (token = wordNext (w)) {
-      columnType = arru (columnTypes,index,int);
-      if (columnType == MRF_COLUMN_TYPE_BLOCKS) {
-        if (currEntry->isPairedEnd == 1) {
-          pos = strchr (token,'|');
-          *pos = '\0';
-          currEntry->read1.blocks = arrayCreate (2,MrfBlock);
-          currEntry->read2.blocks = arrayCreate (2,MrfBlock);
-          mrf_processBlocks (token,&currEntry->read1);
-          mrf_processBlocks (pos + 1,&currEntry->read2);
-         
-        }
-        else {
-          currEntry->read1.blocks = arrayCreate (2,MrfBlock);
-          mrf_processBlocks (token,&currEntry->read1);
-        }
-      }
-      else if (columnType == MRF_COLUMN_TYPE_SEQUENCE) {
-        if (currEntry->isPairedEnd == 1) {
-          pos = strchr (token,'|');
-          *pos = '\0';
-          currEntry->read1.sequence = hlr_strdup (token);
-          currEntry->read2.sequence = hlr_strdup (pos + 1);
-        }
-        else {
-          currEntry->read1.sequence = hlr_strdup (token);
-        }
-      }
-      else if (columnType == MRF_COLUMN_TYPE_QUALITY_SCORES) {
-        if (currEntry->isPairedEnd == 1) {
-          pos = strchr (token,'|');
-          *pos = '\0';
-          currEntry->read1.qualityScores = hlr_strdup (token);
-          currEntry->read2.qualityScores = hlr_strdup (pos + 1);
-        }
-        else {
-          currEntry->read1.qualityScores = hlr_strdup (token);
-        }
-      }
-      else if (columnType == MRF_COLUMN_TYPE_QUERY_ID) {
-        if (currEntry->isPairedEnd == 1) {
-          pos = strchr (token,'|');
-          *pos = '\0';
-          currEntry->read1.queryId = hlr_strdup (token);
-          currEntry->read2.queryId = hlr_strdup (pos + 1);
-        }
-        else {
-          currEntry->read1.queryId = hlr_strdup (token);
-        }
-      }
-      else {
-        die ("Unknown columnType: %d",columnType);
-      }
-      index++;
+    currEntry = mrf_processLine (line);
+    STATS_TIMER_STOP (mrfStats,nsParse,t);
+    if (freeMemory) {
+      lastEntry = currEntry;
     }
-    wordIterDestroy (w);
     return currEntry;
   }
+  STATS_TIMER_STOP (mrfStats,nsRead,t);
   if (freeMemory) {
-    mrf_freeEntry (currEntry);
+    mrf_freeEntry (lastEntry);
+    lastEntry = NULL;
   }
-  currEntry = NULL;
-  return currEntry;
+  return NULL;
 }
 
 /**
@@ -290,6 +479,38 @@ MrfEntry* mrf_nextEntry (void)
   return mrf_processNextEntry (1); 
 }
 
+/**
+ * Returns a pointer to next MrfEntry, which is not reused by later calls.
+ * @pre The module has been initialized using mrf_init().
+ * @note The memory belongs to the caller; release it with mrf_freeEntry()
+ * before calling mrf_deInit().
+ */
+MrfEntry* mrf_nextDetachedEntry (void) 
+{
+  return mrf_processNextEntry (0); 
+}
+
+/**
+ * Parse an MRF entry line that has the columns of the file the module was
+ * initialized with, e.g. a line of another file with the same header.
+ * @param[in] line Entry line; it is modified
+ * @pre The module has been initialized using mrf_init().
+ * @note The memory belongs to the caller; release it with mrf_freeEntry().
+ */
+MrfEntry* mrf_parseLine (char *line)
+{
+  return mrf_processLine (line);
+}
+
+/**
+ * Returns the column header line of the input.
+ * @pre The module has been initialized using mrf_init().
+ */
+char* mrf_getHeaderLine (void)
+{
+  return headerLine;
+}
+
 /**
  * Returns an Array of MrfEntries.
  * @pre The module has been initialized using mrf_init().
@@ -300,13 +521,33 @@ Array mrf_parse (void)
   Array mrfEntries;
   MrfEntry *currEntry;
 
-  mrfEntries = arrayCreate (100000,MrfEntry);
+  mrfEntries = arrayCreate (1000,MrfEntry);
   while (currEntry = mrf_processNextEntry (0)) {
     array (mrfEntries,arrayMax (mrfEntries),MrfEntry) = *currEntry;
+    freeMem (currEntry);
   }
   return mrfEntries;
 }
 
+/**
+ * Returns the columns loaded by the reader as a bitwise OR of
+ * MRF_COLUMN_MASK (type) values.
+ * @pre The module has been initialized using mrf_init().
+ */
+int mrf_getColumns (void)
+{
+  int columns;
+  int i;
+
+  columns = 0;
+  for (i = 0; i < arrayMax (columnTypes); i++) {
+    if (mrf_isRequested (arru (columnTypes,i,int))) {
+      columns |= MRF_COLUMN_MASK (arru (columnTypes,i,int));
+    }
+  }
+  return columns;
+}
+
 static void mrf_addTab (Stringa buffer, int *first) 
 {
   if (*first == 1) {
@@ -340,15 +581,19 @@ int getReadLength (MrfRead *currRead)
 char* mrf_writeHeader (void)
 {
   static Stringa buffer = NULL;
+  int first;
   int i;
 
   stringCreateClear (buffer,100);
   for (i = 0; i < arrayMax (comments); i++) {
     stringAppendf (buffer,"#%s\n",textItem (comments,i));
   }
+  first = 1;
   for (i = 0; i < arrayMax (columnHeaders); i++) {
-    stringAppendf (buffer,"%s%s",textItem (columnHeaders,i), 
-		   i < arrayMax (columnHeaders) - 1 ? "\t" : "");
+    if (mrf_isRequested (arru (columnTypes,i,int))) {
+      mrf_addTab (buffer,&first);
+      stringCat (buffer,textItem (columnHeaders,i));
+    }
   }
   return string (buffer);
 }
@@ -377,12 +622,15 @@ char* mrf_writeEntry (MrfEntry *currEntry)
   int first;
   int i;
   int columnType;
+  STATS_TIMER (t);
 
+  STATS_TIMER_START (t);
   stringCreateClear (buffer,100);
   first = 1;
   for (i = 0; i < arrayMax (columnTypes); i++) {
     columnType = arru (columnTypes,i,int);
-    if (bitReadOne (presentColumnTypes,MRF_COLUMN_TYPE_BLOCKS) && columnType == MRF_COLUMN_TYPE_BLOCKS) {
+    if (columnType == MRF_COLUMN_TYPE_BLOCKS && mrf_isRequested (columnType) &&
+        bitReadOne (presentColumnTypes,MRF_COLUMN_TYPE_BLOCKS)) {
       mrf_addTab (buffer,&first);
       if (currEntry->isPairedEnd == 1) {
         mrf_writeBlocks (buffer,currEntry->read1.blocks);
@@ -393,7 +641,8 @@ char* mrf_writeEntry (MrfEntry *currEntry)
         mrf_writeBlocks (buffer,currEntry->read1.blocks);
       }
     }
-    if (bitReadOne (presentColumnTypes,MRF_COLUMN_TYPE_SEQUENCE) && columnType == MRF_COLUMN_TYPE_SEQUENCE) {
+    if (columnType == MRF_COLUMN_TYPE_SEQUENCE && mrf_isRequested (columnType) &&
+        bitReadOne (presentColumnTypes,MRF_COLUMN_TYPE_SEQUENCE)) {
       mrf_addTab (buffer,&first);
       if (currEntry->isPairedEnd == 1) {
         stringAppendf (buffer,"%s|%s",currEntry->read1.sequence,currEntry->read2.sequence);
@@ -402,7 +651,8 @@ char* mrf_writeEntry (MrfEntry *currEntry)
         stringAppendf (buffer,"%s",currEntry->read1.sequence);
       }
     }
-    if (bitReadOne (presentColumnTypes,MRF_COLUMN_TYPE_QUALITY_SCORES) && columnType == MRF_COLUMN_TYPE_QUALITY_SCORES) {
+    if (columnType == MRF_COLUMN_TYPE_QUALITY_SCORES && mrf_isRequested (columnType) &&
+        bitReadOne (presentColumnTypes,MRF_COLUMN_TYPE_QUALITY_SCORES)) {
       mrf_addTab (buffer,&first);
       if (currEntry->isPairedEnd == 1) {
         stringAppendf (buffer,"%s|%s",currEntry->read1.qualityScores,currEntry->read2.qualityScores);
@@ -411,7 +661,8 @@ char* mrf_writeEntry (MrfEntry *currEntry)
         stringAppendf (buffer,"%s",currEntry->read1.qualityScores);
       }
     }
-    if (bitReadOne (presentColumnTypes,MRF_COLUMN_TYPE_QUERY_ID) && columnType == MRF_COLUMN_TYPE_QUERY_ID) {
+    if (columnType == MRF_COLUMN_TYPE_QUERY_ID && mrf_isRequested (columnType) &&
+        bitReadOne (presentColumnTypes,MRF_COLUMN_TYPE_QUERY_ID)) {
       mrf_addTab (buffer,&first);
       if (currEntry->isPairedEnd == 1) {
         stringAppendf (buffer,"%s|%s",currEntry->read1.queryId,currEntry->read2.queryId);
@@ -421,6 +672,27 @@ char* mrf_writeEntry (MrfEntry *currEntry)
       }
     }
   }
+  STATS_ADD (mrfStats,entriesWritten,1);
+  STATS_ADD (mrfStats,bytesWritten,stringLen (buffer));
+  STATS_TIMER_STOP (mrfStats,nsWrite,t);
   return string (buffer);
 }
 
+/**
+ * Copy the instrumentation counters of the MRF reader and writer.
+ * @note All counters are zero unless libmrf was configured with --enable-stats
+ * and counting has been switched on with mrfStats_setEnabled().
+ */
+void mrf_getStats (MrfStats *stats)
+{
+  *stats = mrfStats;
+}
+
+/**
+ * Reset the instrumentation counters; mrf_init() does this implicitly.
+ */
+void mrf_resetStats (void)
+{
+  memset (&mrfStats,0,sizeof (MrfStats));
+}
+
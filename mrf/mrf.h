@@ -25,6 +25,10 @@
 #define MRF_COLUMN_NAME_QUALITY_SCORES "QualityScores"
 #define MRF_COLUMN_NAME_QUERY_ID "QueryId"
 
+// column selection for mrf_initWithColumns
+#define MRF_COLUMN_MASK(type) (1 << (type))
+#define MRF_COLUMNS_ALL (~0)
+
 /**
  * MrfBlock.
  */
@@ -58,10 +62,17 @@ typedef struct {
 
 extern void mrf_init (char* fileName);
 extern void mrf_initFromPipe (char* cmd);
+extern void mrf_initWithColumns (char* fileName, int columns);
+extern void mrf_initFromPipeWithColumns (char* cmd, int columns);
 extern void mrf_addNewColumnType (char* columnName);
 extern void mrf_deInit (void);
 extern MrfEntry* mrf_nextEntry (void);
+extern MrfEntry* mrf_nextDetachedEntry (void);
+extern void mrf_freeEntry (MrfEntry* currEntry);
+extern MrfEntry* mrf_parseLine (char* line);
+extern char* mrf_getHeaderLine (void);
 extern Array mrf_parse (void);
+extern int mrf_getColumns (void);
 extern char* mrf_writeHeader (void);
 extern char* mrf_writeEntry (MrfEntry *currEntry);
 extern int getReadLength (MrfRead *currRead);
@@ -0,0 +1,494 @@
+/// @file mrfStore.c
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Compact in-memory store of MRF entries.
+
+#include <bios/log.h>
+#include <bios/format.h>
+#include <bios/common.h>
+
+#include "mrfStore.h"
+#include "seqPack.h"
+#include "targetDict.h"
+
+// Make room for length more bytes and return where they go
+static char* mrfStore_reserve (MrfStore *store, long length)
+{
+  char *arena;
+  long capacity;
+
+  if (store->arenaSize + length > store->arenaCapacity) {
+    capacity = store->arenaCapacity;
+    while (store->arenaSize + length > store->arenaCapacity) {
+      store->arenaCapacity *= 2;
+    }
+    arena = hlr_malloc (store->arenaCapacity);
+    if (arena == NULL) {
+      die ("Unable to grow the string arena to %ld bytes",store->arenaCapacity);
+    }
+    // Bytes reserved but not yet committed are kept as well
+    memcpy (arena,store->arena,capacity);
+    hlr_free (store->arena);
+    store->arena = arena;
+  }
+  return store->arena + store->arenaSize;
+}
+
+static void mrfStore_appendString (MrfStore *store, char *s)
+{
+  long length;
+  char *dest;
+
+  length = (s != NULL ? strlen (s) : 0) + 1;
+  dest = mrfStore_reserve (store,length);
+  if (length > 1) {
+    memcpy (dest,s,length);
+  }
+  else {
+    dest[0] = '\0';
+  }
+  store->arenaSize += length;
+}
+
+static int mrfStore_readInt (char *p)
+{
+  int value;
+
+  memcpy (&value,p,sizeof (int));
+  return value;
+}
+
+// Packed sequence field: length, number of exceptions, exceptions, bases
+static void mrfStore_appendPackedSequence (MrfStore *store, char *sequence)
+{
+  int length,numExceptions;
+  int *exceptions;
+  char *dest;
+
+  length = sequence != NULL ? strlen (sequence) : 0;
+  if (length > 0) {
+    arrayp (store->exceptions,length - 1,int);
+  }
+  exceptions = arrp (store->exceptions,0,int);
+  dest = mrfStore_reserve (store,2 * sizeof (int) + seqPack_packedSize (length));
+  numExceptions = seqPack_pack (sequence,length,
+                                (unsigned char*)dest + 2 * sizeof (int),exceptions);
+  if (numExceptions > 0) {
+    // Rare: move the bases behind the exception list
+    dest = mrfStore_reserve (store,(2 + numExceptions) * sizeof (int) +
+                             seqPack_packedSize (length));
+    memmove (dest + (2 + numExceptions) * sizeof (int),dest + 2 * sizeof (int),
+             seqPack_packedSize (length));
+    memcpy (dest + 2 * sizeof (int),exceptions,numExceptions * sizeof (int));
+  }
+  memcpy (dest,&length,sizeof (int));
+  memcpy (dest + sizeof (int),&numExceptions,sizeof (int));
+  store->arenaSize += (2 + numExceptions) * sizeof (int) + seqPack_packedSize (length);
+}
+
+// Binned quality field: length, 4-bit bins
+static void mrfStore_appendBinnedQualities (MrfStore *store, char *qualityScores)
+{
+  int length;
+  char *dest;
+
+  length = qualityScores != NULL ? strlen (qualityScores) : 0;
+  dest = mrfStore_reserve (store,sizeof (int) + seqPack_binnedSize (length));
+  memcpy (dest,&length,sizeof (int));
+  seqPack_binQualities (qualityScores,length,(unsigned char*)dest + sizeof (int));
+  store->arenaSize += sizeof (int) + seqPack_binnedSize (length);
+}
+
+static int mrfStore_isPacked (MrfStore *store, int columnType)
+{
+  return (columnType == MRF_COLUMN_TYPE_SEQUENCE &&
+          (store->packing & MRF_STORE_PACK_SEQUENCES)) ||
+    (columnType == MRF_COLUMN_TYPE_QUALITY_SCORES &&
+     (store->packing & MRF_STORE_BIN_QUALITIES));
+}
+
+static long mrfStore_getFieldSize (MrfStore *store, int columnType, char *field)
+{
+  if (!mrfStore_isPacked (store,columnType)) {
+    return strlen (field) + 1;
+  }
+  if (columnType == MRF_COLUMN_TYPE_SEQUENCE) {
+    return (2 + mrfStore_readInt (field + sizeof (int))) * sizeof (int) +
+      seqPack_packedSize (mrfStore_readInt (field));
+  }
+  return sizeof (int) + seqPack_binnedSize (mrfStore_readInt (field));
+}
+
+/**
+ * Create an empty store.
+ * @param[in] columns String columns to keep, as a bitwise OR of
+ * MRF_COLUMN_MASK (type) values; the blocks are always kept
+ * @post Use mrfStore_destroy to de-allocate the memory
+ */
+MrfStore* mrfStore_create (int columns)
+{
+  return mrfStore_createPacked (columns,0);
+}
+
+/**
+ * Create an empty store that packs sequences and/or bins quality scores.
+ * @param[in] columns See mrfStore_create()
+ * @param[in] packing Bitwise OR of MRF_STORE_PACK_SEQUENCES and
+ * MRF_STORE_BIN_QUALITIES; 0 stores the strings as they are
+ * @note Packing maps symbols other than A, C, G and T to 'N' and folds
+ * lower case; binning is lossy.
+ * @post Use mrfStore_destroy to de-allocate the memory
+ */
+MrfStore* mrfStore_createPacked (int columns, int packing)
+{
+  MrfStore *store;
+
+  AllocVar (store);
+  store->packing = packing;
+  store->columns = columns & (MRF_COLUMN_MASK (MRF_COLUMN_TYPE_SEQUENCE) |
+                              MRF_COLUMN_MASK (MRF_COLUMN_TYPE_QUALITY_SCORES) |
+                              MRF_COLUMN_MASK (MRF_COLUMN_TYPE_QUERY_ID));
+  store->entryFirstRead = arrayCreate (1000,int);
+  store->readFirstBlock = arrayCreate (1000,int);
+  store->readStrings = arrayCreate (1000,long);
+  store->blocks = arrayCreate (1000,MrfStoreBlock);
+  store->targets = targetDict_create ();
+  store->exceptions = arrayCreate (256,int);
+  store->arenaCapacity = 65536;
+  store->arenaSize = 0;
+  store->arena = hlr_malloc (store->arenaCapacity);
+  if (store->arena == NULL) {
+    die ("Unable to allocate the string arena");
+  }
+  array (store->entryFirstRead,0,int) = 0;
+  array (store->readFirstBlock,0,int) = 0;
+  return store;
+}
+
+/**
+ * Deallocate a store.
+ */
+void mrfStore_destroy (MrfStore *store)
+{
+  if (store == NULL) {
+    return;
+  }
+  arrayDestroy (store->entryFirstRead);
+  arrayDestroy (store->readFirstBlock);
+  arrayDestroy (store->readStrings);
+  arrayDestroy (store->blocks);
+  targetDict_destroy (store->targets);
+  arrayDestroy (store->exceptions);
+  hlr_free (store->arena);
+  freeMem (store);
+}
+
+static void mrfStore_addRead (MrfStore *store, MrfRead *currRead)
+{
+  MrfBlock *currBlock;
+  MrfStoreBlock *storeBlock;
+  int i;
+
+  for (i = 0; i < arrayMax (currRead->blocks); i++) {
+    currBlock = arrp (currRead->blocks,i,MrfBlock);
+    storeBlock = arrayp (store->blocks,arrayMax (store->blocks),MrfStoreBlock);
+    storeBlock->targetId = targetDict_getId (store->targets,currBlock->targetName);
+    storeBlock->strand = currBlock->strand;
+    storeBlock->targetStart = currBlock->targetStart;
+    storeBlock->targetEnd = currBlock->targetEnd;
+    storeBlock->queryStart = currBlock->queryStart;
+    storeBlock->queryEnd = currBlock->queryEnd;
+  }
+  array (store->readFirstBlock,arrayMax (store->readFirstBlock),int) =
+    arrayMax (store->blocks);
+  array (store->readStrings,arrayMax (store->readStrings),long) = store->arenaSize;
+  if (store->columns & MRF_COLUMN_MASK (MRF_COLUMN_TYPE_SEQUENCE)) {
+    if (store->packing & MRF_STORE_PACK_SEQUENCES) {
+      mrfStore_appendPackedSequence (store,currRead->sequence);
+    }
+    else {
+      mrfStore_appendString (store,currRead->sequence);
+    }
+  }
+  if (store->columns & MRF_COLUMN_MASK (MRF_COLUMN_TYPE_QUALITY_SCORES)) {
+    if (store->packing & MRF_STORE_BIN_QUALITIES) {
+      mrfStore_appendBinnedQualities (store,currRead->qualityScores);
+    }
+    else {
+      mrfStore_appendString (store,currRead->qualityScores);
+    }
+  }
+  if (store->columns & MRF_COLUMN_MASK (MRF_COLUMN_TYPE_QUERY_ID)) {
+    mrfStore_appendString (store,currRead->queryId);
+  }
+}
+
+/**
+ * Append a copy of an MrfEntry to the store.
+ */
+void mrfStore_addEntry (MrfStore *store, MrfEntry *currEntry)
+{
+  mrfStore_addRead (store,&currEntry->read1);
+  if (currEntry->isPairedEnd == 1) {
+    mrfStore_addRead (store,&currEntry->read2);
+  }
+  array (store->entryFirstRead,arrayMax (store->entryFirstRead),int) =
+    arrayMax (store->readStrings);
+}
+
+/**
+ * Read all remaining entries of the mrf module into a store. The string
+ * columns loaded by the reader are kept.
+ * @pre The module has been initialized using mrf_init().
+ * @post Use mrfStore_destroy to de-allocate the memory
+ */
+MrfStore* mrfStore_parse (void)
+{
+  return mrfStore_parsePacked (0);
+}
+
+/**
+ * Read all remaining entries of the mrf module into a packed store.
+ * @param[in] packing See mrfStore_createPacked()
+ * @pre The module has been initialized using mrf_init().
+ * @post Use mrfStore_destroy to de-allocate the memory
+ */
+MrfStore* mrfStore_parsePacked (int packing)
+{
+  MrfStore *store;
+  MrfEntry *currEntry;
+
+  store = mrfStore_createPacked (mrf_getColumns (),packing);
+  while (currEntry = mrf_nextEntry ()) {
+    mrfStore_addEntry (store,currEntry);
+  }
+  return store;
+}
+
+/**
+ * Returns the number of entries in the store.
+ */
+int mrfStore_numEntries (MrfStore *store)
+{
+  return arrayMax (store->entryFirstRead) - 1;
+}
+
+/**
+ * Returns the number of reads (mates) in the store.
+ */
+int mrfStore_numReads (MrfStore *store)
+{
+  return arrayMax (store->readStrings);
+}
+
+/**
+ * Returns 1 if the entry has two mates.
+ */
+int mrfStore_isPairedEnd (MrfStore *store, int entry)
+{
+  return arru (store->entryFirstRead,entry + 1,int) -
+    arru (store->entryFirstRead,entry,int) == 2;
+}
+
+/**
+ * Returns the index of a read of an entry.
+ * @param[in] mate R_FIRST (0) or, for paired-end entries, R_SECOND (1)
+ */
+int mrfStore_getRead (MrfStore *store, int entry, int mate)
+{
+  return arru (store->entryFirstRead,entry,int) + mate;
+}
+
+/**
+ * Returns the number of blocks of a read.
+ */
+int mrfStore_numBlocks (MrfStore *store, int read)
+{
+  return arru (store->readFirstBlock,read + 1,int) -
+    arru (store->readFirstBlock,read,int);
+}
+
+/**
+ * Returns a pointer to the first of the mrfStore_numBlocks() consecutive
+ * blocks of a read.
+ * @note The memory belongs to the store.
+ */
+MrfStoreBlock* mrfStore_getBlocks (MrfStore *store, int read)
+{
+  return arrp (store->blocks,arru (store->readFirstBlock,read,int),MrfStoreBlock);
+}
+
+/**
+ * Returns the number of distinct targets.
+ */
+int mrfStore_numTargets (MrfStore *store)
+{
+  return targetDict_size (store->targets);
+}
+
+/**
+ * Returns the name of a target id used in MrfStoreBlock.
+ */
+char* mrfStore_getTargetName (MrfStore *store, int targetId)
+{
+  return targetDict_getName (store->targets,targetId);
+}
+
+/**
+ * Compute and return the length of a read from its blocks, like getReadLength().
+ */
+int mrfStore_getReadLength (MrfStore *store, int read)
+{
+  MrfStoreBlock *blocks;
+  int i,n;
+  int sum;
+
+  blocks = mrfStore_getBlocks (store,read);
+  n = mrfStore_numBlocks (store,read);
+  sum = 0;
+  for (i = 0; i < n; i++) {
+    sum += blocks[i].targetEnd - blocks[i].targetStart + 1;
+  }
+  return sum;
+}
+
+// Fields of a read are stored in column order; skip the ones before columnType
+static char* mrfStore_getField (MrfStore *store, int read, int columnType)
+{
+  char *field;
+  int type;
+
+  if (!(store->columns & MRF_COLUMN_MASK (columnType))) {
+    return NULL;
+  }
+  field = store->arena + arru (store->readStrings,read,long);
+  for (type = MRF_COLUMN_TYPE_SEQUENCE; type < columnType; type++) {
+    if (store->columns & MRF_COLUMN_MASK (type)) {
+      field += mrfStore_getFieldSize (store,type,field);
+    }
+  }
+  return field;
+}
+
+/**
+ * Returns the sequence of a read, or NULL if the column is not stored or
+ * the store packs sequences (use mrfStore_copySequence() then).
+ * @note The memory belongs to the store.
+ */
+char* mrfStore_getSequence (MrfStore *store, int read)
+{
+  if (store->packing & MRF_STORE_PACK_SEQUENCES) {
+    return NULL;
+  }
+  return mrfStore_getField (store,read,MRF_COLUMN_TYPE_SEQUENCE);
+}
+
+/**
+ * Returns the quality scores of a read, or NULL if the column is not stored
+ * or the store bins qualities (use mrfStore_copyQualityScores() then).
+ * @note The memory belongs to the store.
+ */
+char* mrfStore_getQualityScores (MrfStore *store, int read)
+{
+  if (store->packing & MRF_STORE_BIN_QUALITIES) {
+    return NULL;
+  }
+  return mrfStore_getField (store,read,MRF_COLUMN_TYPE_QUALITY_SCORES);
+}
+
+/**
+ * Returns the query id of a read, or NULL if the column is not stored.
+ * @note The memory belongs to the store.
+ */
+char* mrfStore_getQueryId (MrfStore *store, int read)
+{
+  return mrfStore_getField (store,read,MRF_COLUMN_TYPE_QUERY_ID);
+}
+
+/**
+ * Returns the length of the sequence of a read, or -1 if it is not stored.
+ */
+int mrfStore_getSequenceLength (MrfStore *store, int read)
+{
+  char *field;
+
+  field = mrfStore_getField (store,read,MRF_COLUMN_TYPE_SEQUENCE);
+  if (field == NULL) {
+    return -1;
+  }
+  if (store->packing & MRF_STORE_PACK_SEQUENCES) {
+    return mrfStore_readInt (field);
+  }
+  return strlen (field);
+}
+
+/**
+ * Copy the sequence of a read into a buffer, unpacking it if necessary.
+ * @param[out] buffer At least mrfStore_getSequenceLength () + 1 bytes
+ * @return Length of the sequence, or -1 if it is not stored
+ */
+int mrfStore_copySequence (MrfStore *store, int read, char *buffer)
+{
+  char *field;
+  int length,numExceptions,i;
+
+  field = mrfStore_getField (store,read,MRF_COLUMN_TYPE_SEQUENCE);
+  if (field == NULL) {
+    return -1;
+  }
+  if (!(store->packing & MRF_STORE_PACK_SEQUENCES)) {
+    length = strlen (field);
+    memcpy (buffer,field,length + 1);
+    return length;
+  }
+  length = mrfStore_readInt (field);
+  numExceptions = mrfStore_readInt (field + sizeof (int));
+  seqPack_unpack ((unsigned char*)field + (2 + numExceptions) * sizeof (int),length,
+                  NULL,0,buffer);
+  // Exceptions are read in place; the arena offers no int alignment
+  for (i = 0; i < numExceptions; i++) {
+    buffer[mrfStore_readInt (field + (2 + i) * sizeof (int))] = 'N';
+  }
+  return length;
+}
+
+/**
+ * Copy the quality scores of a read into a buffer, expanding bins if necessary.
+ * @param[out] buffer At least as many bytes as the sequence buffer
+ * @return Number of quality scores, or -1 if they are not stored
+ */
+int mrfStore_copyQualityScores (MrfStore *store, int read, char *buffer)
+{
+  char *field;
+  int length;
+
+  field = mrfStore_getField (store,read,MRF_COLUMN_TYPE_QUALITY_SCORES);
+  if (field == NULL) {
+    return -1;
+  }
+  if (!(store->packing & MRF_STORE_BIN_QUALITIES)) {
+    length = strlen (field);
+    memcpy (buffer,field,length + 1);
+    return length;
+  }
+  length = mrfStore_readInt (field);
+  seqPack_unbinQualities ((unsigned char*)field + sizeof (int),length,buffer);
+  return length;
+}
+
+/**
+ * Returns the approximate number of bytes held by the store.
+ */
+long mrfStore_memoryUsage (MrfStore *store)
+{
+  return sizeof (MrfStore) + store->arenaCapacity +
+    (long)arrayMax (store->entryFirstRead) * sizeof (int) +
+    (long)arrayMax (store->readFirstBlock) * sizeof (int) +
+    (long)arrayMax (store->readStrings) * sizeof (long) +
+    (long)arrayMax (store->blocks) * sizeof (MrfStoreBlock) +
+    (long)arrayMax (store->exceptions) * sizeof (int) +
+    targetDict_memoryUsage (store->targets);
+}
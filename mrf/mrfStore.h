@@ -0,0 +1,82 @@
+/// @file mrfStore.h
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Compact in-memory store of MRF entries.
+///
+/// Blocks of all reads live in one flat array, addressed through per-read
+/// offsets, and target names are replaced by ids into a dictionary.
+/// Sequences, quality scores and query ids are kept back to back in one
+/// string arena. Entries, reads and blocks are addressed by index.
+///
+/// Optionally sequences are held at 2 bits per base (see seqPack.h) and
+/// quality scores as 4-bit bins; mrfStore_copySequence() and
+/// mrfStore_copyQualityScores() work in every mode.
+///
+/// The accessors never modify the store, so a filled store can be read by
+/// several threads at once; adding entries needs exclusive access.
+
+#ifndef DEF_MRF_STORE_H
+#define DEF_MRF_STORE_H
+
+#include "mrf.h"
+#include "targetDict.h"
+
+// packing options for mrfStore_createPacked
+#define MRF_STORE_PACK_SEQUENCES 1
+#define MRF_STORE_BIN_QUALITIES 2
+
+/// @struct MrfStoreBlock
+/// @brief An alignment block with the target name replaced by an id.
+typedef struct {
+  int targetId;
+  int targetStart;
+  int targetEnd;
+  int queryStart;
+  int queryEnd;
+  char strand;
+} MrfStoreBlock;
+
+/// @struct MrfStore
+/// @brief Columnar collection of MRF entries; use the accessors below.
+typedef struct {
+  int columns;            // MRF_COLUMN_MASK bits of the stored string columns
+  int packing;            // MRF_STORE_PACK_SEQUENCES, MRF_STORE_BIN_QUALITIES
+  Array entryFirstRead;   // of int, numEntries + 1; an entry has 1 or 2 reads
+  Array readFirstBlock;   // of int, numReads + 1
+  Array readStrings;      // of long, offset of the read's strings in the arena
+  Array blocks;           // of MrfStoreBlock
+  TargetDict *targets;
+  char *arena;            // NUL-terminated strings, in column order
+  long arenaSize;
+  long arenaCapacity;
+  Array exceptions;       // of int, scratch space for mrfStore_addEntry()
+} MrfStore;
+
+MrfStore* mrfStore_create (int columns);
+MrfStore* mrfStore_createPacked (int columns, int packing);
+void mrfStore_destroy (MrfStore *store);
+void mrfStore_addEntry (MrfStore *store, MrfEntry *currEntry);
+MrfStore* mrfStore_parse (void);
+MrfStore* mrfStore_parsePacked (int packing);
+
+int mrfStore_numEntries (MrfStore *store);
+int mrfStore_numReads (MrfStore *store);
+int mrfStore_isPairedEnd (MrfStore *store, int entry);
+int mrfStore_getRead (MrfStore *store, int entry, int mate);
+int mrfStore_numBlocks (MrfStore *store, int read);
+MrfStoreBlock* mrfStore_getBlocks (MrfStore *store, int read);
+int mrfStore_numTargets (MrfStore *store);
+char* mrfStore_getTargetName (MrfStore *store, int targetId);
+int mrfStore_getReadLength (MrfStore *store, int read);
+char* mrfStore_getSequence (MrfStore *store, int read);
+char* mrfStore_getQualityScores (MrfStore *store, int read);
+char* mrfStore_getQueryId (MrfStore *store, int read);
+int mrfStore_getSequenceLength (MrfStore *store, int read);
+int mrfStore_copySequence (MrfStore *store, int read, char *buffer);
+int mrfStore_copyQualityScores (MrfStore *store, int read, char *buffer);
+long mrfStore_memoryUsage (MrfStore *store);
+
+#endif /* DEF_MRF_STORE_H */
@@ -11,13 +11,13 @@
 #include <bios/linestream.h>
 
 #include "mrfUtil.h"
+#include "tokenizer.h"
 
 Array readTarsFromBedFile (char *fileName) {
   Array tars;
   Tar *currTar;
   LineStream ls;
-  WordIter w;
-  char *line;
+  char *line,*tab,*nextTab;
  
   tars = arrayCreate (100000,Tar);
   ls = ls_createFromFile (fileName);
@@ -25,12 +25,16 @@ Array readTarsFromBedFile (char *fileName) {
     if (strStartsWithC (line,"browser") || strStartsWithC (line,"track")) {
       continue;
     }
-    w = wordIterCreate (line,"\t",0);
+    tab = tokenizer_find (line,TOKENIZER_TAB);
+    nextTab = *tab == '\0' ? tab : tokenizer_find (tab + 1,TOKENIZER_TAB);
+    if (*nextTab == '\0') {
+      die ("Invalid BED line: %s",line);
+    }
+    *tab = '\0';
     currTar = arrayp (tars,arrayMax (tars),Tar);
-    currTar->targetName = hlr_strdup (wordNext (w));
-    currTar->start = atoi (wordNext (w));
-    currTar->end = atoi (wordNext (w));
-    wordIterDestroy (w);
+    currTar->targetName = hlr_strdup (line);
+    currTar->start = tokenizer_parseInt (tab + 1,NULL);
+    currTar->end = tokenizer_parseInt (nextTab + 1,NULL);
   }
   ls_destroy (ls);
   return tars;
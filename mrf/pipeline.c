@@ -0,0 +1,346 @@
+/// @file pipeline.c
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Multi-threaded read/transform/write pipeline over MRF entries. Batches
+/// cycle through three bounded multi-producer/multi-consumer queues (free,
+/// filled and transformed) built on sequence-numbered ring cells.
+
+#define _GNU_SOURCE
+
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <bios/log.h>
+#include <bios/format.h>
+#include <bios/common.h>
+
+#include "pipeline.h"
+
+#define PIPELINE_CACHE_LINE 64
+
+typedef struct {
+  long sequence;
+  MrfBatch *batch;
+} PipelineCell;
+
+typedef struct {
+  PipelineCell *cells;
+  long mask;
+  char pad0[PIPELINE_CACHE_LINE];
+  long enqueuePos;
+  char pad1[PIPELINE_CACHE_LINE];
+  long dequeuePos;
+  char pad2[PIPELINE_CACHE_LINE];
+} PipelineQueue;
+
+typedef struct {
+  MrfPipelineConfig config;
+  MrfTransform transform;
+  void *userData;
+  FILE *out;
+  PipelineQueue freeBatches;
+  PipelineQueue filledBatches;
+  PipelineQueue doneBatches;
+  MrfBatch *batches;
+  long numBatchesRead;
+  int readerDone;
+  long numWritten;
+} Pipeline;
+
+static void pipeline_initQueue (PipelineQueue *queue, int minCapacity)
+{
+  long capacity;
+  long i;
+
+  capacity = 1;
+  while (capacity < minCapacity) {
+    capacity <<= 1;
+  }
+  queue->cells = (PipelineCell*)needMem (capacity * sizeof (PipelineCell));
+  for (i = 0; i < capacity; i++) {
+    queue->cells[i].sequence = i;
+  }
+  queue->mask = capacity - 1;
+  queue->enqueuePos = 0;
+  queue->dequeuePos = 0;
+}
+
+static int pipeline_push (PipelineQueue *queue, MrfBatch *batch)
+{
+  PipelineCell *cell;
+  long pos,diff;
+
+  pos = __atomic_load_n (&queue->enqueuePos,__ATOMIC_RELAXED);
+  for (;;) {
+    cell = &queue->cells[pos & queue->mask];
+    diff = __atomic_load_n (&cell->sequence,__ATOMIC_ACQUIRE) - pos;
+    if (diff == 0) {
+      if (__atomic_compare_exchange_n (&queue->enqueuePos,&pos,pos + 1,1,
+                                       __ATOMIC_RELAXED,__ATOMIC_RELAXED)) {
+        break;
+      }
+    }
+    else if (diff < 0) {
+      return 0;
+    }
+    else {
+      pos = __atomic_load_n (&queue->enqueuePos,__ATOMIC_RELAXED);
+    }
+  }
+  cell->batch = batch;
+  __atomic_store_n (&cell->sequence,pos + 1,__ATOMIC_RELEASE);
+  return 1;
+}
+
+static MrfBatch* pipeline_pop (PipelineQueue *queue)
+{
+  PipelineCell *cell;
+  MrfBatch *batch;
+  long pos,diff;
+
+  pos = __atomic_load_n (&queue->dequeuePos,__ATOMIC_RELAXED);
+  for (;;) {
+    cell = &queue->cells[pos & queue->mask];
+    diff = __atomic_load_n (&cell->sequence,__ATOMIC_ACQUIRE) - (pos + 1);
+    if (diff == 0) {
+      if (__atomic_compare_exchange_n (&queue->dequeuePos,&pos,pos + 1,1,
+                                       __ATOMIC_RELAXED,__ATOMIC_RELAXED)) {
+        break;
+      }
+    }
+    else if (diff < 0) {
+      return NULL;
+    }
+    else {
+      pos = __atomic_load_n (&queue->dequeuePos,__ATOMIC_RELAXED);
+    }
+  }
+  batch = cell->batch;
+  __atomic_store_n (&cell->sequence,pos + queue->mask + 1,__ATOMIC_RELEASE);
+  return batch;
+}
+
+// Spin briefly, then yield, then sleep while a queue stays empty
+static void pipeline_backoff (int *spins)
+{
+  struct timespec pause;
+
+  if (*spins < 64) {
+    (*spins)++;
+  }
+  else if (*spins < 256) {
+    (*spins)++;
+    sched_yield ();
+  }
+  else {
+    pause.tv_sec = 0;
+    pause.tv_nsec = 20000;
+    nanosleep (&pause,NULL);
+  }
+}
+
+static void pipeline_pushWait (PipelineQueue *queue, MrfBatch *batch)
+{
+  int spins;
+
+  spins = 0;
+  while (!pipeline_push (queue,batch)) {
+    pipeline_backoff (&spins);
+  }
+}
+
+static void* pipeline_worker (void *arg)
+{
+  Pipeline *pipeline;
+  MrfBatch *batch;
+  int spins;
+
+  pipeline = (Pipeline*)arg;
+  spins = 0;
+  for (;;) {
+    batch = pipeline_pop (&pipeline->filledBatches);
+    if (batch == NULL) {
+      // Batches are queued before readerDone is set, so check once more
+      if (__atomic_load_n (&pipeline->readerDone,__ATOMIC_ACQUIRE) &&
+          (batch = pipeline_pop (&pipeline->filledBatches)) == NULL) {
+        break;
+      }
+      if (batch == NULL) {
+        pipeline_backoff (&spins);
+        continue;
+      }
+    }
+    spins = 0;
+    pipeline->transform (batch,pipeline->userData);
+    pipeline_pushWait (&pipeline->doneBatches,batch);
+  }
+  return NULL;
+}
+
+static void pipeline_writeBatch (Pipeline *pipeline, MrfBatch *batch)
+{
+  int i;
+
+  for (i = 0; i < batch->numEntries; i++) {
+    if (batch->keep[i]) {
+      if (pipeline->out != NULL) {
+        fprintf (pipeline->out,"%s\n",mrf_writeEntry (batch->entries[i]));
+      }
+      pipeline->numWritten++;
+    }
+    mrf_freeEntry (batch->entries[i]);
+  }
+  batch->numEntries = 0;
+}
+
+static void* pipeline_writer (void *arg)
+{
+  Pipeline *pipeline;
+  MrfBatch **pending;
+  MrfBatch *batch;
+  long nextSequence;
+  int numBatches;
+  int spins;
+
+  pipeline = (Pipeline*)arg;
+  numBatches = pipeline->config.numBatches;
+  // At most numBatches consecutive batches are in flight, so slots never collide
+  pending = (MrfBatch**)needMem (numBatches * sizeof (MrfBatch*));
+  nextSequence = 0;
+  spins = 0;
+  for (;;) {
+    batch = pipeline_pop (&pipeline->doneBatches);
+    if (batch == NULL) {
+      if (__atomic_load_n (&pipeline->readerDone,__ATOMIC_ACQUIRE) &&
+          nextSequence == pipeline->numBatchesRead) {
+        break;
+      }
+      pipeline_backoff (&spins);
+      continue;
+    }
+    spins = 0;
+    pending[batch->sequence % numBatches] = batch;
+    while ((batch = pending[nextSequence % numBatches]) != NULL &&
+           batch->sequence == nextSequence) {
+      pending[nextSequence % numBatches] = NULL;
+      pipeline_writeBatch (pipeline,batch);
+      pipeline_pushWait (&pipeline->freeBatches,batch);
+      nextSequence++;
+    }
+  }
+  freeMem (pending);
+  return NULL;
+}
+
+// Fill batches on the calling thread until the input is exhausted
+static void pipeline_read (Pipeline *pipeline)
+{
+  MrfBatch *batch;
+  MrfEntry *currEntry;
+  int spins;
+
+  currEntry = mrf_nextDetachedEntry ();
+  while (currEntry != NULL) {
+    spins = 0;
+    while ((batch = pipeline_pop (&pipeline->freeBatches)) == NULL) {
+      pipeline_backoff (&spins);
+    }
+    while (currEntry != NULL && batch->numEntries < pipeline->config.batchSize) {
+      batch->keep[batch->numEntries] = 1;
+      batch->entries[batch->numEntries++] = currEntry;
+      currEntry = mrf_nextDetachedEntry ();
+    }
+    batch->sequence = pipeline->numBatchesRead++;
+    pipeline_pushWait (&pipeline->filledBatches,batch);
+  }
+  __atomic_store_n (&pipeline->readerDone,1,__ATOMIC_RELEASE);
+}
+
+/**
+ * Set the default pipeline parameters: one worker per online processor,
+ * batches of 1024 entries and four batches in flight per worker.
+ */
+void mrfPipeline_initConfig (MrfPipelineConfig *config)
+{
+  long numProcessors;
+
+  numProcessors = sysconf (_SC_NPROCESSORS_ONLN);
+  config->numWorkers = numProcessors > 0 ? (int)numProcessors : 1;
+  config->batchSize = 1024;
+  config->numBatches = 4 * config->numWorkers;
+}
+
+/**
+ * Read all remaining entries, transform them in parallel and write the
+ * kept entries in input order.
+ * @param[in] config Pipeline parameters
+ * @param[in] transform Called once per batch on a worker thread
+ * @param[in] userData Passed to transform
+ * @param[in] out Destination of the kept entries; NULL to discard them
+ * @return Number of kept entries
+ * @pre The module has been initialized using mrf_init(). The caller writes
+ * the header, if any, before calling this routine.
+ * @note The MRF reader and writer must not be used by other threads while
+ * the pipeline runs.
+ */
+long mrfPipeline_run (MrfPipelineConfig *config, MrfTransform transform,
+                      void *userData, FILE *out)
+{
+  Pipeline pipeline;
+  pthread_t *workers;
+  pthread_t writer;
+  MrfBatch *batch;
+  int i;
+
+  if (config->numWorkers < 1 || config->batchSize < 1 || config->numBatches < 1) {
+    die ("Invalid pipeline configuration: %d workers, %d entries per batch, %d batches",
+         config->numWorkers,config->batchSize,config->numBatches);
+  }
+  pipeline.config = *config;
+  pipeline.transform = transform;
+  pipeline.userData = userData;
+  pipeline.out = out;
+  pipeline.numBatchesRead = 0;
+  pipeline.readerDone = 0;
+  pipeline.numWritten = 0;
+  pipeline_initQueue (&pipeline.freeBatches,config->numBatches);
+  pipeline_initQueue (&pipeline.filledBatches,config->numBatches);
+  pipeline_initQueue (&pipeline.doneBatches,config->numBatches);
+  pipeline.batches = (MrfBatch*)needMem (config->numBatches * sizeof (MrfBatch));
+  for (i = 0; i < config->numBatches; i++) {
+    batch = &pipeline.batches[i];
+    batch->entries = (MrfEntry**)needMem (config->batchSize * sizeof (MrfEntry*));
+    batch->keep = (char*)needMem (config->batchSize);
+    batch->numEntries = 0;
+    pipeline_push (&pipeline.freeBatches,batch);
+  }
+  workers = (pthread_t*)needMem (config->numWorkers * sizeof (pthread_t));
+  for (i = 0; i < config->numWorkers; i++) {
+    if (pthread_create (&workers[i],NULL,pipeline_worker,&pipeline) != 0) {
+      die ("Unable to create pipeline worker thread");
+    }
+  }
+  if (pthread_create (&writer,NULL,pipeline_writer,&pipeline) != 0) {
+    die ("Unable to create pipeline writer thread");
+  }
+  pipeline_read (&pipeline);
+  for (i = 0; i < config->numWorkers; i++) {
+    pthread_join (workers[i],NULL);
+  }
+  pthread_join (writer,NULL);
+  for (i = 0; i < config->numBatches; i++) {
+    freeMem (pipeline.batches[i].entries);
+    freeMem (pipeline.batches[i].keep);
+  }
+  freeMem (pipeline.batches);
+  freeMem (workers);
+  freeMem (pipeline.freeBatches.cells);
+  freeMem (pipeline.filledBatches.cells);
+  freeMem (pipeline.doneBatches.cells);
+  return pipeline.numWritten;
+}
@@ -0,0 +1,47 @@
+/// @file pipeline.h
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Multi-threaded read/transform/write pipeline over MRF entries.
+///
+/// The calling thread reads entries into batches, a pool of worker threads
+/// applies a user transform to each batch and a writer thread writes the
+/// kept entries in input order. The stages are connected by bounded
+/// lock-free queues; the number of batches in flight, and thereby the
+/// memory footprint, is fixed by MrfPipelineConfig.numBatches.
+
+#ifndef DEF_MRF_PIPELINE_H
+#define DEF_MRF_PIPELINE_H
+
+#include <stdio.h>
+
+#include "mrf.h"
+
+/// @struct MrfBatch
+/// @brief Consecutive entries handed to a transform.
+typedef struct {
+  MrfEntry **entries;
+  char *keep;        // per entry, 1 on entry to the transform; 0 drops it
+  int numEntries;
+  long sequence;     // position of the batch in the input
+} MrfBatch;
+
+/// Transform applied by the workers. Entries may be modified in place; a
+/// transform must not retain pointers into the batch after returning.
+typedef void (*MrfTransform) (MrfBatch *batch, void *userData);
+
+/// @struct MrfPipelineConfig
+/// @brief Pipeline parameters; see mrfPipeline_initConfig() for defaults.
+typedef struct {
+  int numWorkers;    // transform threads
+  int batchSize;     // entries per batch
+  int numBatches;    // batches in flight
+} MrfPipelineConfig;
+
+void mrfPipeline_initConfig (MrfPipelineConfig *config);
+long mrfPipeline_run (MrfPipelineConfig *config, MrfTransform transform,
+                      void *userData, FILE *out);
+
+#endif /* DEF_MRF_PIPELINE_H */
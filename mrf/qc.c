@@ -0,0 +1,552 @@
+/// @file qc.c
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Quality-control statistics of MRF reads. Bases and qualities are first
+/// counted in per-cycle byte counters, which fit in the L1 cache and are
+/// added to the 64-bit counts every 255 reads. With SSE2, bases are counted
+/// 16 cycles at a time, one row of counters per base; other targets count
+/// them one at a time.
+
+#define _GNU_SOURCE
+
+#include <pthread.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include <bios/log.h>
+#include <bios/format.h>
+#include <bios/common.h>
+
+#include "qc.h"
+#include "pipeline.h"
+
+#define QC_QUALITY_OFFSET 33
+#define QC_MAX_PENDING_READS 255
+
+typedef struct {
+  pthread_key_t qcKey;
+  pthread_mutex_t mutex;
+  Array accumulators;   // of MrfQc*, one per worker
+} QcCounter;
+
+// Extend an Array of long with zeros to at least n elements
+static void qc_ensure (Array counts, int n)
+{
+  while (arrayMax (counts) < n) {
+    array (counts,arrayMax (counts),long) = 0;
+  }
+}
+
+static void qc_increment (Array counts, int index)
+{
+  qc_ensure (counts,index + 1);
+  arru (counts,index,long)++;
+}
+
+static void qc_initReadStats (MrfQcReadStats *stats)
+{
+  memset (stats,0,sizeof (MrfQcReadStats));
+  stats->baseCounts = arrayCreate (MRF_QC_NUM_BASES * 256,long);
+  stats->qualityCounts = arrayCreate (MRF_QC_NUM_QUALITIES * 256,long);
+  stats->lengthCounts = arrayCreate (256,long);
+  stats->blockCounts = arrayCreate (16,long);
+  stats->gcCounts = arrayCreate (101,long);
+  stats->pendingCounts = arrayCreate (MRF_QC_NUM_BASES * 256,unsigned char);
+  stats->pendingQualityCounts = arrayCreate (MRF_QC_NUM_QUALITIES * 256,unsigned char);
+  stats->buffer = arrayCreate (256,char);
+}
+
+static void qc_freeReadStats (MrfQcReadStats *stats)
+{
+  arrayDestroy (stats->baseCounts);
+  arrayDestroy (stats->qualityCounts);
+  arrayDestroy (stats->lengthCounts);
+  arrayDestroy (stats->blockCounts);
+  arrayDestroy (stats->gcCounts);
+  arrayDestroy (stats->pendingCounts);
+  arrayDestroy (stats->pendingQualityCounts);
+  arrayDestroy (stats->buffer);
+}
+
+// Extend an Array of unsigned char with zeros to at least n elements
+static void qc_ensurePending (Array pending, int n)
+{
+  while (arrayMax (pending) < n) {
+    array (pending,arrayMax (pending),unsigned char) = 0;
+  }
+}
+
+// Add the quality byte counters to qualityCounts and qualitySum
+static void qc_flushQualities (MrfQcReadStats *stats)
+{
+  unsigned char *pending;
+  int numCounts,quality,i;
+
+  pending = arrp (stats->pendingQualityCounts,0,unsigned char);
+  // Rows are padded to a multiple of 16 cycles; skip the unused tail
+  numCounts = stats->pendingQualityCycles * MRF_QC_NUM_QUALITIES;
+  while (numCounts > 0 && pending[numCounts - 1] == 0) {
+    numCounts--;
+  }
+  qc_ensure (stats->qualityCounts,numCounts);
+  for (i = 0; i < numCounts; i++) {
+    quality = i % MRF_QC_NUM_QUALITIES;
+    arru (stats->qualityCounts,i,long) += pending[i];
+    stats->qualitySum += (long)quality * pending[i];
+  }
+  memset (pending,0,numCounts);
+}
+
+// Add the byte counters to baseCounts and qualityCounts and clear them
+static void qc_flushPending (MrfQcReadStats *stats)
+{
+  unsigned char *pending;
+  int base,cycle,numCycles;
+
+  if (stats->pendingReads == 0) {
+    return;
+  }
+  qc_flushQualities (stats);
+  pending = arrp (stats->pendingCounts,0,unsigned char);
+  // Rows are padded to a multiple of 16 cycles; skip the unused tail
+  numCycles = 0;
+  for (base = 0; base < MRF_QC_NUM_BASES; base++) {
+    for (cycle = stats->pendingCycles - 1; cycle >= numCycles; cycle--) {
+      if (pending[base * stats->pendingCycles + cycle] != 0) {
+        numCycles = cycle + 1;
+        break;
+      }
+    }
+  }
+  qc_ensure (stats->baseCounts,numCycles * MRF_QC_NUM_BASES);
+  for (base = 0; base < MRF_QC_NUM_BASES; base++) {
+    for (cycle = 0; cycle < numCycles; cycle++) {
+      arru (stats->baseCounts,cycle * MRF_QC_NUM_BASES + base,long) +=
+        pending[base * stats->pendingCycles + cycle];
+    }
+  }
+  memset (pending,0,MRF_QC_NUM_BASES * stats->pendingCycles);
+  stats->pendingReads = 0;
+}
+
+#ifdef __SSE2__
+
+// Make the byte counters and the buffer cover length cycles, rounded up to 16
+static void qc_reservePending (MrfQcReadStats *stats, int length)
+{
+  int cycles,i;
+
+  if (length <= stats->pendingCycles) {
+    return;
+  }
+  qc_flushPending (stats);
+  cycles = (length + 15) & ~15;
+  arrayClear (stats->pendingCounts);
+  qc_ensurePending (stats->pendingCounts,MRF_QC_NUM_BASES * cycles);
+  for (i = arrayMax (stats->buffer); i < cycles; i++) {
+    array (stats->buffer,i,char) = 0;
+  }
+  stats->pendingCycles = cycles;
+}
+
+// Count the bases of a sequence per cycle; counts receives the number of
+// each base in the read
+static void qc_countBases (MrfQcReadStats *stats, char *sequence, int length, int *counts)
+{
+  static const char letters[MRF_QC_NUM_BASES - 1] = {'a','c','g','t'};
+  __m128i masks[MRF_QC_NUM_BASES];
+  __m128i zero,lower,ones,v,padding,known;
+  __m128i *pending;
+  char *buffer;
+  int i,base;
+
+  qc_reservePending (stats,length);
+  buffer = arrp (stats->buffer,0,char);
+  memcpy (buffer,sequence,length);
+  memset (buffer + length,0,stats->pendingCycles - length);
+  zero = _mm_setzero_si128 ();
+  lower = _mm_set1_epi8 (0x20);
+  ones = _mm_cmpeq_epi8 (zero,zero);
+  for (i = 0; i < length; i += 16) {
+    v = _mm_loadu_si128 ((const __m128i*)(buffer + i));
+    padding = _mm_cmpeq_epi8 (v,zero);
+    // Setting bit 5 maps 'A' to 'a' and leaves no other byte equal to 'a'
+    v = _mm_or_si128 (v,lower);
+    known = padding;
+    for (base = 0; base < MRF_QC_NUM_BASES - 1; base++) {
+      masks[base] = _mm_cmpeq_epi8 (v,_mm_set1_epi8 (letters[base]));
+      known = _mm_or_si128 (known,masks[base]);
+    }
+    masks[MRF_QC_BASE_N] = _mm_andnot_si128 (known,ones);
+    for (base = 0; base < MRF_QC_NUM_BASES; base++) {
+      // A matching byte is 0xFF, so subtracting the mask adds one
+      pending = (__m128i*)(arrp (stats->pendingCounts,0,unsigned char) +
+                           base * stats->pendingCycles + i);
+      _mm_storeu_si128 (pending,_mm_sub_epi8 (_mm_loadu_si128 (pending),masks[base]));
+      counts[base] += __builtin_popcount (_mm_movemask_epi8 (masks[base]));
+    }
+  }
+}
+
+#else
+
+static int qc_getBase (char c)
+{
+  switch (c | 0x20) {
+  case 'a':
+    return MRF_QC_BASE_A;
+  case 'c':
+    return MRF_QC_BASE_C;
+  case 'g':
+    return MRF_QC_BASE_G;
+  case 't':
+    return MRF_QC_BASE_T;
+  default:
+    return MRF_QC_BASE_N;
+  }
+}
+
+// Count the bases of a sequence per cycle; counts receives the number of
+// each base in the read
+static void qc_countBases (MrfQcReadStats *stats, char *sequence, int length, int *counts)
+{
+  int i,base;
+
+  qc_ensure (stats->baseCounts,length * MRF_QC_NUM_BASES);
+  for (i = 0; i < length; i++) {
+    base = qc_getBase (sequence[i]);
+    arru (stats->baseCounts,i * MRF_QC_NUM_BASES + base,long)++;
+    counts[base]++;
+  }
+}
+
+#endif
+
+static void qc_countQualities (MrfQcReadStats *stats, char *qualityScores)
+{
+  unsigned char *counts;
+  int length,quality,i;
+
+  length = strlen (qualityScores);
+  if (length > stats->pendingQualityCycles) {
+    // The counters are clear after a flush, so they can be extended
+    qc_flushPending (stats);
+    stats->pendingQualityCycles = (length + 15) & ~15;
+    qc_ensurePending (stats->pendingQualityCounts,
+                      stats->pendingQualityCycles * MRF_QC_NUM_QUALITIES);
+  }
+  counts = arrp (stats->pendingQualityCounts,0,unsigned char);
+  for (i = 0; i < length; i++) {
+    quality = (unsigned char)qualityScores[i] - QC_QUALITY_OFFSET;
+    if (quality < 0) {
+      quality = 0;
+    }
+    else if (quality >= MRF_QC_NUM_QUALITIES) {
+      quality = MRF_QC_NUM_QUALITIES - 1;
+    }
+    counts[i * MRF_QC_NUM_QUALITIES + quality]++;
+  }
+  stats->qualityBases += length;
+}
+
+/**
+ * Create an empty accumulator.
+ * @post Use mrfQc_destroy to de-allocate the memory
+ */
+MrfQc* mrfQc_create (void)
+{
+  MrfQc *qc;
+
+  AllocVar (qc);
+  qc_initReadStats (&qc->read1);
+  qc_initReadStats (&qc->read2);
+  return qc;
+}
+
+/**
+ * Deallocate an accumulator.
+ */
+void mrfQc_destroy (MrfQc *qc)
+{
+  if (qc == NULL) {
+    return;
+  }
+  qc_freeReadStats (&qc->read1);
+  qc_freeReadStats (&qc->read2);
+  freeMem (qc);
+}
+
+/**
+ * Add a read to the statistics of read1 or read2.
+ * @note baseCounts, qualityCounts and qualitySum are complete after
+ * mrfQc_flush().
+ */
+void mrfQc_addRead (MrfQcReadStats *stats, MrfRead *currRead)
+{
+  int counts[MRF_QC_NUM_BASES];
+  int length,called;
+
+  stats->reads++;
+  qc_increment (stats->blockCounts,arrayMax (currRead->blocks));
+  if (currRead->sequence != NULL) {
+    length = strlen (currRead->sequence);
+    memset (counts,0,sizeof (counts));
+    qc_countBases (stats,currRead->sequence,length,counts);
+    stats->bases += length;
+    stats->gcBases += counts[MRF_QC_BASE_C] + counts[MRF_QC_BASE_G];
+    stats->nBases += counts[MRF_QC_BASE_N];
+    called = length - counts[MRF_QC_BASE_N];
+    if (called > 0) {
+      qc_increment (stats->gcCounts,
+                    (200 * (counts[MRF_QC_BASE_C] + counts[MRF_QC_BASE_G]) + called) / (2 * called));
+    }
+  }
+  else {
+    length = getReadLength (currRead);
+  }
+  qc_increment (stats->lengthCounts,length);
+  if (currRead->qualityScores != NULL) {
+    qc_countQualities (stats,currRead->qualityScores);
+  }
+  if (++stats->pendingReads == QC_MAX_PENDING_READS) {
+    qc_flushPending (stats);
+  }
+}
+
+/**
+ * Add both reads of an entry.
+ */
+void mrfQc_addEntry (MrfQc *qc, MrfEntry *currEntry)
+{
+  qc->entries++;
+  mrfQc_addRead (&qc->read1,&currEntry->read1);
+  if (currEntry->isPairedEnd == 1) {
+    qc->pairedEntries++;
+    mrfQc_addRead (&qc->read2,&currEntry->read2);
+  }
+}
+
+/**
+ * Add a batch of entries, e.g. the entries of an MrfBatch.
+ */
+void mrfQc_addEntries (MrfQc *qc, MrfEntry **entries, int numEntries)
+{
+  int i;
+
+  for (i = 0; i < numEntries; i++) {
+    mrfQc_addEntry (qc,entries[i]);
+  }
+}
+
+/**
+ * Bring baseCounts, qualityCounts and qualitySum up to date; mrfQc_merge()
+ * and mrfQc_writeReport() do this implicitly.
+ */
+void mrfQc_flush (MrfQc *qc)
+{
+  qc_flushPending (&qc->read1);
+  qc_flushPending (&qc->read2);
+}
+
+static void qc_addCounts (Array counts, Array other)
+{
+  int i;
+
+  qc_ensure (counts,arrayMax (other));
+  for (i = 0; i < arrayMax (other); i++) {
+    arru (counts,i,long) += arru (other,i,long);
+  }
+}
+
+static void qc_mergeReadStats (MrfQcReadStats *stats, MrfQcReadStats *other)
+{
+  stats->reads += other->reads;
+  stats->bases += other->bases;
+  stats->gcBases += other->gcBases;
+  stats->nBases += other->nBases;
+  stats->qualityBases += other->qualityBases;
+  stats->qualitySum += other->qualitySum;
+  qc_addCounts (stats->baseCounts,other->baseCounts);
+  qc_addCounts (stats->qualityCounts,other->qualityCounts);
+  qc_addCounts (stats->lengthCounts,other->lengthCounts);
+  qc_addCounts (stats->blockCounts,other->blockCounts);
+  qc_addCounts (stats->gcCounts,other->gcCounts);
+}
+
+/**
+ * Add the statistics of other to qc; the counts of other are unchanged.
+ */
+void mrfQc_merge (MrfQc *qc, MrfQc *other)
+{
+  mrfQc_flush (qc);
+  mrfQc_flush (other);
+  qc->entries += other->entries;
+  qc->pairedEntries += other->pairedEntries;
+  qc_mergeReadStats (&qc->read1,&other->read1);
+  qc_mergeReadStats (&qc->read2,&other->read2);
+}
+
+static void qc_countBatch (MrfBatch *batch, void *userData)
+{
+  QcCounter *counter;
+  MrfQc *qc;
+  int i;
+
+  counter = (QcCounter*)userData;
+  qc = (MrfQc*)pthread_getspecific (counter->qcKey);
+  if (qc == NULL) {
+    qc = mrfQc_create ();
+    pthread_setspecific (counter->qcKey,qc);
+    pthread_mutex_lock (&counter->mutex);
+    array (counter->accumulators,arrayMax (counter->accumulators),MrfQc*) = qc;
+    pthread_mutex_unlock (&counter->mutex);
+  }
+  mrfQc_addEntries (qc,batch->entries,batch->numEntries);
+  for (i = 0; i < batch->numEntries; i++) {
+    batch->keep[i] = 0;
+  }
+}
+
+/**
+ * Collect the statistics of all remaining entries of the MRF reader.
+ * @param[in] numThreads Number of counting threads
+ * @pre The module has been initialized using mrf_init().
+ * @post Use mrfQc_destroy to de-allocate the memory
+ */
+MrfQc* mrfQc_run (int numThreads)
+{
+  QcCounter counter;
+  MrfPipelineConfig config;
+  MrfQc *qc,*threadQc;
+  int i;
+
+  counter.accumulators = arrayCreate (numThreads,MrfQc*);
+  if (pthread_key_create (&counter.qcKey,NULL) != 0) {
+    die ("Unable to create thread-specific QC accumulators");
+  }
+  pthread_mutex_init (&counter.mutex,NULL);
+  mrfPipeline_initConfig (&config);
+  config.numWorkers = numThreads > 0 ? numThreads : 1;
+  config.numBatches = 4 * config.numWorkers;
+  mrfPipeline_run (&config,qc_countBatch,&counter,NULL);
+  qc = mrfQc_create ();
+  for (i = 0; i < arrayMax (counter.accumulators); i++) {
+    threadQc = arru (counter.accumulators,i,MrfQc*);
+    mrfQc_merge (qc,threadQc);
+    mrfQc_destroy (threadQc);
+  }
+  arrayDestroy (counter.accumulators);
+  pthread_key_delete (counter.qcKey);
+  pthread_mutex_destroy (&counter.mutex);
+  return qc;
+}
+
+static double qc_percent (long part, long total)
+{
+  return total > 0 ? 100.0 * part / total : 0.0;
+}
+
+static void qc_writeCycles (FILE *out, char *name, MrfQcReadStats *stats)
+{
+  long *bases,*qualities;
+  long total,qualityTotal,qualitySum,cumulative;
+  int numCycles,cycle,base,quality,median;
+
+  numCycles = arrayMax (stats->baseCounts) / MRF_QC_NUM_BASES;
+  if (arrayMax (stats->qualityCounts) / MRF_QC_NUM_QUALITIES > numCycles) {
+    numCycles = arrayMax (stats->qualityCounts) / MRF_QC_NUM_QUALITIES;
+  }
+  qc_ensure (stats->baseCounts,numCycles * MRF_QC_NUM_BASES);
+  qc_ensure (stats->qualityCounts,numCycles * MRF_QC_NUM_QUALITIES);
+  for (cycle = 0; cycle < numCycles; cycle++) {
+    bases = arrp (stats->baseCounts,cycle * MRF_QC_NUM_BASES,long);
+    qualities = arrp (stats->qualityCounts,cycle * MRF_QC_NUM_QUALITIES,long);
+    total = 0;
+    for (base = 0; base < MRF_QC_NUM_BASES; base++) {
+      total += bases[base];
+    }
+    qualityTotal = 0;
+    qualitySum = 0;
+    for (quality = 0; quality < MRF_QC_NUM_QUALITIES; quality++) {
+      qualityTotal += qualities[quality];
+      qualitySum += quality * qualities[quality];
+    }
+    median = 0;
+    cumulative = 0;
+    for (quality = 0; quality < MRF_QC_NUM_QUALITIES && qualityTotal > 0; quality++) {
+      cumulative += qualities[quality];
+      if (2 * cumulative >= qualityTotal) {
+        median = quality;
+        break;
+      }
+    }
+    fprintf (out,"%s\t%d\t%.2f\t%.2f\t%.2f\t%.2f\t%.2f\t%.2f\t%d\n",name,cycle + 1,
+             qc_percent (bases[MRF_QC_BASE_A],total),qc_percent (bases[MRF_QC_BASE_C],total),
+             qc_percent (bases[MRF_QC_BASE_G],total),qc_percent (bases[MRF_QC_BASE_T],total),
+             qc_percent (bases[MRF_QC_BASE_N],total),
+             qualityTotal > 0 ? (double)qualitySum / qualityTotal : 0.0,median);
+  }
+}
+
+static void qc_writeHistogram (FILE *out, char *name, Array counts)
+{
+  int i;
+
+  for (i = 0; i < arrayMax (counts); i++) {
+    if (arru (counts,i,long) > 0) {
+      fprintf (out,"%s\t%d\t%ld\n",name,i,arru (counts,i,long));
+    }
+  }
+}
+
+/**
+ * Write a tab-delimited report with one section per statistic, each
+ * introduced by a line starting with '#' that names its columns: a summary
+ * per read, base composition and quality per 1-based cycle, and the
+ * length, block count and GC histograms. Sections on read2 are written for
+ * paired-end data only.
+ */
+void mrfQc_writeReport (MrfQc *qc, FILE *out)
+{
+  MrfQcReadStats *reads[2];
+  char *names[2];
+  int numReads,i;
+
+  mrfQc_flush (qc);
+  reads[0] = &qc->read1;
+  reads[1] = &qc->read2;
+  names[0] = "read1";
+  names[1] = "read2";
+  numReads = qc->pairedEntries > 0 ? 2 : 1;
+  fprintf (out,"#Entries\tPairedEntries\n%ld\t%ld\n",qc->entries,qc->pairedEntries);
+  fprintf (out,"#Read\tReads\tBases\tGC%%\tN%%\tMeanQuality\n");
+  for (i = 0; i < numReads; i++) {
+    fprintf (out,"%s\t%ld\t%ld\t%.2f\t%.2f\t%.2f\n",names[i],reads[i]->reads,reads[i]->bases,
+             qc_percent (reads[i]->gcBases,reads[i]->bases - reads[i]->nBases),
+             qc_percent (reads[i]->nBases,reads[i]->bases),
+             reads[i]->qualityBases > 0 ?
+             (double)reads[i]->qualitySum / reads[i]->qualityBases : 0.0);
+  }
+  fprintf (out,"#Read\tCycle\tA%%\tC%%\tG%%\tT%%\tN%%\tMeanQuality\tMedianQuality\n");
+  for (i = 0; i < numReads; i++) {
+    qc_writeCycles (out,names[i],reads[i]);
+  }
+  fprintf (out,"#Read\tLength\tReads\n");
+  for (i = 0; i < numReads; i++) {
+    qc_writeHistogram (out,names[i],reads[i]->lengthCounts);
+  }
+  fprintf (out,"#Read\tBlocks\tReads\n");
+  for (i = 0; i < numReads; i++) {
+    qc_writeHistogram (out,names[i],reads[i]->blockCounts);
+  }
+  fprintf (out,"#Read\tGC%%\tReads\n");
+  for (i = 0; i < numReads; i++) {
+    qc_writeHistogram (out,names[i],reads[i]->gcCounts);
+  }
+}
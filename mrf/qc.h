@@ -0,0 +1,77 @@
+/// @file qc.h
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Quality-control statistics of MRF reads.
+///
+/// Statistics are kept separately for read1 and read2: base composition
+/// and Phred+33 quality distribution per cycle, N and GC rates, and
+/// histograms of read length, block count and per-read GC content. Cycles
+/// are 0-based positions in the Sequence and QualityScores columns; reads
+/// without a Sequence column only contribute to the length and block
+/// histograms, with the length taken from the blocks. Accumulators are
+/// independent, so threads can fill one each and merge them at the end, as
+/// mrfQc_run() does.
+
+#ifndef DEF_MRF_QC_H
+#define DEF_MRF_QC_H
+
+#include <stdio.h>
+
+#include "mrf.h"
+
+#define MRF_QC_BASE_A 0
+#define MRF_QC_BASE_C 1
+#define MRF_QC_BASE_G 2
+#define MRF_QC_BASE_T 3
+#define MRF_QC_BASE_N 4   // any other character
+#define MRF_QC_NUM_BASES 5
+
+#define MRF_QC_NUM_QUALITIES 64   // Phred scores above 63 are counted as 63
+
+/// @struct MrfQcReadStats
+/// @brief Statistics of read1 or of read2.
+typedef struct {
+  long reads;
+  long bases;
+  long gcBases;
+  long nBases;
+  long qualityBases;
+  long qualitySum;
+  Array baseCounts;             // of long, MRF_QC_NUM_BASES per cycle
+  Array qualityCounts;          // of long, MRF_QC_NUM_QUALITIES per cycle
+  Array lengthCounts;           // of long, by read length
+  Array blockCounts;            // of long, by number of blocks
+  Array gcCounts;               // of long, by GC percentage of the read, 0 to 100
+  // Per-cycle byte counters, flushed into baseCounts, qualityCounts and
+  // qualitySum before they can overflow
+  Array pendingCounts;          // of unsigned char, MRF_QC_NUM_BASES rows
+  int pendingCycles;            // row length
+  Array pendingQualityCounts;   // of unsigned char, MRF_QC_NUM_QUALITIES per cycle
+  int pendingQualityCycles;
+  int pendingReads;
+  Array buffer;                 // of char, zero-padded copy of a sequence
+} MrfQcReadStats;
+
+/// @struct MrfQc
+/// @brief Statistics of a set of entries.
+typedef struct {
+  long entries;
+  long pairedEntries;
+  MrfQcReadStats read1;
+  MrfQcReadStats read2;
+} MrfQc;
+
+MrfQc* mrfQc_create (void);
+void mrfQc_destroy (MrfQc *qc);
+void mrfQc_addRead (MrfQcReadStats *stats, MrfRead *currRead);
+void mrfQc_addEntry (MrfQc *qc, MrfEntry *currEntry);
+void mrfQc_addEntries (MrfQc *qc, MrfEntry **entries, int numEntries);
+void mrfQc_flush (MrfQc *qc);
+void mrfQc_merge (MrfQc *qc, MrfQc *other);
+MrfQc* mrfQc_run (int numThreads);
+void mrfQc_writeReport (MrfQc *qc, FILE *out);
+
+#endif /* DEF_MRF_QC_H */
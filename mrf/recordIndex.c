@@ -0,0 +1,344 @@
+/// @file recordIndex.c
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Checkpoint index of the records of an MRF or SAM file.
+///
+/// Parsers are positioned by reading the file through a pipe that starts
+/// at a checkpoint: "tail -c +N" seeks directly on regular files, and MRF
+/// streams are prefixed with the header lines using "head -c".
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <sys/stat.h>
+
+#include <bios/log.h>
+#include <bios/format.h>
+#include <bios/linestream.h>
+#include <bios/common.h>
+
+#include "recordIndex.h"
+#include "mrf.h"
+#include "sam.h"
+
+#define RECORD_INDEX_MAGIC "RecordIndex"
+#define RECORD_INDEX_VERSION 2
+
+// A file has changed if its size or its modification time differs
+static void recordIndex_checkFile (RecordIndex *index, char *fileName)
+{
+  struct stat st;
+
+  if (stat (fileName,&st) != 0) {
+    die ("Unable to stat %s",fileName);
+  }
+  if ((long)st.st_size != index->fileSize || (long)st.st_mtim.tv_sec != index->fileMtime ||
+      (long)st.st_mtim.tv_nsec != index->fileMtimeNsec) {
+    die ("Record index does not match %s; rebuild it",fileName);
+  }
+}
+
+/**
+ * Index the records of an uncompressed MRF or SAM file.
+ * @param[in] fileName File name
+ * @param[in] format RECORD_INDEX_MRF or RECORD_INDEX_SAM
+ * @param[in] interval Records between checkpoints, e.g.
+ * RECORD_INDEX_DEFAULT_INTERVAL
+ * @post Use recordIndex_destroy to de-allocate the memory
+ */
+RecordIndex* recordIndex_build (char *fileName, int format, long interval)
+{
+  RecordIndex *index;
+  FILE *fp;
+  struct stat st;
+  char *line,*headerLine;
+  size_t size;
+  ssize_t length;
+  long offset,lineOffset;
+  int c1,c2;
+
+  if (interval < 1) {
+    die ("Invalid record index interval: %ld",interval);
+  }
+  if ((fp = fopen (fileName,"r")) == NULL) {
+    die ("Unable to open %s",fileName);
+  }
+  c1 = getc (fp);
+  c2 = getc (fp);
+  if (c1 == 0x1f && c2 == 0x8b) {
+    die ("Compressed files cannot be indexed: %s",fileName);
+  }
+  rewind (fp);
+  if (fstat (fileno (fp),&st) != 0) {
+    die ("Unable to stat %s",fileName);
+  }
+  AllocVar (index);
+  index->format = format;
+  index->fileMtime = (long)st.st_mtim.tv_sec;
+  index->fileMtimeNsec = (long)st.st_mtim.tv_nsec;
+  index->interval = interval;
+  index->offsets = arrayCreate (1000,long);
+  line = NULL;
+  size = 0;
+  headerLine = NULL;
+  offset = 0;
+  while ((length = getline (&line,&size,fp)) != -1) {
+    lineOffset = offset;
+    offset += length;
+    if (length > 0 && line[length - 1] == '\n') {
+      line[length - 1] = '\0';
+    }
+    // Same skip rules as mrf_nextEntry () and samParser_nextEntry (); the
+    // latter only skips header lines and dies on anything else that is not
+    // an alignment, so such lines are counted as records
+    if (format == RECORD_INDEX_MRF) {
+      if (headerLine == NULL) {
+        if (line[0] != '#') {
+          headerLine = hlr_strdup (line);
+          index->headerLength = offset;
+        }
+        continue;
+      }
+      if (line[0] == '\0' || line[0] == '#' || strEqual (line,headerLine)) {
+        continue;
+      }
+    }
+    else if (line[0] == '@') {
+      continue;
+    }
+    if (index->numRecords % interval == 0) {
+      array (index->offsets,arrayMax (index->offsets),long) = lineOffset;
+    }
+    index->numRecords++;
+  }
+  index->fileSize = offset;
+  fclose (fp);
+  free (line);
+  hlr_free (headerLine);
+  return index;
+}
+
+/**
+ * Write an index to a sidecar file.
+ */
+void recordIndex_write (RecordIndex *index, char *indexFileName)
+{
+  FILE *fp;
+  int i;
+
+  if ((fp = fopen (indexFileName,"w")) == NULL) {
+    die ("Unable to create %s",indexFileName);
+  }
+  fprintf (fp,"%s\t%d\t%s\t%ld\t%ld\t%ld\t%ld\t%ld\t%ld\n",RECORD_INDEX_MAGIC,
+           RECORD_INDEX_VERSION,index->format == RECORD_INDEX_MRF ? "MRF" : "SAM",
+           index->interval,index->numRecords,index->fileSize,index->fileMtime,
+           index->fileMtimeNsec,index->headerLength);
+  for (i = 0; i < arrayMax (index->offsets); i++) {
+    fprintf (fp,"%ld\n",arru (index->offsets,i,long));
+  }
+  if (fclose (fp) != 0) {
+    die ("Unable to write %s",indexFileName);
+  }
+}
+
+/**
+ * Read an index written by recordIndex_write().
+ * @post Use recordIndex_destroy to de-allocate the memory
+ */
+RecordIndex* recordIndex_read (char *indexFileName)
+{
+  RecordIndex *index;
+  LineStream ls;
+  Texta tokens;
+  char *line;
+
+  ls = ls_createFromFile (indexFileName);
+  line = ls_nextLine (ls);
+  if (line == NULL) {
+    die ("Empty record index: %s",indexFileName);
+  }
+  tokens = textFieldtokP (line,"\t");
+  if (arrayMax (tokens) != 9 || !strEqual (textItem (tokens,0),RECORD_INDEX_MAGIC) ||
+      atoi (textItem (tokens,1)) != RECORD_INDEX_VERSION) {
+    die ("Invalid record index: %s",indexFileName);
+  }
+  AllocVar (index);
+  index->format = strEqual (textItem (tokens,2),"MRF") ? RECORD_INDEX_MRF : RECORD_INDEX_SAM;
+  index->interval = atol (textItem (tokens,3));
+  index->numRecords = atol (textItem (tokens,4));
+  index->fileSize = atol (textItem (tokens,5));
+  index->fileMtime = atol (textItem (tokens,6));
+  index->fileMtimeNsec = atol (textItem (tokens,7));
+  index->headerLength = atol (textItem (tokens,8));
+  textDestroy (tokens);
+  index->offsets = arrayCreate (1000,long);
+  while (line = ls_nextLine (ls)) {
+    array (index->offsets,arrayMax (index->offsets),long) = atol (line);
+  }
+  ls_destroy (ls);
+  if (index->interval < 1 ||
+      arrayMax (index->offsets) != (index->numRecords + index->interval - 1) / index->interval) {
+    die ("Invalid record index: %s",indexFileName);
+  }
+  return index;
+}
+
+/**
+ * Deallocate an index.
+ */
+void recordIndex_destroy (RecordIndex *index)
+{
+  if (index == NULL) {
+    return;
+  }
+  arrayDestroy (index->offsets);
+  freeMem (index);
+}
+
+static void recordIndex_appendQuoted (Stringa buffer, char *word)
+{
+  stringCatChar (buffer,'\'');
+  while (*word != '\0') {
+    if (*word == '\'') {
+      stringCat (buffer,"'\\''");
+    }
+    else {
+      stringCatChar (buffer,*word);
+    }
+    word++;
+  }
+  stringCatChar (buffer,'\'');
+}
+
+/**
+ * Returns a shell command that writes the file from the checkpoint at or
+ * before a record; MRF output starts with the header lines.
+ * @param[in] index Index of fileName
+ * @param[in] fileName Indexed file
+ * @param[in] record 0-based record number, at most index->numRecords
+ * @param[out] numSkipped Receives the number of records between the
+ * checkpoint and record
+ * @note The memory belongs to this routine.
+ */
+char* recordIndex_getSeekCommand (RecordIndex *index, char *fileName, long record,
+                                  long *numSkipped)
+{
+  static Stringa buffer = NULL;
+  long checkpoint,offset;
+
+  recordIndex_checkFile (index,fileName);
+  if (record < 0 || record > index->numRecords) {
+    die ("Record %ld is out of range (%ld records)",record,index->numRecords);
+  }
+  checkpoint = record / index->interval;
+  if (checkpoint < arrayMax (index->offsets)) {
+    offset = arru (index->offsets,checkpoint,long);
+  }
+  else {
+    // record == numRecords at a multiple of interval: nothing left to read
+    offset = index->fileSize;
+  }
+  *numSkipped = record - checkpoint * index->interval;
+  stringCreateClear (buffer,200);
+  if (index->format == RECORD_INDEX_MRF) {
+    stringAppendf (buffer,"(head -c %ld ",index->headerLength);
+    recordIndex_appendQuoted (buffer,fileName);
+    stringCat (buffer,"; ");
+  }
+  stringAppendf (buffer,"tail -c +%ld ",offset + 1);
+  recordIndex_appendQuoted (buffer,fileName);
+  if (index->format == RECORD_INDEX_MRF) {
+    stringCatChar (buffer,')');
+  }
+  return string (buffer);
+}
+
+/**
+ * Initialize the MRF parser so that the next entry is a given record.
+ * @param[in] index Index of fileName
+ * @param[in] fileName Indexed MRF file
+ * @param[in] record 0-based record number
+ * @param[in] columns See mrf_initWithColumns()
+ */
+void recordIndex_initMrf (RecordIndex *index, char *fileName, long record, int columns)
+{
+  long numSkipped;
+  char *command;
+
+  if (index->format != RECORD_INDEX_MRF) {
+    die ("Not an MRF record index");
+  }
+  command = recordIndex_getSeekCommand (index,fileName,record,&numSkipped);
+  mrf_initFromPipeWithColumns (command,columns);
+  while (numSkipped-- > 0) {
+    if (mrf_nextEntry () == NULL) {
+      die ("Unexpected end of %s",fileName);
+    }
+  }
+}
+
+/**
+ * Initialize the SAM parser so that the next entry is a given record; the
+ * parser has no filter, so skipped records are counted as in the index.
+ * @param[in] index Index of fileName
+ * @param[in] fileName Indexed SAM file
+ * @param[in] record 0-based record number
+ */
+void recordIndex_initSam (RecordIndex *index, char *fileName, long record)
+{
+  long numSkipped;
+  char *command;
+
+  if (index->format != RECORD_INDEX_SAM) {
+    die ("Not a SAM record index");
+  }
+  command = recordIndex_getSeekCommand (index,fileName,record,&numSkipped);
+  samParser_initFromPipe (command);
+  while (numSkipped-- > 0) {
+    if (samParser_nextEntry () == NULL) {
+      die ("Unexpected end of %s",fileName);
+    }
+  }
+}
+
+/**
+ * Split the records into up to numPartitions ranges of about equal size
+ * that start at checkpoints, so that no records need to be skipped.
+ * @return Array of RecordPartition; fewer than numPartitions if there are
+ * fewer checkpoints
+ * @post Use arrayDestroy to de-allocate the memory
+ */
+Array recordIndex_partition (RecordIndex *index, int numPartitions)
+{
+  Array partitions;
+  RecordPartition *currPartition;
+  long checkpoint,prevCheckpoint;
+  int i;
+
+  partitions = arrayCreate (numPartitions,RecordPartition);
+  prevCheckpoint = -1;
+  for (i = 0; i < numPartitions && arrayMax (index->offsets) > 0; i++) {
+    checkpoint = ((double)i * index->numRecords / numPartitions + index->interval / 2) /
+      index->interval;
+    if (checkpoint >= arrayMax (index->offsets)) {
+      checkpoint = arrayMax (index->offsets) - 1;
+    }
+    if (checkpoint <= prevCheckpoint) {
+      continue;
+    }
+    currPartition = arrayp (partitions,arrayMax (partitions),RecordPartition);
+    currPartition->firstRecord = checkpoint * index->interval;
+    currPartition->offset = arru (index->offsets,checkpoint,long);
+    prevCheckpoint = checkpoint;
+  }
+  for (i = 0; i < arrayMax (partitions); i++) {
+    currPartition = arrp (partitions,i,RecordPartition);
+    currPartition->numRecords = (i + 1 < arrayMax (partitions) ?
+                                 arrp (partitions,i + 1,RecordPartition)->firstRecord :
+                                 index->numRecords) - currPartition->firstRecord;
+  }
+  return partitions;
+}
@@ -0,0 +1,61 @@
+/// @file recordIndex.h
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Checkpoint index of the records of an MRF or SAM file.
+///
+/// The index holds the byte offset of every interval-th record, counted
+/// with the same rules the parsers use: MRF comment, header and empty lines
+/// and SAM header lines are skipped. It supports starting the MRF or SAM
+/// parser at any record and splitting a file into balanced partitions that
+/// start at checkpoints. Indexes are kept in a small text sidecar file,
+/// e.g. <file>.ridx. Only uncompressed files can be indexed, and an index
+/// is rejected once the size or modification time of its file has changed.
+/// Record numbers count every alignment of a SAM file, so the SAM parser
+/// is started without a filter; set one with samParser_setFilter() after
+/// recordIndex_initSam().
+
+#ifndef DEF_RECORD_INDEX_H
+#define DEF_RECORD_INDEX_H
+
+#include <bios/format.h>
+
+#define RECORD_INDEX_MRF 1
+#define RECORD_INDEX_SAM 2
+
+#define RECORD_INDEX_DEFAULT_INTERVAL 100000
+
+/// @struct RecordIndex
+/// @brief Offsets of every interval-th record of a file.
+typedef struct {
+  int format;          // RECORD_INDEX_MRF or RECORD_INDEX_SAM
+  long interval;
+  long numRecords;
+  long fileSize;       // size and modification time detect a changed file
+  long fileMtime;
+  long fileMtimeNsec;
+  long headerLength;   // bytes of MRF comment and header lines
+  Array offsets;       // of long, offset of record i * interval
+} RecordIndex;
+
+/// @struct RecordPartition
+/// @brief A range of records starting at a checkpoint.
+typedef struct {
+  long firstRecord;
+  long numRecords;
+  long offset;
+} RecordPartition;
+
+RecordIndex* recordIndex_build (char *fileName, int format, long interval);
+void recordIndex_write (RecordIndex *index, char *indexFileName);
+RecordIndex* recordIndex_read (char *indexFileName);
+void recordIndex_destroy (RecordIndex *index);
+char* recordIndex_getSeekCommand (RecordIndex *index, char *fileName, long record,
+                                  long *numSkipped);
+void recordIndex_initMrf (RecordIndex *index, char *fileName, long record, int columns);
+void recordIndex_initSam (RecordIndex *index, char *fileName, long record);
+Array recordIndex_partition (RecordIndex *index, int numPartitions);
+
+#endif /* DEF_RECORD_INDEX_H */
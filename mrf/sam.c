@@ -12,8 +12,24 @@
 #include <bios/common.h>
 
 #include "sam.h"
+#include "tokenizer.h"
+#include "targetDict.h"
+#include "statsUtil.h"
+
+// Results of samParser_checkFilter () other than a SAM_SKIP_* reason
+#define SAM_FILTER_KEEP -1
+#define SAM_FILTER_MALFORMED -2
 
 static LineStream ls = NULL;
+static MrfStats samStats;
+static SamEntry samEntry;   // Reused for every line read
+static int hasFilter = 0;
+static SamFilter samFilter;
+static TargetDict *filterTargets = NULL;
+static long skipCounts[SAM_SKIP_NUM_REASONS];
+static char *skipReasons[SAM_SKIP_NUM_REASONS] = {
+  "requiredFlags","unmapped","notPrimary","failsChecks","duplicate","otherFlags","mapq","target"
+};
 
 int sortSamEntriesByQname (SamEntry *a, SamEntry *b)
 {
@@ -41,46 +57,96 @@ void destroySamEArray (Array a)
   int i;
   for (i = 0; i < arrayMax(a); i++) {
     SamEntry *currSamE = arrp (a, i, SamEntry);
-    free (currSamE->qname);
-    free (currSamE->rname);
-    free (currSamE->cigar);
-    free (currSamE->mrnm);
-    if (currSamE->seq)
-      free (currSamE->seq);
-    if (currSamE->qual)
-      free (currSamE->qual);
-    if (currSamE->tags)
-      free (currSamE->tags);
+    hlr_free (currSamE->data);
   }
   arrayDestroy (a);
 }
 
 /**
- * Initialize the SAM module from file.
+ * Initialize the SAM module from file; any filter is removed.
  * @param[in] fileName File name, use "-" to denote stdin
  */
 void samParser_initFromFile (char *fileName)
 {
   ls = ls_createFromFile (fileName);
   ls_bufferSet (ls,1);
+  samParser_resetStats ();
+  samParser_setFilter (NULL);
+  memset (skipCounts,0,sizeof (skipCounts));
 }
 
 /**
- * Initialize the samParser module from pipe.
+ * Initialize the samParser module from pipe; any filter is removed.
  * @param[in] command Command to be executed
  */
 void samParser_initFromPipe (char *command)
 {
   ls = ls_createFromPipe (command);
   ls_bufferSet (ls,1);
+  samParser_resetStats ();
+  samParser_setFilter (NULL);
+  memset (skipCounts,0,sizeof (skipCounts));
 }
 
 /**
- * Deinitialize the samParser module.
+ * Deinitialize the samParser module; this also removes the filter.
  */
 void samParser_deInit (void)
 {
   ls_destroy (ls);
+  hlr_free (samEntry.data);
+  memset (&samEntry,0,sizeof (SamEntry));
+  samParser_setFilter (NULL);
+}
+
+/**
+ * Skip alignments that do not pass a filter in samParser_nextEntry() and
+ * samParser_getAllEntries(); samParser_parseLine() is not affected.
+ * @pre The module has been initialized; initializing it again removes the
+ * filter.
+ * @param[in] filter Filter, which is copied, or NULL to return all
+ * alignments
+ */
+void samParser_setFilter (SamFilter *filter)
+{
+  int i;
+
+  targetDict_destroy (filterTargets);
+  filterTargets = NULL;
+  hasFilter = filter != NULL;
+  if (filter == NULL) {
+    return;
+  }
+  samFilter = *filter;
+  samFilter.targetNames = NULL;
+  if (filter->targetNames != NULL) {
+    filterTargets = targetDict_create ();
+    for (i = 0; i < arrayMax (filter->targetNames); i++) {
+      targetDict_getId (filterTargets,textItem (filter->targetNames,i));
+    }
+  }
+}
+
+/**
+ * Copy the number of alignments skipped for each reason since the module
+ * was initialized.
+ * @param[out] counts SAM_SKIP_NUM_REASONS counts, indexed by SAM_SKIP_*
+ */
+void samParser_getSkipCounts (long *counts)
+{
+  memcpy (counts,skipCounts,sizeof (skipCounts));
+}
+
+/**
+ * Returns a short name of a SAM_SKIP_* reason, e.g. for reports, or NULL
+ * if reason is not one of them.
+ */
+char* samParser_getSkipReason (int reason)
+{
+  if (reason < 0 || reason >= SAM_SKIP_NUM_REASONS) {
+    return NULL;
+  }
+  return skipReasons[reason];
 }
 
 /**
@@ -90,40 +156,60 @@ void samParser_freeEntry (SamEntry *currSamEntry)
 {
   if (currSamEntry == NULL) 
     return;
-  hlr_free (currSamEntry->qname);
-  hlr_free (currSamEntry->rname);
-  hlr_free (currSamEntry->cigar);
-  hlr_free (currSamEntry->mrnm);
-  if (currSamEntry->seq)
-    hlr_free (currSamEntry->seq);
-  if (currSamEntry->qual)
-    hlr_free (currSamEntry->qual);
-  if (currSamEntry->tags)
-    hlr_free (currSamEntry->tags);
+  hlr_free (currSamEntry->data);
   freeMem (currSamEntry);
 }
 
+// Make room for size bytes of packed strings; the contents are not kept
+static void samParser_reserve (SamEntry *currSamEntry, int size)
+{
+  if (size <= currSamEntry->dataCapacity)
+    return;
+  hlr_free (currSamEntry->data);
+  currSamEntry->dataCapacity = size < 2 * currSamEntry->dataCapacity ?
+    2 * currSamEntry->dataCapacity : size;
+  currSamEntry->data = hlr_malloc (currSamEntry->dataCapacity);
+}
+
+static char* samParser_rebase (char *s, SamEntry *orig, char *data)
+{
+  return s == NULL ? NULL : data + (s - orig->data);
+}
+
+// Copy orig into dest, reusing the buffer of dest if it is large enough
+static void samParser_copyData (SamEntry *dest, SamEntry *orig)
+{
+  char *data;
+  int capacity;
+
+  dest->dataCapacity = dest->data != NULL ? dest->dataCapacity : 0;
+  samParser_reserve (dest,orig->dataLength);
+  data = dest->data;
+  capacity = dest->dataCapacity;
+  *dest = *orig;
+  dest->data = data;
+  dest->dataCapacity = capacity;
+  memcpy (data,orig->data,orig->dataLength);
+  dest->qname = samParser_rebase (orig->qname,orig,data);
+  dest->rname = samParser_rebase (orig->rname,orig,data);
+  dest->cigar = samParser_rebase (orig->cigar,orig,data);
+  dest->mrnm  = samParser_rebase (orig->mrnm,orig,data);
+  dest->seq   = samParser_rebase (orig->seq,orig,data);
+  dest->qual  = samParser_rebase (orig->qual,orig,data);
+  dest->tags  = samParser_rebase (orig->tags,orig,data);
+}
+
 /**
  * Make a copy of a SamEntry.
- * @pre *dest
+ * @param[in,out] dest NULL or an entry from a previous copy, whose buffer
+ * is reused
  * @post Use samParser_freeEntry to de-allocate the memory
  */
 void samParser_copyEntry (SamEntry **dest, SamEntry *orig) 
 {
-  if( *dest ) freeMem(*dest);
-  AllocVar (*dest); 
-  (*dest)->qname = hlr_strdup(orig->qname);
-  (*dest)->flags = orig->flags;
-  (*dest)->rname = hlr_strdup(orig->rname);
-  (*dest)->pos   = orig->pos;
-  (*dest)->mapq  = orig->mapq;
-  (*dest)->cigar = hlr_strdup(orig->cigar);
-  (*dest)->mrnm  = hlr_strdup(orig->mrnm);
-  (*dest)->mpos  = orig->mpos;
-  (*dest)->isize = orig->isize;
-  (*dest)->seq   = orig->seq != NULL ? hlr_strdup(orig->seq) : NULL;
-  (*dest)->qual  = orig->qual != NULL ? hlr_strdup(orig->qual) : NULL;
-  (*dest)->tags  = orig->tags != NULL ? hlr_strdup(orig->tags) : NULL;
+  if (*dest == NULL)
+    AllocVar (*dest);
+  samParser_copyData (*dest,orig);
 }
 
 int isMateUnmapped( SamEntry* samE ) 
@@ -159,91 +245,185 @@ int isValidSamLine( Texta tokens ) {
   } else return 1;
 }
 
-static void samParser_processLine (char* line, SamEntry* currSamEntry) 
+// Parse a line whose first numTabs field ends are already in tabs
+static void samParser_processFields (char* line, char **tabs, int numTabs,
+                                     SamEntry* currSamEntry)
 {
-  Texta tokens = NULL;
+  char *fields[11];
+  int hasTags;
+  int length;
   int j;
-  int hasQual = 0;
-  int hasSeqs = 0;
-  tokens = textFieldtokP (line, "\t");
-  if( isValidSamLine( tokens ) != 1 ) {
-    ls_destroy (ls);
-    die ("Invalid SAM entry: %s", line);
+
+  // The line is copied once; its fields become the packed strings
+  length = strlen (line) + 1;
+  if (length > currSamEntry->dataCapacity) {
+    samParser_reserve (currSamEntry,length);
+    STATS_ADD (samStats,bytesAllocated,currSamEntry->dataCapacity);
   }
- 
-  currSamEntry->qname = hlr_strdup(textItem(tokens, 0));
-  currSamEntry->flags = atoi(textItem(tokens, 1));
-  currSamEntry->rname = hlr_strdup(textItem(tokens, 2));
-  currSamEntry->pos   = atoi(textItem(tokens, 3));
-  currSamEntry->mapq  = atoi(textItem(tokens, 4));
-  currSamEntry->cigar = hlr_strdup(textItem(tokens, 5));
-  currSamEntry->mrnm  = hlr_strdup(textItem(tokens, 6));
-  currSamEntry->mpos  = atoi(textItem(tokens, 7));
-  currSamEntry->isize = atoi(textItem(tokens, 8));
-  currSamEntry->seq   = NULL;
-  currSamEntry->qual  = NULL;
-  currSamEntry->tags  = NULL;
-  // Get tokens
-  if (arrayMax (tokens) > 11) {
-    Stringa tags = stringCreate (10);
-    for (j = 11; j < arrayMax (tokens); j++) {
-      if (j > 11)
-	stringAppendf (tags, "\t");
-      stringAppendf (tags, "%s", textItem (tokens, j));
+  memcpy (currSamEntry->data,line,length);
+  currSamEntry->dataLength = length;
+  for (j = 0; j < numTabs; j++) {
+    tabs[j] = currSamEntry->data + (tabs[j] - line);
+  }
+  line = currSamEntry->data;
+  // Locate the 11 mandatory fields before cutting, so errors show the whole line
+  fields[0] = line;
+  for (j = 0; j < 11; j++) {
+    if (j >= numTabs) {
+      tabs[j] = tokenizer_find (fields[j],TOKENIZER_TAB);
+    }
+    if (j < 10) {
+      if (*tabs[j] == '\0') {
+        if (ls != NULL)
+          ls_destroy (ls);
+        die ("Invalid SAM entry: %s", line);
+      }
+      fields[j + 1] = tabs[j] + 1;
     }
-    currSamEntry->tags = hlr_strdup (string(tags));
-    stringDestroy (tags);
   }
-  
-  if (strcmp (textItem (tokens, 9),  "*") != 0) {
-    hasSeqs = 1;
-    currSamEntry->seq = hlr_strdup (textItem (tokens, 9));
+  hasTags = *tabs[10] == '\t';
+  for (j = 0; j < 11; j++) {
+    *tabs[j] = '\0';
   }
-  if (strcmp (textItem (tokens, 10), "*") != 0) {
-    hasQual = 1;
-    currSamEntry->qual = hlr_strdup (textItem (tokens, 10));
-  } 
-  textDestroy( tokens );
+ 
+  currSamEntry->qname = fields[0];
+  currSamEntry->flags = tokenizer_parseInt(fields[1], NULL);
+  currSamEntry->rname = fields[2];
+  currSamEntry->pos   = tokenizer_parseInt(fields[3], NULL);
+  currSamEntry->mapq  = tokenizer_parseInt(fields[4], NULL);
+  currSamEntry->cigar = fields[5];
+  currSamEntry->mrnm  = fields[6];
+  currSamEntry->mpos  = tokenizer_parseInt(fields[7], NULL);
+  currSamEntry->isize = tokenizer_parseInt(fields[8], NULL);
+  currSamEntry->seq   = strcmp (fields[9], "*") != 0 ? fields[9] : NULL;
+  currSamEntry->qual  = strcmp (fields[10], "*") != 0 ? fields[10] : NULL;
+  // The optional fields are kept as the rest of the line
+  currSamEntry->tags  = hasTags ? tabs[10] + 1 : NULL;
 }
 
+static void samParser_processLine (char* line, SamEntry* currSamEntry)
+{
+  char *tabs[11];
+
+  samParser_processFields (line,tabs,0,currSamEntry);
+}
+
+
+// Returns the reason to skip an alignment line, SAM_FILTER_KEEP to parse
+// it or SAM_FILTER_MALFORMED if it has fewer than five fields; only the
+// fields up to MAPQ are located, and for a kept line their ends are
+// stored in tabs
+static int samParser_checkFilter (char *line, char **tabs)
+{
+  char *fields[5];
+  char *tab;
+  int flags,excluded,id,j;
+
+  fields[0] = line;
+  for (j = 0; j < 4; j++) {
+    tabs[j] = tokenizer_find (fields[j],TOKENIZER_TAB);
+    if (*tabs[j] == '\0') {
+      // Left to samParser_processFields () to report
+      return SAM_FILTER_MALFORMED;
+    }
+    fields[j + 1] = tabs[j] + 1;
+  }
+  flags = tokenizer_parseInt (fields[1],NULL);
+  if ((flags & samFilter.requiredFlags) != samFilter.requiredFlags) {
+    return SAM_SKIP_REQUIRED_FLAGS;
+  }
+  excluded = flags & samFilter.excludedFlags;
+  if (excluded != 0) {
+    if (excluded & S_QUERY_UNMAPPED) {
+      return SAM_SKIP_UNMAPPED;
+    }
+    if (excluded & S_NOT_PRIMARY) {
+      return SAM_SKIP_NOT_PRIMARY;
+    }
+    if (excluded & S_FAILS_CHECKS) {
+      return SAM_SKIP_FAILS_CHECKS;
+    }
+    if (excluded & S_DUPLICATE) {
+      return SAM_SKIP_DUPLICATE;
+    }
+    return SAM_SKIP_OTHER_FLAGS;
+  }
+  if (tokenizer_parseInt (fields[4],NULL) < samFilter.minMapq) {
+    return SAM_SKIP_MAPQ;
+  }
+  if (filterTargets != NULL) {
+    // RNAME is terminated in place for the lookup
+    tab = fields[3] - 1;
+    *tab = '\0';
+    id = targetDict_lookup (filterTargets,fields[2]);
+    *tab = '\t';
+    if (id < 0) {
+      return SAM_SKIP_TARGET;
+    }
+  }
+  return SAM_FILTER_KEEP;
+}
 
-static SamEntry* samParser_processNextEntry (int freeMemory)
+static SamEntry* samParser_processNextEntry (void)
 {
-  char *line,*pos;
-  //char *queryName = NULL;
-  //char *prevSamEntryName = NULL;
-  static SamEntry *currSamEntry = NULL;
+  char *tabs[11];
+  char *line;
+  int reason,numTabs;
+  STATS_TIMER (t);
 
   if (!ls_isEof (ls)) {
-    if (freeMemory) {
-      samParser_freeEntry (currSamEntry);
-      currSamEntry = NULL;
-    }
-    AllocVar (currSamEntry);
-    
+    STATS_TIMER_START (t);
     while (line = ls_nextLine (ls)) {
+      STATS_TIMER_STOP (samStats,nsRead,t);
+      STATS_ADD (samStats,lines,1);
+      STATS_ADD (samStats,bytesRead,strlen (line) + 1);
+      STATS_TIMER_START (t);
       if (line[0] == '@') {
+        STATS_ADD (samStats,headerLines,1);
 	continue;
       }
-      samParser_processLine (line,currSamEntry); 
-      return currSamEntry;
+      numTabs = 0;
+      if (hasFilter) {
+        reason = samParser_checkFilter (line,tabs);
+        if (reason >= 0) {
+          skipCounts[reason]++;
+          continue;
+        }
+        // A malformed line is scanned again, so it is reported in full
+        numTabs = reason == SAM_FILTER_KEEP ? 4 : 0;
+      }
+      samParser_processFields (line,tabs,numTabs,&samEntry);
+      STATS_ADD (samStats,entries,1);
+      STATS_ADD (samStats,pairedEntries,(samEntry.flags & S_READ_PAIRED) != 0);
+      STATS_ADD (samStats,singleEntries,(samEntry.flags & S_READ_PAIRED) == 0);
+      STATS_TIMER_STOP (samStats,nsParse,t);
+      return &samEntry;
     }
-  }
-  if (freeMemory) {
-    samParser_freeEntry (currSamEntry);
-    currSamEntry = NULL;
+    STATS_TIMER_STOP (samStats,nsRead,t);
   }
   return NULL;  
 }
 
+/**
+ * Parse a SAM alignment line, e.g. of a file read by another module.
+ * @param[in] line Alignment line; it is not modified
+ * @param[in,out] currSamEntry Zero-initialized or previously parsed entry,
+ * whose buffer is reused
+ */
+void samParser_parseLine (char *line, SamEntry *currSamEntry)
+{
+  samParser_processLine (line,currSamEntry);
+}
+
 /**
  * Read next SAM entry
- * @pre *dest
- * @post Use samParser_freeEntry to de-allocate the memory
+ * @pre The module has been initialized using samParser_init().
+ * @note The memory belongs to this routine and is overwritten by the next
+ * call; use samParser_copyEntry to keep an entry.
  */
 SamEntry* samParser_nextEntry (void)
 {
-  return samParser_processNextEntry (1);
+  return samParser_processNextEntry ();
 }
 
 /**
@@ -252,6 +432,9 @@ SamEntry* samParser_nextEntry (void)
  */
 char* samParser_writeEntry( SamEntry* currSamEntry) {
   static Stringa buffer = NULL;
+  STATS_TIMER (t);
+
+  STATS_TIMER_START (t);
   stringCreateClear (buffer,200);
   stringAppendf(buffer, "%s\t%d\t%s\t%d\t%d\t%s\t%s\t%d\t%d\t%s\t%s\t%s", 
 		currSamEntry->qname,
@@ -266,9 +449,31 @@ char* samParser_writeEntry( SamEntry* currSamEntry) {
 		currSamEntry->seq,
 		currSamEntry->qual,
 		currSamEntry->tags);
+  STATS_ADD (samStats,entriesWritten,1);
+  STATS_ADD (samStats,bytesWritten,stringLen (buffer));
+  STATS_TIMER_STOP (samStats,nsWrite,t);
   return string (buffer);
 }
 
+/**
+ * Copy the instrumentation counters of the SAM reader and writer.
+ * @note All counters are zero unless libmrf was configured with --enable-stats
+ * and counting has been switched on with mrfStats_setEnabled().
+ */
+void samParser_getStats (MrfStats *stats)
+{
+  *stats = samStats;
+}
+
+/**
+ * Reset the instrumentation counters; the samParser_init functions do this
+ * implicitly.
+ */
+void samParser_resetStats (void)
+{
+  memset (&samStats,0,sizeof (MrfStats));
+}
+
 /**
  * Returns an Array of SamEntries.
  * @note The memory belongs to this routine.
@@ -276,12 +481,14 @@ char* samParser_writeEntry( SamEntry* currSamEntry) {
 Array samParser_getAllEntries ()
 {
   Array samQueries;
-  SamEntry *currSamEntry;
+  SamEntry *currSamEntry,*newSamEntry;
 
   samQueries = arrayCreate (100000,SamEntry);
-  while (currSamEntry = samParser_processNextEntry (0)) {
-    array (samQueries,arrayMax (samQueries),SamEntry) = *currSamEntry;
-    freeMem (currSamEntry);
+  while (currSamEntry = samParser_processNextEntry ()) {
+    // Each copy owns an exactly sized buffer
+    newSamEntry = arrayp (samQueries,arrayMax (samQueries),SamEntry);
+    newSamEntry->data = NULL;
+    samParser_copyData (newSamEntry,currSamEntry);
   }
   return samQueries;
 }
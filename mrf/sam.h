@@ -54,6 +54,9 @@ typedef struct {
 
 /// @struct SamEntry
 /// @brief Structure representing a SAM entry.
+/// The strings are packed into one buffer, data, and point into it, so an
+/// entry owns a single allocation that is reused when the entry is
+/// overwritten.
 typedef struct {
   char *qname;        // Query name
   int flags;          // Bitwise FLAGS field
@@ -67,8 +70,36 @@ typedef struct {
   char *seq;          // Query sequence
   char *qual;         // Query quality string
   char *tags;         // Optional tags (actually list, but as string for now)
+  char *data;         // Packed strings
+  int dataLength;     // Bytes of data in use
+  int dataCapacity;   // Bytes allocated for data
 } SamEntry;
 
+/// @struct SamFilter
+/// @brief Alignments to return from samParser_nextEntry() and
+/// samParser_getAllEntries(). Other alignments are skipped using only their
+/// FLAG, RNAME and MAPQ fields, before the line is copied or split. A
+/// filter is set with samParser_setFilter() after the parser is
+/// initialized and lasts until it is initialized again or deinitialized.
+typedef struct {
+  int requiredFlags;   // FLAG bits that must all be set
+  int excludedFlags;   // FLAG bits none of which may be set
+  int minMapq;
+  Texta targetNames;   // RNAMEs to keep, or NULL to keep all
+} SamFilter;
+
+// Reasons for skipping an alignment; an alignment is counted under the
+// first reason that applies
+#define SAM_SKIP_REQUIRED_FLAGS 0   // A required flag is not set
+#define SAM_SKIP_UNMAPPED       1   // S_QUERY_UNMAPPED is excluded and set
+#define SAM_SKIP_NOT_PRIMARY    2   // S_NOT_PRIMARY is excluded and set
+#define SAM_SKIP_FAILS_CHECKS   3   // S_FAILS_CHECKS is excluded and set
+#define SAM_SKIP_DUPLICATE      4   // S_DUPLICATE is excluded and set
+#define SAM_SKIP_OTHER_FLAGS    5   // Another excluded flag is set
+#define SAM_SKIP_MAPQ           6   // MAPQ is below minMapq
+#define SAM_SKIP_TARGET         7   // RNAME is not one of targetNames
+#define SAM_SKIP_NUM_REASONS    8
+
 int sortSamEntriesByQname(SamEntry *a, SamEntry *b);
 Stringa genCigar(MrfRead *read);
 void destroySamEArray(Array a);
@@ -79,6 +110,10 @@ void samParser_deInit(void);
 void samParser_copyEntry(SamEntry **dest, SamEntry *orig);
 void samParser_freeEntry(SamEntry *currEntry);
 SamEntry* samParser_nextEntry(void);
+void samParser_setFilter(SamFilter *filter);
+void samParser_getSkipCounts(long *counts);
+char* samParser_getSkipReason(int reason);
+void samParser_parseLine(char* line, SamEntry *currSamEntry);
 char* samParser_writeEntry(SamEntry* currSamEntry);
 Array samParser_getAllEntries();
 Array samParser_getCigar(char* cigar_string);
@@ -9,11 +9,7 @@
 #ifndef DEF_SEGMENTATION_UTIL_H
 #define DEF_SEGMENTATION_UTIL_H
 
-typedef struct {
-  char* targetName;
-  int start;
-  int end;
-} Tar;
+#include "mrfUtil.h"
 
 typedef struct {
   int position;
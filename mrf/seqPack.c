@@ -0,0 +1,244 @@
+/// @file seqPack.c
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Compact representations of read sequences and quality scores. The base
+/// packing kernels process 16 bases per step with SSE2 where available and
+/// fall back to scalar code otherwise.
+
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "seqPack.h"
+
+#define SEQ_PACK_INVALID 4
+
+// Phred+33 representatives of the quality bins
+static const char binQualities[SEQ_PACK_NUM_QUALITY_BINS] = {
+  33 + 2, 33 + 6, 33 + 15, 33 + 22, 33 + 27, 33 + 33, 33 + 37, 33 + 40
+};
+
+// Bin of every Phred+33 character: qualities 0-2, 3-9, 10-19, 20-24, 25-29,
+// 30-34, 35-39 and 40+
+static const unsigned char qualityBins[256] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2,
+  2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 5,
+  5, 5, 5, 5, 6, 6, 6, 6, 6, 7, 7, 7, 7, 7, 7, 7,
+  7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+  7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+  7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+  7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+  7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+  7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+  7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+  7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+  7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+  7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+  7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7
+};
+
+static int seqPack_baseCode (char base)
+{
+  switch (base) {
+  case 'A': case 'a':
+    return 0;
+  case 'C': case 'c':
+    return 1;
+  case 'G': case 'g':
+    return 2;
+  case 'T': case 't':
+    return 3;
+  default:
+    return SEQ_PACK_INVALID;
+  }
+}
+
+// Pack up to 4 bases into one byte; appends exceptions, returns their new count
+static int seqPack_packScalar (char *sequence, int start, int end,
+                               unsigned char *packed, int *exceptions, int numExceptions)
+{
+  int i,code;
+
+  for (i = start; i < end; i++) {
+    if ((i & 3) == 0) {
+      packed[i >> 2] = 0;
+    }
+    code = seqPack_baseCode (sequence[i]);
+    if (code == SEQ_PACK_INVALID) {
+      exceptions[numExceptions++] = i;
+      code = 0;
+    }
+    packed[i >> 2] |= (unsigned char)(code << ((i & 3) * 2));
+  }
+  return numExceptions;
+}
+
+/**
+ * Pack a sequence at 2 bits per base.
+ * @param[in] sequence Bases, need not be NUL-terminated
+ * @param[in] length Number of bases
+ * @param[out] packed Buffer of at least seqPack_packedSize (length) bytes
+ * @param[out] exceptions Buffer of at least length ints; receives the
+ * positions of symbols other than A, C, G and T in increasing order
+ * @return Number of exceptions
+ */
+int seqPack_pack (char *sequence, int length, unsigned char *packed, int *exceptions)
+{
+  int numExceptions;
+  int i;
+#ifdef __SSE2__
+  __m128i v,up,isA,isC,isG,isT,code,x;
+  unsigned int invalid;
+  int word;
+  const __m128i caseMask = _mm_set1_epi8 ((char)0xDF);
+  const __m128i charA = _mm_set1_epi8 ('A');
+  const __m128i charC = _mm_set1_epi8 ('C');
+  const __m128i charG = _mm_set1_epi8 ('G');
+  const __m128i charT = _mm_set1_epi8 ('T');
+  const __m128i one = _mm_set1_epi8 (1);
+  const __m128i two = _mm_set1_epi8 (2);
+  const __m128i three = _mm_set1_epi8 (3);
+  const __m128i lowNibble = _mm_set1_epi16 (0x000F);
+  const __m128i lowByte = _mm_set1_epi32 (0x000000FF);
+#endif
+
+  numExceptions = 0;
+  i = 0;
+#ifdef __SSE2__
+  for (; i + 16 <= length; i += 16) {
+    v = _mm_loadu_si128 ((const __m128i*)(sequence + i));
+    up = _mm_and_si128 (v,caseMask);
+    isA = _mm_cmpeq_epi8 (up,charA);
+    isC = _mm_cmpeq_epi8 (up,charC);
+    isG = _mm_cmpeq_epi8 (up,charG);
+    isT = _mm_cmpeq_epi8 (up,charT);
+    code = _mm_or_si128 (_mm_and_si128 (isC,one),
+                         _mm_or_si128 (_mm_and_si128 (isG,two),_mm_and_si128 (isT,three)));
+    invalid = ~_mm_movemask_epi8 (_mm_or_si128 (_mm_or_si128 (isA,isC),
+                                                _mm_or_si128 (isG,isT))) & 0xFFFF;
+    while (invalid != 0) {
+      exceptions[numExceptions++] = i + __builtin_ctz (invalid);
+      invalid &= invalid - 1;
+    }
+    // Fold four 2-bit codes into every 32-bit lane, then narrow the lanes
+    x = _mm_and_si128 (_mm_or_si128 (code,_mm_srli_epi16 (code,6)),lowNibble);
+    x = _mm_and_si128 (_mm_or_si128 (x,_mm_srli_epi32 (x,12)),lowByte);
+    x = _mm_packs_epi32 (x,x);
+    x = _mm_packus_epi16 (x,x);
+    word = _mm_cvtsi128_si32 (x);
+    memcpy (packed + (i >> 2),&word,sizeof (word));
+  }
+#endif
+  return seqPack_packScalar (sequence,i,length,packed,exceptions,numExceptions);
+}
+
+/**
+ * Unpack a sequence packed with seqPack_pack().
+ * @param[in] packed Packed bases
+ * @param[in] length Number of bases
+ * @param[in] exceptions Positions to be restored as 'N'
+ * @param[in] numExceptions Number of exceptions
+ * @param[out] sequence Buffer of at least length + 1 bytes; NUL-terminated
+ */
+void seqPack_unpack (unsigned char *packed, int length, int *exceptions,
+                     int numExceptions, char *sequence)
+{
+  static const char bases[] = "ACGT";
+  int i;
+#ifdef __SSE2__
+  __m128i p,lo,hi,c;
+  int word;
+  const __m128i loBits = _mm_set1_epi32 (0x40100401);
+  const __m128i hiBits = _mm_set1_epi32 ((int)0x80200802);
+  const __m128i charA = _mm_set1_epi8 ('A');
+  const __m128i xorC = _mm_set1_epi8 ('A' ^ 'C');
+  const __m128i xorG = _mm_set1_epi8 ('A' ^ 'G');
+  const __m128i xorT = _mm_set1_epi8 ('A' ^ 'C' ^ 'G' ^ 'T');
+#endif
+
+  i = 0;
+#ifdef __SSE2__
+  for (; i + 16 <= length; i += 16) {
+    memcpy (&word,packed + (i >> 2),sizeof (word));
+    // Broadcast every packed byte to four lanes and test the bits of its lane
+    p = _mm_cvtsi32_si128 (word);
+    p = _mm_unpacklo_epi8 (p,p);
+    p = _mm_unpacklo_epi16 (p,p);
+    lo = _mm_cmpeq_epi8 (_mm_and_si128 (p,loBits),loBits);
+    hi = _mm_cmpeq_epi8 (_mm_and_si128 (p,hiBits),hiBits);
+    c = _mm_xor_si128 (charA,_mm_and_si128 (lo,xorC));
+    c = _mm_xor_si128 (c,_mm_and_si128 (hi,xorG));
+    c = _mm_xor_si128 (c,_mm_and_si128 (_mm_and_si128 (lo,hi),xorT));
+    _mm_storeu_si128 ((__m128i*)(sequence + i),c);
+  }
+#endif
+  for (; i < length; i++) {
+    sequence[i] = bases[(packed[i >> 2] >> ((i & 3) * 2)) & 3];
+  }
+  for (i = 0; i < numExceptions; i++) {
+    sequence[exceptions[i]] = 'N';
+  }
+  sequence[length] = '\0';
+}
+
+/**
+ * Returns the bin (0 .. SEQ_PACK_NUM_QUALITY_BINS - 1) of a Phred+33 quality.
+ */
+int seqPack_getQualityBin (char quality)
+{
+  return qualityBins[(unsigned char)quality];
+}
+
+/**
+ * Returns the Phred+33 quality that represents a bin.
+ */
+char seqPack_getBinQuality (int bin)
+{
+  return binQualities[bin];
+}
+
+/**
+ * Bin quality scores and store them at 4 bits each.
+ * @param[in] qualityScores Phred+33 qualities, need not be NUL-terminated
+ * @param[in] length Number of qualities
+ * @param[out] binned Buffer of at least seqPack_binnedSize (length) bytes
+ */
+void seqPack_binQualities (char *qualityScores, int length, unsigned char *binned)
+{
+  int i;
+
+  for (i = 0; i + 1 < length; i += 2) {
+    binned[i >> 1] = qualityBins[(unsigned char)qualityScores[i]] |
+      (qualityBins[(unsigned char)qualityScores[i + 1]] << 4);
+  }
+  if (i < length) {
+    binned[i >> 1] = qualityBins[(unsigned char)qualityScores[i]];
+  }
+}
+
+/**
+ * Expand binned quality scores to their Phred+33 representatives.
+ * @param[in] binned Output of seqPack_binQualities()
+ * @param[in] length Number of qualities
+ * @param[out] qualityScores Buffer of at least length + 1 bytes; NUL-terminated
+ */
+void seqPack_unbinQualities (unsigned char *binned, int length, char *qualityScores)
+{
+  int i;
+
+  for (i = 0; i + 1 < length; i += 2) {
+    qualityScores[i] = binQualities[binned[i >> 1] & 0x0F];
+    qualityScores[i + 1] = binQualities[binned[i >> 1] >> 4];
+  }
+  if (i < length) {
+    qualityScores[i] = binQualities[binned[i >> 1] & 0x0F];
+  }
+  qualityScores[length] = '\0';
+}
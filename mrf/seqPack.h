@@ -0,0 +1,33 @@
+/// @file seqPack.h
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Compact representations of read sequences and quality scores.
+///
+/// Sequences are packed at 2 bits per base (A=0, C=1, G=2, T=3; base i is
+/// stored in bits 2*(i%4) of byte i/4). Packing is case-insensitive, and
+/// the positions of all other symbols are returned as an exception list.
+/// Unpacking restores them as 'N'. Quality scores (Phred+33) can be
+/// reduced to eight Illumina-style bins and stored at 4 bits each.
+
+#ifndef DEF_SEQ_PACK_H
+#define DEF_SEQ_PACK_H
+
+#define SEQ_PACK_NUM_QUALITY_BINS 8
+
+/// Bytes needed to pack length bases.
+#define seqPack_packedSize(length) (((length) + 3) / 4)
+/// Bytes needed to store length binned quality scores.
+#define seqPack_binnedSize(length) (((length) + 1) / 2)
+
+int seqPack_pack (char *sequence, int length, unsigned char *packed, int *exceptions);
+void seqPack_unpack (unsigned char *packed, int length, int *exceptions,
+                     int numExceptions, char *sequence);
+int seqPack_getQualityBin (char quality);
+char seqPack_getBinQuality (int bin);
+void seqPack_binQualities (char *qualityScores, int length, unsigned char *binned);
+void seqPack_unbinQualities (unsigned char *binned, int length, char *qualityScores);
+
+#endif /* DEF_SEQ_PACK_H */
@@ -0,0 +1,62 @@
+/// @file stats.c
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Instrumentation switches shared by the MRF and SAM parsers.
+
+#define _GNU_SOURCE
+
+#include <time.h>
+
+#include "statsUtil.h"
+
+#ifdef MRF_ENABLE_STATS
+
+int mrfStatsEnabled = 0;
+
+long long mrfStats_now (void)
+{
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC,&ts);
+  return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+#endif
+
+/**
+ * Returns 1 if the instrumentation has been compiled in (--enable-stats).
+ */
+int mrfStats_isCompiled (void)
+{
+#ifdef MRF_ENABLE_STATS
+  return 1;
+#else
+  return 0;
+#endif
+}
+
+/**
+ * Switch counting on or off. Has no effect if the instrumentation has not
+ * been compiled in.
+ */
+void mrfStats_setEnabled (int enabled)
+{
+#ifdef MRF_ENABLE_STATS
+  mrfStatsEnabled = enabled ? 1 : 0;
+#endif
+}
+
+/**
+ * Returns 1 if counting is switched on.
+ */
+int mrfStats_isEnabled (void)
+{
+#ifdef MRF_ENABLE_STATS
+  return mrfStatsEnabled;
+#else
+  return 0;
+#endif
+}
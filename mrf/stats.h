@@ -0,0 +1,48 @@
+/// @file stats.h
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Instrumentation counters of the MRF and SAM readers and writers.
+///
+/// The counters are only compiled in when libmrf is configured with
+/// --enable-stats; otherwise the query functions report zeros and the
+/// parsers carry no instrumentation code at all. When compiled in, counting
+/// is switched on and off at run time with mrfStats_setEnabled(). There is
+/// no separate allocation timer: the time spent allocating entries is part
+/// of nsParse, and bytesAllocated counts what was allocated.
+
+#ifndef DEF_STATS_H
+#define DEF_STATS_H
+
+/// @struct MrfStats
+/// @brief Counters collected by a reader/writer since it was last initialized.
+typedef struct {
+  long long bytesRead;       // Bytes consumed, including newlines
+  long long lines;           // Lines read, including skipped ones
+  long long commentLines;    // Lines skipped as comments ('#')
+  long long headerLines;     // Lines skipped as headers ('@' or repeated MRF header)
+  long long emptyLines;      // Empty lines skipped
+  long long entries;         // Entries returned to the caller
+  long long pairedEntries;   // Entries with two mates
+  long long singleEntries;   // Entries with one mate
+  long long blocks;          // Alignment blocks parsed
+  long long bytesAllocated;  // Bytes allocated to hold parsed entries
+  long long entriesWritten;  // Entries formatted by the writer
+  long long bytesWritten;    // Bytes produced by the writer, without newlines
+  long long nsRead;          // Nanoseconds spent reading lines
+  long long nsParse;         // Nanoseconds spent tokenizing, converting and allocating
+  long long nsWrite;         // Nanoseconds spent formatting entries
+} MrfStats;
+
+int mrfStats_isCompiled (void);
+void mrfStats_setEnabled (int enabled);
+int mrfStats_isEnabled (void);
+
+void mrf_getStats (MrfStats *stats);
+void mrf_resetStats (void);
+void samParser_getStats (MrfStats *stats);
+void samParser_resetStats (void);
+
+#endif /* DEF_STATS_H */
@@ -0,0 +1,37 @@
+/// @file statsUtil.h
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Instrumentation macros used inside the parsers; not installed. Without
+/// MRF_ENABLE_STATS every macro expands to nothing.
+
+#ifndef DEF_STATS_UTIL_H
+#define DEF_STATS_UTIL_H
+
+#include "stats.h"
+
+#ifdef MRF_ENABLE_STATS
+
+extern int mrfStatsEnabled;
+long long mrfStats_now (void);
+
+#define STATS_ADD(stats,field,n) \
+  do { if (mrfStatsEnabled) { (stats).field += (n); } } while (0)
+#define STATS_TIMER(t) long long t = 0
+#define STATS_TIMER_START(t) \
+  do { if (mrfStatsEnabled) { t = mrfStats_now (); } } while (0)
+#define STATS_TIMER_STOP(stats,field,t) \
+  do { if (mrfStatsEnabled) { (stats).field += mrfStats_now () - t; } } while (0)
+
+#else
+
+#define STATS_ADD(stats,field,n) do { } while (0)
+#define STATS_TIMER(t)
+#define STATS_TIMER_START(t) do { } while (0)
+#define STATS_TIMER_STOP(stats,field,t) do { } while (0)
+
+#endif
+
+#endif /* DEF_STATS_UTIL_H */
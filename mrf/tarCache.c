@@ -0,0 +1,419 @@
+/// @file tarCache.c
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Read-only cache of the tars of a BED file, shared between processes.
+///
+/// A cache file holds a TarCacheHeader followed by the targets, the tars,
+/// the running maximum of the tar ends per target and the NUL-terminated
+/// target names. The checksum covers everything after the header. Overlap
+/// queries walk back from the last tar that starts before the query end
+/// until the running maximum end shows that no earlier tar can overlap.
+
+#define _GNU_SOURCE
+
+#include <fcntl.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <bios/log.h>
+#include <bios/format.h>
+#include <bios/common.h>
+
+#include "tarCache.h"
+#include "targetDict.h"
+
+#define TAR_CACHE_MAGIC "MrfTarC"
+#define TAR_CACHE_VERSION 1
+
+typedef struct {
+  char magic[8];
+  uint32_t version;
+  uint32_t numTargets;
+  uint64_t numTars;
+  uint64_t namesLength;
+  uint64_t sourceSize;
+  int64_t sourceMtime;
+  int64_t sourceMtimeNsec;
+  uint64_t checksum;
+} TarCacheHeader;
+
+typedef struct {
+  char *name;
+  int dictId;
+} TarCacheName;
+
+static uint64_t tarCache_checksum (char *data, size_t length)
+{
+  uint64_t hash,word;
+  size_t i;
+
+  hash = 14695981039346656037ULL;
+  for (i = 0; i + sizeof (word) <= length; i += sizeof (word)) {
+    memcpy (&word,data + i,sizeof (word));
+    hash = (hash ^ word) * 1099511628211ULL;
+    hash ^= hash >> 29;
+  }
+  for (; i < length; i++) {
+    hash = (hash ^ (unsigned char)data[i]) * 1099511628211ULL;
+  }
+  return hash;
+}
+
+static int tarCache_sortNames (TarCacheName *a, TarCacheName *b)
+{
+  return strcmp (a->name,b->name);
+}
+
+static int tarCache_sortTars (const void *p, const void *q)
+{
+  const CachedTar *a = p;
+  const CachedTar *b = q;
+
+  if (a->targetId != b->targetId) {
+    return a->targetId - b->targetId;
+  }
+  if (a->start != b->start) {
+    return a->start < b->start ? -1 : 1;
+  }
+  if (a->end != b->end) {
+    return a->end < b->end ? -1 : 1;
+  }
+  return 0;
+}
+
+static long tarCache_getPayloadLength (long numTargets, long numTars, long namesLength)
+{
+  return numTargets * sizeof (CachedTarget) + numTars * (sizeof (CachedTar) + sizeof (int)) +
+    namesLength;
+}
+
+/**
+ * Parse a BED file with readTarsFromBedFile() and publish its cache.
+ * @param[in] bedFileName BED file
+ * @param[in] cacheFileName Cache file to create or replace, e.g. a file
+ * under /dev/shm
+ */
+void tarCache_build (char *bedFileName, char *cacheFileName)
+{
+  TarCacheHeader header;
+  TargetDict *dict;
+  Array tars,names,sortedIds;
+  Stringa tmpFileName;
+  TarCacheName *currName;
+  CachedTarget *targets;
+  CachedTar *cachedTars;
+  Tar *currTar;
+  struct stat st;
+  FILE *fp;
+  char *payload,*namesStart;
+  int *maxEnds;
+  long payloadLength,namesLength;
+  int numTargets,numTars,i,id;
+
+  // The source is stat'ed first, so a change while it is parsed makes the
+  // cache stale rather than wrong
+  if (stat (bedFileName,&st) != 0) {
+    die ("Unable to stat %s",bedFileName);
+  }
+  tars = readTarsFromBedFile (bedFileName);
+  numTars = arrayMax (tars);
+  dict = targetDict_create ();
+  for (i = 0; i < numTars; i++) {
+    targetDict_getId (dict,arrp (tars,i,Tar)->targetName);
+  }
+  numTargets = targetDict_size (dict);
+  names = arrayCreate (numTargets + 1,TarCacheName);
+  namesLength = 0;
+  for (i = 0; i < numTargets; i++) {
+    currName = arrayp (names,i,TarCacheName);
+    currName->name = targetDict_getName (dict,i);
+    currName->dictId = i;
+    namesLength += strlen (currName->name) + 1;
+  }
+  arraySort (names,(ARRAYORDERF)tarCache_sortNames);
+  sortedIds = arrayCreate (numTargets + 1,int);
+  for (i = 0; i < numTargets; i++) {
+    array (sortedIds,i,int) = 0;
+  }
+  for (i = 0; i < numTargets; i++) {
+    arru (sortedIds,arrp (names,i,TarCacheName)->dictId,int) = i;
+  }
+
+  payloadLength = tarCache_getPayloadLength (numTargets,numTars,namesLength);
+  payload = hlr_malloc (payloadLength > 0 ? payloadLength : 1);
+  targets = (CachedTarget*)payload;
+  cachedTars = (CachedTar*)(targets + numTargets);
+  maxEnds = (int*)(cachedTars + numTars);
+  namesStart = (char*)(maxEnds + numTars);
+  for (i = 0; i < numTars; i++) {
+    currTar = arrp (tars,i,Tar);
+    cachedTars[i].targetId = arru (sortedIds,targetDict_lookup (dict,currTar->targetName),int);
+    cachedTars[i].start = currTar->start;
+    cachedTars[i].end = currTar->end;
+  }
+  qsort (cachedTars,numTars,sizeof (CachedTar),tarCache_sortTars);
+  namesLength = 0;
+  for (i = 0; i < numTargets; i++) {
+    targets[i].nameOffset = namesLength;
+    targets[i].firstTar = 0;
+    targets[i].numTars = 0;
+    strcpy (namesStart + namesLength,arrp (names,i,TarCacheName)->name);
+    namesLength += strlen (namesStart + namesLength) + 1;
+  }
+  for (i = 0; i < numTars; i++) {
+    id = cachedTars[i].targetId;
+    if (targets[id].numTars == 0) {
+      targets[id].firstTar = i;
+      maxEnds[i] = cachedTars[i].end;
+    }
+    else {
+      maxEnds[i] = maxEnds[i - 1] > cachedTars[i].end ? maxEnds[i - 1] : cachedTars[i].end;
+    }
+    targets[id].numTars++;
+  }
+
+  memset (&header,0,sizeof (header));
+  memcpy (header.magic,TAR_CACHE_MAGIC,sizeof (TAR_CACHE_MAGIC));
+  header.version = TAR_CACHE_VERSION;
+  header.numTargets = numTargets;
+  header.numTars = numTars;
+  header.namesLength = namesLength;
+  header.sourceSize = st.st_size;
+  header.sourceMtime = st.st_mtim.tv_sec;
+  header.sourceMtimeNsec = st.st_mtim.tv_nsec;
+  header.checksum = tarCache_checksum (payload,payloadLength);
+  tmpFileName = stringCreate (100);
+  stringPrintf (tmpFileName,"%s.%d.tmp",cacheFileName,(int)getpid ());
+  if ((fp = fopen (string (tmpFileName),"w")) == NULL) {
+    die ("Unable to create %s",string (tmpFileName));
+  }
+  if (fwrite (&header,sizeof (header),1,fp) != 1 ||
+      (payloadLength > 0 && fwrite (payload,payloadLength,1,fp) != 1) || fclose (fp) != 0) {
+    die ("Unable to write %s",string (tmpFileName));
+  }
+  if (rename (string (tmpFileName),cacheFileName) != 0) {
+    die ("Unable to rename %s to %s",string (tmpFileName),cacheFileName);
+  }
+  stringDestroy (tmpFileName);
+  hlr_free (payload);
+  arrayDestroy (sortedIds);
+  arrayDestroy (names);
+  targetDict_destroy (dict);
+  for (i = 0; i < numTars; i++) {
+    hlr_free (arrp (tars,i,Tar)->targetName);
+  }
+  arrayDestroy (tars);
+}
+
+// Check a mapped cache; bedFileName may be NULL
+static int tarCache_isValid (char *data, long length, char *bedFileName)
+{
+  TarCacheHeader *header;
+  struct stat st;
+
+  if (length < (long)sizeof (TarCacheHeader)) {
+    return 0;
+  }
+  header = (TarCacheHeader*)data;
+  if (memcmp (header->magic,TAR_CACHE_MAGIC,sizeof (TAR_CACHE_MAGIC)) != 0 ||
+      header->version != TAR_CACHE_VERSION || header->numTargets > INT_MAX ||
+      header->numTars > INT_MAX ||
+      length != (long)sizeof (TarCacheHeader) +
+      tarCache_getPayloadLength (header->numTargets,header->numTars,header->namesLength)) {
+    return 0;
+  }
+  if (bedFileName != NULL &&
+      (stat (bedFileName,&st) != 0 || (uint64_t)st.st_size != header->sourceSize ||
+       st.st_mtim.tv_sec != header->sourceMtime || st.st_mtim.tv_nsec != header->sourceMtimeNsec)) {
+    return 0;
+  }
+  return tarCache_checksum (data + sizeof (TarCacheHeader),
+                            length - sizeof (TarCacheHeader)) == header->checksum;
+}
+
+/**
+ * Map a cache written by tarCache_build().
+ * @param[in] cacheFileName Cache file
+ * @param[in] bedFileName BED file the cache must match, or NULL to skip
+ * this check
+ * @return The cache, or NULL if it does not exist, has another version,
+ * fails its checksum or does not match bedFileName
+ * @post Use tarCache_close to release the mapping
+ */
+TarCache* tarCache_open (char *cacheFileName, char *bedFileName)
+{
+  TarCache *cache;
+  TarCacheHeader *header;
+  struct stat st;
+  char *data;
+  int fd;
+
+  if ((fd = open (cacheFileName,O_RDONLY)) < 0) {
+    return NULL;
+  }
+  if (fstat (fd,&st) != 0 || st.st_size < (off_t)sizeof (TarCacheHeader)) {
+    close (fd);
+    return NULL;
+  }
+  data = mmap (NULL,st.st_size,PROT_READ,MAP_SHARED,fd,0);
+  close (fd);
+  if (data == MAP_FAILED) {
+    return NULL;
+  }
+  if (!tarCache_isValid (data,st.st_size,bedFileName)) {
+    munmap (data,st.st_size);
+    return NULL;
+  }
+  header = (TarCacheHeader*)data;
+  AllocVar (cache);
+  cache->data = data;
+  cache->length = st.st_size;
+  cache->numTargets = header->numTargets;
+  cache->numTars = header->numTars;
+  cache->targets = (CachedTarget*)(data + sizeof (TarCacheHeader));
+  cache->tars = (CachedTar*)(cache->targets + cache->numTargets);
+  cache->maxEnds = (int*)(cache->tars + cache->numTars);
+  cache->names = (char*)(cache->maxEnds + cache->numTars);
+  return cache;
+}
+
+/**
+ * Map the cache of a BED file, building it first if it is missing or
+ * stale.
+ * @param[in] bedFileName BED file
+ * @param[in] cacheFileName Cache file, e.g. a file under /dev/shm
+ * @post Use tarCache_close to release the mapping
+ */
+TarCache* tarCache_attach (char *bedFileName, char *cacheFileName)
+{
+  TarCache *cache;
+
+  if ((cache = tarCache_open (cacheFileName,bedFileName)) != NULL) {
+    return cache;
+  }
+  tarCache_build (bedFileName,cacheFileName);
+  if ((cache = tarCache_open (cacheFileName,bedFileName)) == NULL) {
+    die ("Unable to attach the tar cache %s",cacheFileName);
+  }
+  return cache;
+}
+
+/**
+ * Unmap a cache.
+ */
+void tarCache_close (TarCache *cache)
+{
+  if (cache == NULL) {
+    return;
+  }
+  munmap (cache->data,cache->length);
+  freeMem (cache);
+}
+
+/**
+ * Returns the id of a target, or -1 if it has no tars.
+ */
+int tarCache_getTargetId (TarCache *cache, char *targetName)
+{
+  int low,high,mid,cmp;
+
+  low = 0;
+  high = cache->numTargets - 1;
+  while (low <= high) {
+    mid = low + (high - low) / 2;
+    cmp = strcmp (cache->names + cache->targets[mid].nameOffset,targetName);
+    if (cmp == 0) {
+      return mid;
+    }
+    if (cmp < 0) {
+      low = mid + 1;
+    }
+    else {
+      high = mid - 1;
+    }
+  }
+  return -1;
+}
+
+/**
+ * Returns the name of a target.
+ * @note The memory belongs to the cache.
+ */
+char* tarCache_getTargetName (TarCache *cache, int targetId)
+{
+  return cache->names + cache->targets[targetId].nameOffset;
+}
+
+/**
+ * Returns the tars as readTarsFromBedFile() does, but sorted by target
+ * name, start and end.
+ * @return Array of Tar whose names point into the cache
+ * @post Use arrayDestroy to de-allocate the memory; do not free the names
+ */
+Array tarCache_getTars (TarCache *cache)
+{
+  Array tars;
+  Tar *currTar;
+  int i;
+
+  tars = arrayCreate (cache->numTars > 0 ? cache->numTars : 1,Tar);
+  for (i = 0; i < cache->numTars; i++) {
+    currTar = arrayp (tars,i,Tar);
+    currTar->targetName = tarCache_getTargetName (cache,cache->tars[i].targetId);
+    currTar->start = cache->tars[i].start;
+    currTar->end = cache->tars[i].end;
+  }
+  return tars;
+}
+
+/**
+ * Find the tars of a target that overlap an interval, with the BED
+ * convention: start is 0-based and end is exclusive.
+ * @param[out] overlaps Array of int that receives indices into cache->tars
+ * in increasing order; it is cleared
+ * @return Number of overlapping tars
+ */
+int tarCache_findOverlaps (TarCache *cache, char *targetName, int start, int end,
+                           Array overlaps)
+{
+  CachedTarget *target;
+  int id,first,low,high,mid,i,j,tmp;
+
+  arrayClear (overlaps);
+  if ((id = tarCache_getTargetId (cache,targetName)) < 0) {
+    return 0;
+  }
+  target = cache->targets + id;
+  first = target->firstTar;
+  // First tar that starts at or after end
+  low = first;
+  high = first + target->numTars;
+  while (low < high) {
+    mid = low + (high - low) / 2;
+    if (cache->tars[mid].start < end) {
+      low = mid + 1;
+    }
+    else {
+      high = mid;
+    }
+  }
+  for (i = low - 1; i >= first && cache->maxEnds[i] > start; i--) {
+    if (cache->tars[i].end > start) {
+      array (overlaps,arrayMax (overlaps),int) = i;
+    }
+  }
+  for (i = 0, j = arrayMax (overlaps) - 1; i < j; i++, j--) {
+    tmp = arru (overlaps,i,int);
+    arru (overlaps,i,int) = arru (overlaps,j,int);
+    arru (overlaps,j,int) = tmp;
+  }
+  return arrayMax (overlaps);
+}
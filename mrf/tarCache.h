@@ -0,0 +1,63 @@
+/// @file tarCache.h
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Read-only cache of the tars of a BED file, shared between processes.
+///
+/// A cache file holds the tars sorted by target and start, the target names
+/// and an overlap index. Processes map it read-only, so they share one copy
+/// in the page cache and use it without parsing; a file under /dev/shm
+/// keeps it in memory. The cache records a format version, a checksum and
+/// the size and modification time of the BED file; a cache that fails any
+/// of these checks is stale and is rebuilt by tarCache_attach(). Caches are
+/// published with an atomic rename, so a process never maps a partial file.
+
+#ifndef DEF_TAR_CACHE_H
+#define DEF_TAR_CACHE_H
+
+#include <bios/format.h>
+
+#include "mrfUtil.h"
+
+/// @struct CachedTar
+/// @brief A tar, with coordinates as in the BED file.
+typedef struct {
+  int targetId;   // index into TarCache.targets
+  int start;
+  int end;
+} CachedTar;
+
+/// @struct CachedTarget
+/// @brief A target and the range of its tars.
+typedef struct {
+  int nameOffset;   // into TarCache.names
+  int firstTar;
+  int numTars;
+} CachedTarget;
+
+/// @struct TarCache
+/// @brief A mapped cache; targets are sorted by name.
+typedef struct {
+  char *data;           // mapped file
+  long length;
+  int numTargets;
+  int numTars;
+  CachedTarget *targets;
+  CachedTar *tars;      // sorted by target, start and end
+  int *maxEnds;         // largest end of the tars of a target up to each tar
+  char *names;
+} TarCache;
+
+void tarCache_build (char *bedFileName, char *cacheFileName);
+TarCache* tarCache_open (char *cacheFileName, char *bedFileName);
+TarCache* tarCache_attach (char *bedFileName, char *cacheFileName);
+void tarCache_close (TarCache *cache);
+int tarCache_getTargetId (TarCache *cache, char *targetName);
+char* tarCache_getTargetName (TarCache *cache, int targetId);
+Array tarCache_getTars (TarCache *cache);
+int tarCache_findOverlaps (TarCache *cache, char *targetName, int start, int end,
+                           Array overlaps);
+
+#endif /* DEF_TAR_CACHE_H */
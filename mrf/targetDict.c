@@ -0,0 +1,152 @@
+/// @file targetDict.c
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Dictionary that assigns consecutive ids to target names.
+
+#include <bios/log.h>
+#include <bios/format.h>
+#include <bios/common.h>
+
+#include "targetDict.h"
+
+#define TARGET_DICT_HASH_SIZE 1024
+
+static unsigned int targetDict_hashString (char *s)
+{
+  unsigned int hash;
+
+  hash = 2166136261u;
+  while (*s != '\0') {
+    hash = (hash ^ (unsigned char)*s++) * 16777619u;
+  }
+  return hash;
+}
+
+static void targetDict_clearHash (Array hash, int size)
+{
+  int i;
+
+  for (i = 0; i < size; i++) {
+    array (hash,i,int) = -1;
+  }
+}
+
+static void targetDict_rehash (TargetDict *dict)
+{
+  int size,i,slot;
+
+  size = arrayMax (dict->hash) * 2;
+  arrayDestroy (dict->hash);
+  dict->hash = arrayCreate (size,int);
+  targetDict_clearHash (dict->hash,size);
+  for (i = 0; i < arrayMax (dict->names); i++) {
+    slot = targetDict_hashString (textItem (dict->names,i)) & (size - 1);
+    while (arru (dict->hash,slot,int) >= 0) {
+      slot = (slot + 1) & (size - 1);
+    }
+    arru (dict->hash,slot,int) = i;
+  }
+}
+
+// Returns the slot holding name, or the empty slot where it belongs
+static int targetDict_findSlot (TargetDict *dict, char *name)
+{
+  int size,slot,id;
+
+  size = arrayMax (dict->hash);
+  slot = targetDict_hashString (name) & (size - 1);
+  while ((id = arru (dict->hash,slot,int)) >= 0) {
+    if (strEqual (textItem (dict->names,id),name)) {
+      break;
+    }
+    slot = (slot + 1) & (size - 1);
+  }
+  return slot;
+}
+
+/**
+ * Create an empty dictionary.
+ */
+TargetDict* targetDict_create (void)
+{
+  TargetDict *dict;
+
+  AllocVar (dict);
+  dict->names = textCreate (100);
+  dict->hash = arrayCreate (TARGET_DICT_HASH_SIZE,int);
+  targetDict_clearHash (dict->hash,TARGET_DICT_HASH_SIZE);
+  dict->lastId = -1;
+  return dict;
+}
+
+/**
+ * Deallocate a dictionary.
+ */
+void targetDict_destroy (TargetDict *dict)
+{
+  if (dict == NULL) {
+    return;
+  }
+  textDestroy (dict->names);
+  arrayDestroy (dict->hash);
+  freeMem (dict);
+}
+
+/**
+ * Returns the id of a target name, adding the name if it is new.
+ */
+int targetDict_getId (TargetDict *dict, char *name)
+{
+  int slot,id;
+
+  if (dict->lastId >= 0 && strEqual (textItem (dict->names,dict->lastId),name)) {
+    return dict->lastId;
+  }
+  slot = targetDict_findSlot (dict,name);
+  id = arru (dict->hash,slot,int);
+  if (id < 0) {
+    id = arrayMax (dict->names);
+    textAdd (dict->names,name);
+    arru (dict->hash,slot,int) = id;
+    if (2 * arrayMax (dict->names) > arrayMax (dict->hash)) {
+      targetDict_rehash (dict);
+    }
+  }
+  dict->lastId = id;
+  return id;
+}
+
+/**
+ * Returns the id of a target name, or -1 if it is not in the dictionary.
+ */
+int targetDict_lookup (TargetDict *dict, char *name)
+{
+  return arru (dict->hash,targetDict_findSlot (dict,name),int);
+}
+
+/**
+ * Returns the number of targets.
+ */
+int targetDict_size (TargetDict *dict)
+{
+  return arrayMax (dict->names);
+}
+
+/**
+ * Returns the name of a target id.
+ */
+char* targetDict_getName (TargetDict *dict, int id)
+{
+  return textItem (dict->names,id);
+}
+
+/**
+ * Returns the approximate number of bytes held by the dictionary index.
+ */
+long targetDict_memoryUsage (TargetDict *dict)
+{
+  return sizeof (TargetDict) + (long)arrayMax (dict->hash) * sizeof (int);
+}
@@ -0,0 +1,29 @@
+/// @file targetDict.h
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Dictionary that assigns consecutive ids to target names. Lookups are
+/// tuned for sorted input, where a name usually repeats the previous one.
+
+#ifndef DEF_TARGET_DICT_H
+#define DEF_TARGET_DICT_H
+
+/// @struct TargetDict
+/// @brief Target names and an open addressing index into them.
+typedef struct {
+  Texta names;
+  Array hash;   // of int, id or -1
+  int lastId;
+} TargetDict;
+
+TargetDict* targetDict_create (void);
+void targetDict_destroy (TargetDict *dict);
+int targetDict_getId (TargetDict *dict, char *name);
+int targetDict_lookup (TargetDict *dict, char *name);
+int targetDict_size (TargetDict *dict);
+char* targetDict_getName (TargetDict *dict, int id);
+long targetDict_memoryUsage (TargetDict *dict);
+
+#endif /* DEF_TARGET_DICT_H */
@@ -0,0 +1,461 @@
+/// @file tokenizer.c
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Delimiter search and number conversion shared by the parsers.
+///
+/// The search on NUL-terminated strings uses aligned loads only, so it never
+/// reads across a page boundary past the terminator. The AVX2 kernel is
+/// compiled with a function-level target attribute and only selected when
+/// the CPU supports it.
+
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TOKENIZER_X86 1
+#include <immintrin.h>
+#endif
+
+#include "tokenizer.h"
+
+// The kernels on NUL-terminated strings read the aligned block around the
+// terminator, which may lie outside the allocation; this cannot fault, but
+// AddressSanitizer would report it, so they are not instrumented
+#if defined(__GNUC__) || defined(__clang__)
+#define TOKENIZER_NO_SANITIZE __attribute__((no_sanitize_address))
+#else
+#define TOKENIZER_NO_SANITIZE
+#endif
+
+#define TOKENIZER_NUM_DELIMITERS 5
+#define TOKENIZER_UNRESOLVED (-1)
+
+static int tokenizerKernel = TOKENIZER_UNRESOLVED;
+
+// Expand a delimiter mask into five characters, repeating one if needed
+static void tokenizer_getDelimiters (int delimiters, char *chars)
+{
+  static const char allChars[TOKENIZER_NUM_DELIMITERS] = {'\n','\t',':',',','|'};
+  int i,n;
+
+  n = 0;
+  for (i = 0; i < TOKENIZER_NUM_DELIMITERS; i++) {
+    if (delimiters & (1 << i)) {
+      chars[n++] = allChars[i];
+    }
+  }
+  if (n == 0) {
+    chars[n++] = '\0';
+  }
+  for (i = n; i < TOKENIZER_NUM_DELIMITERS; i++) {
+    chars[i] = chars[0];
+  }
+}
+
+static int tokenizer_isDelimiter (char c, char *chars)
+{
+  return c == chars[0] || c == chars[1] || c == chars[2] || c == chars[3] || c == chars[4];
+}
+
+static char* tokenizer_findScalar (char *s, char *chars)
+{
+  while (*s != '\0' && !tokenizer_isDelimiter (*s,chars)) {
+    s++;
+  }
+  return s;
+}
+
+static char* tokenizer_findBoundedScalar (char *s, char *end, char *chars)
+{
+  while (s < end && !tokenizer_isDelimiter (*s,chars)) {
+    s++;
+  }
+  return s;
+}
+
+#ifdef __SSE2__
+
+static __m128i tokenizer_matchSse2 (__m128i v, __m128i *d)
+{
+  return _mm_or_si128 (_mm_or_si128 (_mm_cmpeq_epi8 (v,d[0]),_mm_cmpeq_epi8 (v,d[1])),
+                       _mm_or_si128 (_mm_or_si128 (_mm_cmpeq_epi8 (v,d[2]),_mm_cmpeq_epi8 (v,d[3])),
+                                     _mm_cmpeq_epi8 (v,d[4])));
+}
+
+TOKENIZER_NO_SANITIZE
+static char* tokenizer_findSse2 (char *s, char *chars)
+{
+  __m128i d[TOKENIZER_NUM_DELIMITERS];
+  __m128i v,zero;
+  unsigned int mask;
+  char *p;
+  int i;
+
+  for (i = 0; i < TOKENIZER_NUM_DELIMITERS; i++) {
+    d[i] = _mm_set1_epi8 (chars[i]);
+  }
+  zero = _mm_setzero_si128 ();
+  p = (char*)((uintptr_t)s & ~(uintptr_t)15);
+  v = _mm_load_si128 ((const __m128i*)p);
+  mask = _mm_movemask_epi8 (_mm_or_si128 (tokenizer_matchSse2 (v,d),_mm_cmpeq_epi8 (v,zero)));
+  mask >>= s - p;
+  if (mask != 0) {
+    return s + __builtin_ctz (mask);
+  }
+  for (;;) {
+    p += 16;
+    v = _mm_load_si128 ((const __m128i*)p);
+    mask = _mm_movemask_epi8 (_mm_or_si128 (tokenizer_matchSse2 (v,d),_mm_cmpeq_epi8 (v,zero)));
+    if (mask != 0) {
+      return p + __builtin_ctz (mask);
+    }
+  }
+}
+
+static char* tokenizer_findBoundedSse2 (char *s, char *end, char *chars)
+{
+  __m128i d[TOKENIZER_NUM_DELIMITERS];
+  unsigned int mask;
+  int i;
+
+  for (i = 0; i < TOKENIZER_NUM_DELIMITERS; i++) {
+    d[i] = _mm_set1_epi8 (chars[i]);
+  }
+  for (; s + 16 <= end; s += 16) {
+    mask = _mm_movemask_epi8 (tokenizer_matchSse2 (_mm_loadu_si128 ((const __m128i*)s),d));
+    if (mask != 0) {
+      return s + __builtin_ctz (mask);
+    }
+  }
+  return tokenizer_findBoundedScalar (s,end,chars);
+}
+
+#endif
+
+#ifdef TOKENIZER_X86
+
+__attribute__((target("avx2")))
+static __m256i tokenizer_matchAvx2 (__m256i v, __m256i *d)
+{
+  return _mm256_or_si256 (_mm256_or_si256 (_mm256_cmpeq_epi8 (v,d[0]),_mm256_cmpeq_epi8 (v,d[1])),
+                          _mm256_or_si256 (_mm256_or_si256 (_mm256_cmpeq_epi8 (v,d[2]),
+                                                            _mm256_cmpeq_epi8 (v,d[3])),
+                                           _mm256_cmpeq_epi8 (v,d[4])));
+}
+
+__attribute__((target("avx2"))) TOKENIZER_NO_SANITIZE
+static char* tokenizer_findAvx2 (char *s, char *chars)
+{
+  __m256i d[TOKENIZER_NUM_DELIMITERS];
+  __m256i v,zero;
+  unsigned int mask;
+  char *p;
+  int i;
+
+  for (i = 0; i < TOKENIZER_NUM_DELIMITERS; i++) {
+    d[i] = _mm256_set1_epi8 (chars[i]);
+  }
+  zero = _mm256_setzero_si256 ();
+  p = (char*)((uintptr_t)s & ~(uintptr_t)31);
+  v = _mm256_load_si256 ((const __m256i*)p);
+  mask = _mm256_movemask_epi8 (_mm256_or_si256 (tokenizer_matchAvx2 (v,d),
+                                                _mm256_cmpeq_epi8 (v,zero)));
+  mask >>= s - p;
+  if (mask != 0) {
+    return s + __builtin_ctz (mask);
+  }
+  for (;;) {
+    p += 32;
+    v = _mm256_load_si256 ((const __m256i*)p);
+    mask = _mm256_movemask_epi8 (_mm256_or_si256 (tokenizer_matchAvx2 (v,d),
+                                                  _mm256_cmpeq_epi8 (v,zero)));
+    if (mask != 0) {
+      return p + __builtin_ctz (mask);
+    }
+  }
+}
+
+__attribute__((target("avx2")))
+static char* tokenizer_findBoundedAvx2 (char *s, char *end, char *chars)
+{
+  __m256i d[TOKENIZER_NUM_DELIMITERS];
+  unsigned int mask;
+  int i;
+
+  for (i = 0; i < TOKENIZER_NUM_DELIMITERS; i++) {
+    d[i] = _mm256_set1_epi8 (chars[i]);
+  }
+  for (; s + 32 <= end; s += 32) {
+    mask = _mm256_movemask_epi8 (tokenizer_matchAvx2 (_mm256_loadu_si256 ((const __m256i*)s),d));
+    if (mask != 0) {
+      return s + __builtin_ctz (mask);
+    }
+  }
+  return tokenizer_findBoundedScalar (s,end,chars);
+}
+
+#endif
+
+static int tokenizer_isSupported (int kernel)
+{
+  switch (kernel) {
+  case TOKENIZER_KERNEL_SCALAR:
+    return 1;
+#ifdef __SSE2__
+  case TOKENIZER_KERNEL_SSE2:
+    return 1;
+#endif
+#ifdef TOKENIZER_X86
+  case TOKENIZER_KERNEL_AVX2:
+    __builtin_cpu_init ();
+    return __builtin_cpu_supports ("avx2") != 0;
+#endif
+  default:
+    return 0;
+  }
+}
+
+/**
+ * Returns the search kernel in use, one of the TOKENIZER_KERNEL constants.
+ */
+int tokenizer_getKernel (void)
+{
+  int kernel;
+
+  kernel = __atomic_load_n (&tokenizerKernel,__ATOMIC_RELAXED);
+  if (kernel == TOKENIZER_UNRESOLVED) {
+    kernel = TOKENIZER_KERNEL_SCALAR;
+    if (tokenizer_isSupported (TOKENIZER_KERNEL_AVX2)) {
+      kernel = TOKENIZER_KERNEL_AVX2;
+    }
+    else if (tokenizer_isSupported (TOKENIZER_KERNEL_SSE2)) {
+      kernel = TOKENIZER_KERNEL_SSE2;
+    }
+    __atomic_store_n (&tokenizerKernel,kernel,__ATOMIC_RELAXED);
+  }
+  return kernel;
+}
+
+/**
+ * Force a search kernel, e.g. to compare kernels.
+ * @return 1 if the kernel is available, otherwise 0 and nothing changes
+ */
+int tokenizer_setKernel (int kernel)
+{
+  if (!tokenizer_isSupported (kernel)) {
+    return 0;
+  }
+  __atomic_store_n (&tokenizerKernel,kernel,__ATOMIC_RELAXED);
+  return 1;
+}
+
+/**
+ * Find the first delimiter in a NUL-terminated string.
+ * @param[in] s String
+ * @param[in] delimiters Bitwise OR of TOKENIZER_ delimiter constants
+ * @return Pointer to the first delimiter, or to the terminating NUL
+ */
+char* tokenizer_find (char *s, int delimiters)
+{
+  char chars[TOKENIZER_NUM_DELIMITERS];
+
+  tokenizer_getDelimiters (delimiters,chars);
+  switch (tokenizer_getKernel ()) {
+#ifdef TOKENIZER_X86
+  case TOKENIZER_KERNEL_AVX2:
+    return tokenizer_findAvx2 (s,chars);
+#endif
+#ifdef __SSE2__
+  case TOKENIZER_KERNEL_SSE2:
+    return tokenizer_findSse2 (s,chars);
+#endif
+  default:
+    return tokenizer_findScalar (s,chars);
+  }
+}
+
+/**
+ * Find the first delimiter in the bytes [s, end), which may contain NULs.
+ * @return Pointer to the first delimiter, or end
+ */
+char* tokenizer_findBounded (char *s, char *end, int delimiters)
+{
+  char chars[TOKENIZER_NUM_DELIMITERS];
+
+  tokenizer_getDelimiters (delimiters,chars);
+  switch (tokenizer_getKernel ()) {
+#ifdef TOKENIZER_X86
+  case TOKENIZER_KERNEL_AVX2:
+    return tokenizer_findBoundedAvx2 (s,end,chars);
+#endif
+#ifdef __SSE2__
+  case TOKENIZER_KERNEL_SSE2:
+    return tokenizer_findBoundedSse2 (s,end,chars);
+#endif
+  default:
+    return tokenizer_findBoundedScalar (s,end,chars);
+  }
+}
+
+/**
+ * Convert the unsigned decimal at s; leading white space is skipped.
+ * @param[out] end If not NULL, receives the first character not converted
+ * @return The value; like strtoul(), UINT_MAX with errno set to ERANGE if
+ * it does not fit, in which case all digits are still consumed
+ */
+unsigned int tokenizer_parseUnsigned (char *s, char **end)
+{
+  unsigned int value,digit;
+  int overflow;
+
+  while (*s == ' ' || (*s >= '\t' && *s <= '\r')) {
+    s++;
+  }
+  if (*s == '+') {
+    s++;
+  }
+  value = 0;
+  overflow = 0;
+  while ((digit = (unsigned char)(*s - '0')) < 10) {
+    if (value > (UINT_MAX - digit) / 10) {
+      overflow = 1;
+    }
+    else {
+      value = value * 10 + digit;
+    }
+    s++;
+  }
+  if (end != NULL) {
+    *end = s;
+  }
+  if (overflow) {
+    errno = ERANGE;
+    return UINT_MAX;
+  }
+  return value;
+}
+
+/**
+ * Convert the signed decimal at s, accepting the same input as atoi() and
+ * returning the same value, also for numbers out of the range of int.
+ * @param[out] end If not NULL, receives the first character not converted
+ */
+int tokenizer_parseInt (char *s, char **end)
+{
+  unsigned long long value;
+  char *start,*digits;
+  int negative;
+
+  start = s;
+  while (*s == ' ' || (*s >= '\t' && *s <= '\r')) {
+    s++;
+  }
+  negative = *s == '-';
+  if (negative) {
+    s++;
+  }
+  else if (*s == '+') {
+    s++;
+  }
+  value = 0;
+  digits = s;
+  while ((unsigned char)(*s - '0') < 10) {
+    value = value * 10 + (unsigned int)(*s - '0');
+    s++;
+  }
+  // atoi() is (int)strtol(), which saturates at the range of long
+  if (s - digits > 18 || value > LONG_MAX) {
+    return (int)strtol (start,end,10);
+  }
+  if (end != NULL) {
+    *end = s;
+  }
+  return (int)(negative ? -(long)value : (long)value);
+}
+
+/**
+ * Convert the decimal floating-point number at s, accepting the same input
+ * as strtod() except hexadecimal numbers. Numbers with up to 15
+ * significant digits and a decimal exponent within +-22, e.g. "-12.5" or
+ * "1e-3", are converted exactly without calling strtod().
+ * @param[out] end If not NULL, receives the first character not converted
+ */
+double tokenizer_parseDouble (char *s, char **end)
+{
+  static const double powersOf10[] = {
+    1e0,1e1,1e2,1e3,1e4,1e5,1e6,1e7,1e8,1e9,1e10,1e11,
+    1e12,1e13,1e14,1e15,1e16,1e17,1e18,1e19,1e20,1e21,1e22
+  };
+  unsigned long long mantissa;
+  char *p,*digitsStart;
+  int negative,digits,exponent,exponentValue,negativeExponent;
+  double value;
+
+  p = s;
+  while (*p == ' ' || (*p >= '\t' && *p <= '\r')) {
+    p++;
+  }
+  negative = *p == '-';
+  if (*p == '-' || *p == '+') {
+    p++;
+  }
+  mantissa = 0;
+  digits = 0;
+  exponent = 0;
+  digitsStart = p;
+  while ((unsigned char)(*p - '0') < 10) {
+    if (digits < 19) {
+      mantissa = mantissa * 10 + (unsigned int)(*p - '0');
+    }
+    digits += digits > 0 || *p != '0';
+    p++;
+  }
+  if (*p == '.') {
+    p++;
+    while ((unsigned char)(*p - '0') < 10) {
+      if (digits < 19) {
+        mantissa = mantissa * 10 + (unsigned int)(*p - '0');
+        exponent--;
+      }
+      digits += digits > 0 || *p != '0';
+      p++;
+    }
+  }
+  // No digits, e.g. "inf", "nan", "." or invalid input
+  if (p == digitsStart || (p == digitsStart + 1 && *digitsStart == '.')) {
+    return strtod (s,end);
+  }
+  if ((*p == 'e' || *p == 'E') &&
+      ((unsigned char)(p[1] - '0') < 10 ||
+       ((p[1] == '-' || p[1] == '+') && (unsigned char)(p[2] - '0') < 10))) {
+    p++;
+    negativeExponent = *p == '-';
+    if (*p == '-' || *p == '+') {
+      p++;
+    }
+    exponentValue = 0;
+    while ((unsigned char)(*p - '0') < 10) {
+      if (exponentValue < 10000) {
+        exponentValue = exponentValue * 10 + (*p - '0');
+      }
+      p++;
+    }
+    exponent += negativeExponent ? -exponentValue : exponentValue;
+  }
+  // Both operands are exact, so a single multiplication or division is
+  // correctly rounded, as strtod() is
+  if (digits > 15 || exponent < -22 || exponent > 22) {
+    return strtod (s,end);
+  }
+  if (end != NULL) {
+    *end = p;
+  }
+  value = exponent < 0 ? (double)mantissa / powersOf10[-exponent] :
+    (double)mantissa * powersOf10[exponent];
+  return negative ? -value : value;
+}
@@ -0,0 +1,35 @@
+/// @file tokenizer.h
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Delimiter search and number conversion shared by the MRF, SAM, BED and wig
+/// parsers. The search examines 32 (AVX2) or 16 (SSE2) bytes per step; the
+/// kernel is chosen at run time from the features of the CPU, with a
+/// scalar fallback on other architectures.
+
+#ifndef DEF_TOKENIZER_H
+#define DEF_TOKENIZER_H
+
+// delimiters, combined with bitwise OR
+#define TOKENIZER_NEWLINE 0x01
+#define TOKENIZER_TAB 0x02
+#define TOKENIZER_COLON 0x04
+#define TOKENIZER_COMMA 0x08
+#define TOKENIZER_PIPE 0x10
+
+// search kernels
+#define TOKENIZER_KERNEL_SCALAR 0
+#define TOKENIZER_KERNEL_SSE2 1
+#define TOKENIZER_KERNEL_AVX2 2
+
+char* tokenizer_find (char *s, int delimiters);
+char* tokenizer_findBounded (char *s, char *end, int delimiters);
+int tokenizer_parseInt (char *s, char **end);
+double tokenizer_parseDouble (char *s, char **end);
+unsigned int tokenizer_parseUnsigned (char *s, char **end);
+int tokenizer_getKernel (void);
+int tokenizer_setKernel (int kernel);
+
+#endif /* DEF_TOKENIZER_H */
@@ -0,0 +1,316 @@
+/// @file wigParser.c
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Reader for fixedStep and variableStep wig and for bedGraph files. Lines
+/// are located in the mapped file with tokenizer_findBounded(); a final
+/// line without a newline is copied so that numbers are always followed by
+/// a non-digit. Pages of targets already returned are released.
+
+#define _GNU_SOURCE
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <bios/log.h>
+#include <bios/format.h>
+#include <bios/common.h>
+
+#include "wigParser.h"
+#include "tokenizer.h"
+
+#define WIG_MODE_NONE 0
+#define WIG_MODE_FIXED_STEP 1
+#define WIG_MODE_VARIABLE_STEP 2
+#define WIG_MODE_BEDGRAPH 3
+
+static char *mapStart = NULL;
+static char *mapEnd = NULL;
+static char *mapPos = NULL;
+static char *releasedEnd = NULL;
+static size_t mapLength = 0;
+static Stringa targetName = NULL;
+static int mode = WIG_MODE_NONE;
+static int nextStart = 1;
+static int step = 1;
+static int span = 1;
+
+/**
+ * Initialize the wig module.
+ * @param[in] fileName Uncompressed wig or bedGraph file
+ */
+void wigParser_init (char *fileName)
+{
+  struct stat st;
+  int fd;
+
+  if ((fd = open (fileName,O_RDONLY)) < 0) {
+    die ("Unable to open %s",fileName);
+  }
+  if (fstat (fd,&st) != 0) {
+    die ("Unable to stat %s",fileName);
+  }
+  mapLength = (size_t)st.st_size;
+  mapStart = NULL;
+  if (mapLength > 0) {
+    mapStart = mmap (NULL,mapLength,PROT_READ,MAP_PRIVATE,fd,0);
+    if (mapStart == MAP_FAILED) {
+      die ("Unable to map %s",fileName);
+    }
+    madvise (mapStart,mapLength,MADV_SEQUENTIAL);
+  }
+  close (fd);
+  if (mapLength >= 2 && (unsigned char)mapStart[0] == 0x1f &&
+      (unsigned char)mapStart[1] == 0x8b) {
+    die ("Compressed files cannot be mapped: %s",fileName);
+  }
+  mapEnd = mapStart + mapLength;
+  mapPos = mapStart;
+  releasedEnd = mapStart;
+  targetName = stringCreate (100);
+  mode = WIG_MODE_NONE;
+  nextStart = 1;
+  step = 1;
+  span = 1;
+}
+
+/**
+ * Deinitialize the wig module.
+ */
+void wigParser_deInit (void)
+{
+  if (mapLength > 0) {
+    munmap (mapStart,mapLength);
+  }
+  mapStart = mapEnd = mapPos = releasedEnd = NULL;
+  mapLength = 0;
+  stringDestroy (targetName);
+}
+
+// Returns the next line and sets lineEnd to its newline or NUL, or returns
+// NULL at the end
+static char* wigParser_nextLine (char **lineEnd)
+{
+  static Stringa lastLine = NULL;
+  char *line,*end;
+
+  if (mapPos >= mapEnd) {
+    return NULL;
+  }
+  line = mapPos;
+  end = tokenizer_findBounded (line,mapEnd,TOKENIZER_NEWLINE);
+  if (end < mapEnd) {
+    mapPos = end + 1;
+    *lineEnd = end;
+    return line;
+  }
+  mapPos = mapEnd;
+  stringCreateClear (lastLine,100);
+  stringAppendf (lastLine,"%.*s",(int)(end - line),line);
+  *lineEnd = string (lastLine) + stringLen (lastLine);
+  return string (lastLine);
+}
+
+static void wigParser_invalidLine (char *line, char *lineEnd)
+{
+  die ("Invalid wig line: %.*s",(int)(lineEnd - line),line);
+}
+
+// Check that a number was converted and did not extend past the line
+static void wigParser_checkNumber (char *number, char *end, char *line, char *lineEnd)
+{
+  if (end == number || end > lineEnd) {
+    wigParser_invalidLine (line,lineEnd);
+  }
+}
+
+// Apply a fixedStep or variableStep line; returns 0 without applying it if
+// it starts another target while the current one has data
+static int wigParser_processDeclaration (char *line, int hasData)
+{
+  static Stringa buffer = NULL;
+  Texta tokens;
+  char *token,*chrom;
+  int i,newStart,newStep,newSpan;
+
+  stringCreateClear (buffer,100);
+  stringAppendf (buffer,"%.*s",(int)(tokenizer_find (line,TOKENIZER_NEWLINE) - line),line);
+  tokens = textFieldtokP (string (buffer)," \t\r");
+  chrom = NULL;
+  newStart = 1;
+  newStep = 1;
+  newSpan = 1;
+  for (i = 1; i < arrayMax (tokens); i++) {
+    token = textItem (tokens,i);
+    if (strStartsWithC (token,"chrom=")) {
+      chrom = token + 6;
+    }
+    else if (strStartsWithC (token,"start=")) {
+      newStart = atoi (token + 6);
+    }
+    else if (strStartsWithC (token,"step=")) {
+      newStep = atoi (token + 5);
+    }
+    else if (strStartsWithC (token,"span=")) {
+      newSpan = atoi (token + 5);
+    }
+  }
+  if (chrom == NULL || chrom[0] == '\0' || newStep < 1 || newSpan < 1) {
+    die ("Invalid wig declaration: %s",string (buffer));
+  }
+  if (hasData && !strEqual (chrom,string (targetName))) {
+    textDestroy (tokens);
+    return 0;
+  }
+  stringPrintf (targetName,"%s",chrom);
+  mode = strEqual (textItem (tokens,0),"fixedStep") ? WIG_MODE_FIXED_STEP :
+    WIG_MODE_VARIABLE_STEP;
+  nextStart = newStart;
+  step = newStep;
+  span = newSpan;
+  textDestroy (tokens);
+  return 1;
+}
+
+static void wigParser_add (Array output, int asIntervals, int start, int end, float value)
+{
+  WigInterval *currInterval;
+  Wig *currWig;
+  int position;
+
+  if (asIntervals) {
+    if (arrayMax (output) > 0) {
+      currInterval = arrp (output,arrayMax (output) - 1,WigInterval);
+      if (currInterval->end + 1 == start && currInterval->value == value) {
+        currInterval->end = end;
+        return;
+      }
+    }
+    currInterval = arrayp (output,arrayMax (output),WigInterval);
+    currInterval->start = start;
+    currInterval->end = end;
+    currInterval->value = value;
+    return;
+  }
+  for (position = start; position <= end; position++) {
+    currWig = arrayp (output,arrayMax (output),Wig);
+    currWig->position = position;
+    currWig->value = value;
+  }
+}
+
+// Release the mapped pages before the current position
+static void wigParser_releasePages (void)
+{
+  size_t pageSize;
+  char *limit;
+
+  pageSize = (size_t)sysconf (_SC_PAGESIZE);
+  limit = mapStart + (size_t)(mapPos - mapStart) / pageSize * pageSize;
+  if (limit > releasedEnd) {
+    madvise (releasedEnd,limit - releasedEnd,MADV_DONTNEED);
+    releasedEnd = limit;
+  }
+}
+
+static char* wigParser_readTarget (Array output, int asIntervals)
+{
+  char *line,*lineStart,*lineEnd,*tab,*pos,*number;
+  int hasData,start,end;
+  float value;
+
+  arrayClear (output);
+  if (mapLength > 0) {
+    wigParser_releasePages ();
+  }
+  hasData = 0;
+  for (;;) {
+    lineStart = mapPos;
+    if ((line = wigParser_nextLine (&lineEnd)) == NULL) {
+      break;
+    }
+    if (line[0] == '\n' || line[0] == '\r' || line[0] == '\0' || line[0] == '#' ||
+        strStartsWithC (line,"track") || strStartsWithC (line,"browser")) {
+      continue;
+    }
+    if (strStartsWithC (line,"fixedStep") || strStartsWithC (line,"variableStep")) {
+      if (!wigParser_processDeclaration (line,hasData)) {
+        mapPos = lineStart;
+        break;
+      }
+      continue;
+    }
+    if (mode == WIG_MODE_FIXED_STEP) {
+      value = (float)tokenizer_parseDouble (line,&pos);
+      wigParser_checkNumber (line,pos,line,lineEnd);
+      wigParser_add (output,asIntervals,nextStart,nextStart + span - 1,value);
+      nextStart += step;
+    }
+    else if (mode == WIG_MODE_VARIABLE_STEP) {
+      start = tokenizer_parseInt (line,&pos);
+      wigParser_checkNumber (line,pos,line,lineEnd);
+      number = pos;
+      value = (float)tokenizer_parseDouble (number,&pos);
+      wigParser_checkNumber (number,pos,line,lineEnd);
+      wigParser_add (output,asIntervals,start,start + span - 1,value);
+    }
+    else {
+      tab = tokenizer_find (line,TOKENIZER_TAB | TOKENIZER_NEWLINE);
+      if (*tab != '\t') {
+        wigParser_invalidLine (line,lineEnd);
+      }
+      if (!hasData) {
+        stringCreateClear (targetName,100);
+        stringAppendf (targetName,"%.*s",(int)(tab - line),line);
+        mode = WIG_MODE_BEDGRAPH;
+      }
+      else if (stringLen (targetName) != tab - line ||
+               strncmp (string (targetName),line,tab - line) != 0) {
+        mapPos = lineStart;
+        break;
+      }
+      number = tab + 1;
+      start = tokenizer_parseInt (number,&pos);
+      wigParser_checkNumber (number,pos,line,lineEnd);
+      number = pos;
+      end = tokenizer_parseInt (number,&pos);
+      wigParser_checkNumber (number,pos,line,lineEnd);
+      number = pos;
+      value = (float)tokenizer_parseDouble (number,&pos);
+      wigParser_checkNumber (number,pos,line,lineEnd);
+      wigParser_add (output,asIntervals,start + 1,end,value);
+    }
+    hasData = 1;
+  }
+  return hasData ? string (targetName) : NULL;
+}
+
+/**
+ * Read the next target as one Wig per covered position, in file order.
+ * @param[in] wigs Array of Wig that receives the values; it is cleared
+ * @return Target name, or NULL at the end of the file
+ * @pre The module has been initialized using wigParser_init().
+ * @note The memory of the name belongs to this routine.
+ */
+char* wigParser_nextTarget (Array wigs)
+{
+  return wigParser_readTarget (wigs,0);
+}
+
+/**
+ * Read the next target as runs of consecutive positions with the same
+ * value, in file order.
+ * @param[in] intervals Array of WigInterval that receives the runs; it is
+ * cleared
+ * @return Target name, or NULL at the end of the file
+ * @pre The module has been initialized using wigParser_init().
+ * @note The memory of the name belongs to this routine.
+ */
+char* wigParser_nextIntervals (Array intervals)
+{
+  return wigParser_readTarget (intervals,1);
+}
@@ -0,0 +1,37 @@
+/// @file wigParser.h
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Reader for fixedStep and variableStep wig and for bedGraph files.
+///
+/// The file is memory-mapped and returned one target at a time, either as
+/// one Wig per covered position, as used by performSegmentation(), or as
+/// runs of positions with the same value. Positions are 1-based; bedGraph
+/// intervals are converted from 0-based, half-open coordinates. Lines of a
+/// target must be contiguous. Track, browser and comment lines are skipped.
+/// Only uncompressed files can be mapped.
+
+#ifndef DEF_WIG_PARSER_H
+#define DEF_WIG_PARSER_H
+
+#include <bios/format.h>
+
+#include "segmentationUtil.h"
+
+/// @struct WigInterval
+/// @brief Consecutive positions start to end (1-based, inclusive) with the
+/// same value.
+typedef struct {
+  int start;
+  int end;
+  float value;
+} WigInterval;
+
+void wigParser_init (char *fileName);
+void wigParser_deInit (void);
+char* wigParser_nextTarget (Array wigs);
+char* wigParser_nextIntervals (Array intervals);
+
+#endif /* DEF_WIG_PARSER_H */
@@ -0,0 +1,251 @@
+/// @file convertTest.c
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Checks the MRF to SAM writers, including the pair flags, against
+/// hand-written SAM lines, the batch writer against the single-entry
+/// writer, and the SAM to MRF block conversion, which rejects malformed
+/// CIGAR strings.
+
+#define _GNU_SOURCE
+
+#include <bios/log.h>
+#include <bios/format.h>
+
+#include "mrf/convert.h"
+#include "testUtil.h"
+
+static char *fixture =
+  "AlignmentBlocks\tSequence\tQueryId\n"
+  "chr1:+:100:109:3:12,chr1:+:120:129:15:24\tAAAAAAAAAAAAAAAAAAAAAAAAAA\tsingle\n"
+  "chr1:+:100:109:1:10|chr1:-:200:209:1:10\tACGTACGTAC|TTTTTTTTTT\tproper\n"
+  "chr1:-:100:109:1:10|chr1:+:200:209:1:10\tACGTACGTAC|TTTTTTTTTT\toutward\n"
+  "chr1:+:100:109:1:10|chr1:+:200:209:1:10\tACGTACGTAC|TTTTTTTTTT\tsame strand\n"
+  "chr1:+:100:109:1:10|chr2:-:200:209:1:10\tACGTACGTAC|TTTTTTTTTT\tother target\n"
+  "chr1:-:95:120:1:26|chr1:+:100:109:1:10\tCCCCCCCCCCCCCCCCCCCCCCCCCC|GGGGGGGGGG\toverlap\n";
+
+// SAM lines of the entries of the fixture
+static char *expected[] = {
+  "single\t0\tchr1\t100\t255\t2S10M2I10N10M2S\t*\t0\t0\tAAAAAAAAAAAAAAAAAAAAAAAAAA\t*\n",
+  "proper\t99\tchr1\t100\t255\t10M\t=\t200\t110\tACGTACGTAC\t*\n"
+  "proper\t147\tchr1\t200\t255\t10M\t=\t100\t-110\tTTTTTTTTTT\t*\n",
+  "outward\t81\tchr1\t100\t255\t10M\t=\t200\t110\tACGTACGTAC\t*\n"
+  "outward\t161\tchr1\t200\t255\t10M\t=\t100\t-110\tTTTTTTTTTT\t*\n",
+  "same strand\t65\tchr1\t100\t255\t10M\t=\t200\t110\tACGTACGTAC\t*\n"
+  "same strand\t129\tchr1\t200\t255\t10M\t=\t100\t-110\tTTTTTTTTTT\t*\n",
+  "other target\t97\tchr1\t100\t255\t10M\tchr2\t200\t0\tACGTACGTAC\t*\n"
+  "other target\t145\tchr2\t200\t255\t10M\tchr1\t100\t0\tTTTTTTTTTT\t*\n",
+  "overlap\t83\tchr1\t95\t255\t26M\t=\t100\t26\tCCCCCCCCCCCCCCCCCCCCCCCCCC\t*\n"
+  "overlap\t163\tchr1\t100\t255\t10M\t=\t95\t-26\tGGGGGGGGGG\t*\n"
+};
+#define NUM_EXPECTED (int)(sizeof (expected) / sizeof (expected[0]))
+
+static void test_writeSam (void)
+{
+  MrfEntry *currEntry;
+  char buffer[1000],small[10];
+  char *fileName;
+  int i,length;
+
+  fileName = test_writeFile ("fixture.mrf",fixture);
+  mrf_init (fileName);
+  i = 0;
+  while ((currEntry = mrf_nextEntry ()) != NULL) {
+    if (!TEST_CHECK (i < NUM_EXPECTED)) {
+      break;
+    }
+    length = mrfConvert_writeSam (currEntry,buffer,sizeof (buffer));
+    TEST_CHECK_STR (buffer,expected[i]);
+    TEST_CHECK (length == (int)strlen (expected[i]));
+    // A short buffer gets a truncated, terminated prefix
+    TEST_CHECK (mrfConvert_writeSam (currEntry,small,sizeof (small)) == length);
+    TEST_CHECK (strlen (small) == sizeof (small) - 1);
+    TEST_CHECK (strncmp (small,expected[i],sizeof (small) - 1) == 0);
+    i++;
+  }
+  TEST_CHECK (i == NUM_EXPECTED);
+  mrf_deInit ();
+  hlr_free (fileName);
+}
+
+static int test_sameBlocks (Array blocks1, Array blocks2)
+{
+  MrfBlock *block1,*block2;
+  int i;
+
+  if (arrayMax (blocks1) != arrayMax (blocks2)) {
+    return 0;
+  }
+  for (i = 0; i < arrayMax (blocks1); i++) {
+    block1 = arrp (blocks1,i,MrfBlock);
+    block2 = arrp (blocks2,i,MrfBlock);
+    if (!strEqual (block1->targetName,block2->targetName) || block1->strand != block2->strand ||
+        block1->targetStart != block2->targetStart || block1->targetEnd != block2->targetEnd ||
+        block1->queryStart != block2->queryStart || block1->queryEnd != block2->queryEnd) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+// The batch writer produces the lines of the single-entry writer, in order,
+// and converting them back reproduces the blocks
+static void test_writeSamBatch (void)
+{
+  GenConfig config;
+  MrfEntry *currEntry;
+  Array entries;
+  Stringa lines;
+  MrfRead currRead;
+  FILE *fp;
+  char buffer[10000];
+  char *fileName,*samName,*contents;
+  long numWritten;
+  int i,numThreads,ok;
+
+  gen_initConfig (&config);
+  config.numRecords = 2000;
+  config.pairedFraction = 0.5;
+  fileName = test_generate ("generated.mrf",GEN_FORMAT_MRF,&config);
+  entries = arrayCreate (2000,MrfEntry*);
+  lines = stringCreate (100000);
+  mrf_init (fileName);
+  while ((currEntry = mrf_nextDetachedEntry ()) != NULL) {
+    array (entries,arrayMax (entries),MrfEntry*) = currEntry;
+    if (TEST_CHECK (mrfConvert_writeSam (currEntry,buffer,sizeof (buffer)) < (int)sizeof (buffer))) {
+      stringCat (lines,buffer);
+    }
+  }
+  TEST_CHECK (arrayMax (entries) == 2000);
+  for (numThreads = 1; numThreads <= 4; numThreads += 3) {
+    samName = test_path ("batch.sam");
+    if ((fp = fopen (samName,"w")) == NULL) {
+      die ("Unable to create %s",samName);
+    }
+    numWritten = mrfConvert_writeSamBatch (arrp (entries,0,MrfEntry*),arrayMax (entries),numThreads,fp);
+    fclose (fp);
+    contents = test_readFile (samName);
+    TEST_CHECK (numWritten == stringLen (lines));
+    TEST_CHECK (strEqual (contents,string (lines)));
+    hlr_free (contents);
+    hlr_free (samName);
+  }
+
+  samName = test_writeFile ("roundTrip.sam",string (lines));
+  samParser_initFromFile (samName);
+  currRead.blocks = NULL;
+  ok = 1;
+  for (i = 0; i < arrayMax (entries); i++) {
+    currEntry = arru (entries,i,MrfEntry*);
+    mrfConvert_samToRead (samParser_nextEntry (),&currRead);
+    ok = ok && test_sameBlocks (currRead.blocks,currEntry->read1.blocks);
+    if (currEntry->isPairedEnd == 1) {
+      mrfConvert_samToRead (samParser_nextEntry (),&currRead);
+      ok = ok && test_sameBlocks (currRead.blocks,currEntry->read2.blocks);
+    }
+  }
+  TEST_CHECK (ok && samParser_nextEntry () == NULL);
+  samParser_deInit ();
+  arrayDestroy (currRead.blocks);
+  hlr_free (samName);
+  for (i = 0; i < arrayMax (entries); i++) {
+    mrf_freeEntry (arru (entries,i,MrfEntry*));
+  }
+  mrf_deInit ();
+  arrayDestroy (entries);
+  stringDestroy (lines);
+  hlr_free (fileName);
+}
+
+static char *samFixture =
+  "single\t0\tchr1\t100\t255\t2S10M2I10N10M2S\t*\t0\t0\tAAAAAAAAAAAAAAAAAAAAAAAAAA\t*\n"
+  "deletion\t16\tchr2\t100\t255\t5M3D5M\t*\t0\t0\tACGTACGTAC\t*\n"
+  "unmapped\t4\t*\t0\t0\t*\t*\t0\t0\tACGTACGTAC\t*\n";
+
+static void test_samToRead (void)
+{
+  SamEntry *currSamEntry;
+  MrfRead currRead;
+  MrfBlock blocks[1];
+  MrfBlock *currBlock;
+  char *fileName;
+
+  fileName = test_writeFile ("fixture.sam",samFixture);
+  samParser_initFromFile (fileName);
+  currRead.blocks = NULL;
+
+  // The inverse of the MRF to SAM conversion
+  currSamEntry = samParser_nextEntry ();
+  mrfConvert_samToRead (currSamEntry,&currRead);
+  TEST_CHECK (arrayMax (currRead.blocks) == 2);
+  currBlock = arrp (currRead.blocks,0,MrfBlock);
+  TEST_CHECK_STR (currBlock->targetName,"chr1");
+  TEST_CHECK (currBlock->strand == '+');
+  TEST_CHECK (currBlock->targetStart == 100 && currBlock->targetEnd == 109);
+  TEST_CHECK (currBlock->queryStart == 3 && currBlock->queryEnd == 12);
+  currBlock = arrp (currRead.blocks,1,MrfBlock);
+  TEST_CHECK (currBlock->targetStart == 120 && currBlock->targetEnd == 129);
+  TEST_CHECK (currBlock->queryStart == 15 && currBlock->queryEnd == 24);
+  TEST_CHECK_STR (currRead.queryId,"single");
+  TEST_CHECK_STR (currRead.sequence,"AAAAAAAAAAAAAAAAAAAAAAAAAA");
+
+  // A deletion becomes a target gap; only maxBlocks blocks are filled
+  currSamEntry = samParser_nextEntry ();
+  TEST_CHECK (mrfConvert_samToBlocks (currSamEntry,blocks,1) == 2);
+  TEST_CHECK (blocks[0].strand == '-');
+  TEST_CHECK (blocks[0].targetStart == 100 && blocks[0].targetEnd == 104);
+  TEST_CHECK (blocks[0].queryStart == 1 && blocks[0].queryEnd == 5);
+  mrfConvert_samToRead (currSamEntry,&currRead);
+  currBlock = arrp (currRead.blocks,1,MrfBlock);
+  TEST_CHECK (currBlock->targetStart == 108 && currBlock->targetEnd == 112);
+  TEST_CHECK (currBlock->queryStart == 6 && currBlock->queryEnd == 10);
+
+  currSamEntry = samParser_nextEntry ();
+  TEST_CHECK (mrfConvert_samToBlocks (currSamEntry,NULL,0) == 0);
+  mrfConvert_samToRead (currSamEntry,&currRead);
+  TEST_CHECK (arrayMax (currRead.blocks) == 0);
+  TEST_CHECK (samParser_nextEntry () == NULL);
+  samParser_deInit ();
+  arrayDestroy (currRead.blocks);
+  hlr_free (fileName);
+}
+
+// Converts a record with the CIGAR string arg
+static void test_convertCigar (void *arg)
+{
+  Stringa line;
+  char *fileName;
+
+  line = stringCreate (100);
+  stringPrintf (line,"r\t0\tchr1\t100\t255\t%s\t*\t0\t0\tACGTACGTAC\t*\n",(char*)arg);
+  fileName = test_writeFile ("cigar.sam",string (line));
+  samParser_initFromFile (fileName);
+  mrfConvert_samToBlocks (samParser_nextEntry (),NULL,0);
+  samParser_deInit ();
+  stringDestroy (line);
+  hlr_free (fileName);
+}
+
+static void test_invalidCigar (void)
+{
+  TEST_CHECK (!test_dies (test_convertCigar,"5M2I3M"));
+  TEST_CHECK (!test_dies (test_convertCigar,"2147483647N10M"));
+  TEST_CHECK (test_dies (test_convertCigar,"M"));
+  TEST_CHECK (test_dies (test_convertCigar,"5M2IM"));
+  TEST_CHECK (test_dies (test_convertCigar,"5M3"));
+  TEST_CHECK (test_dies (test_convertCigar,"5Q"));
+  TEST_CHECK (test_dies (test_convertCigar,"2147483648N10M"));
+  TEST_CHECK (test_dies (test_convertCigar,"4294967306M"));
+}
+
+int main (int argc, char *argv[])
+{
+  test_init ("convertTest");
+  test_writeSam ();
+  test_writeSamBatch ();
+  test_samToRead ();
+  test_invalidCigar ();
+  return test_finish ();
+}
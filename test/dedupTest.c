@@ -0,0 +1,209 @@
+/// @file dedupTest.c
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Checks the streaming duplicate detection against the definition in
+/// dedup.h, on hand-written entries and on a synthetic file with repeated
+/// entries, in both modes.
+
+#define _GNU_SOURCE
+
+#include <bios/log.h>
+#include <bios/format.h>
+#include <bios/linestream.h>
+
+#include "mrf/dedup.h"
+#include "testUtil.h"
+
+static char *fixture =
+  "AlignmentBlocks\tQueryId\n"
+  "chr1:+:100:149:1:50\tkept\n"
+  "chr1:+:100:149:1:50\tduplicate\n"
+  "chr1:-:100:149:1:50\tstrand differs\n"
+  "chr1:+:100:120:1:21,chr1:+:130:158:22:50\tend differs\n"
+  "chr1:+:100:110:1:11,chr1:+:120:158:12:50\tsame end, other blocks\n"
+  "chr1:+:100:149:1:50|chr1:-:300:349:1:50\tpaired\n"
+  "chr1:+:100:149:1:50|chr1:-:300:349:1:50\tpaired duplicate\n"
+  "chr1:+:100:149:1:50|chr1:-:301:349:1:50\tmate start differs\n"
+  "chr1:+:100:149:1:50|chr2:-:300:349:1:50\tmate target differs\n"
+  "chr1:+:101:150:1:50\tnext start\n"
+  "chr2:+:101:150:1:50\tnext target\n"
+  "chr2:+:101:150:1:50\tduplicate\n";
+
+// Duplicate flags of the entries of the fixture
+static int expected[] = {0,1,0,0,1,0,1,0,0,0,0,1};
+
+// Key of the blocks of a read as defined in dedup.h, for a brute-force check
+static void test_appendKey (Stringa key, char *blocks)
+{
+  char target[256];
+  char *last;
+  char strand;
+  int start,end;
+
+  sscanf (blocks,"%255[^:]:%c:%d",target,&strand,&start);
+  last = strrchr (blocks,',');
+  sscanf (last != NULL ? last + 1 : blocks,"%*[^:]:%*c:%*d:%d",&end);
+  stringAppendf (key,"%s:%c:%d:%d;",target,strand,start,end);
+}
+
+static void test_fixture (int mode)
+{
+  MrfEntry *currEntry;
+  MrfDedupStats stats;
+  int i,isDuplicate,numDuplicates;
+  char *fileName;
+
+  fileName = test_writeFile ("fixture.mrf",fixture);
+  mrf_init (fileName);
+  mrfDedup_init (mode);
+  i = 0;
+  numDuplicates = 0;
+  while ((currEntry = mrfDedup_nextEntry (&isDuplicate)) != NULL) {
+    if (mode == MRF_DEDUP_MARK) {
+      TEST_CHECK (isDuplicate == expected[i]);
+      i++;
+    }
+    else {
+      TEST_CHECK (isDuplicate == 0);
+      i++;
+    }
+    numDuplicates += isDuplicate;
+  }
+  TEST_CHECK (i == (mode == MRF_DEDUP_MARK ? 12 : 8));
+  mrfDedup_getStats (&stats);
+  TEST_CHECK (stats.entries == 12);
+  TEST_CHECK (stats.duplicates == 4);
+  TEST_CHECK (stats.pairedEntries == 4);
+  TEST_CHECK (stats.pairedDuplicates == 1);
+  TEST_CHECK (stats.duplicateRate == 4.0 / 12);
+  mrfDedup_deInit ();
+  mrf_deInit ();
+  hlr_free (fileName);
+}
+
+static int test_compareLines (char **a, char **b)
+{
+  char targetA[256],targetB[256];
+  int startA,startB,diff;
+
+  sscanf (*a,"%255[^:]:%*c:%d",targetA,&startA);
+  sscanf (*b,"%255[^:]:%*c:%d",targetB,&startB);
+  diff = strcmp (targetA,targetB);
+  return diff != 0 ? diff : startA - startB;
+}
+
+// Sorts the entries of a synthetic file, repeats every fifth one and adds
+// many distinct entries at one position, so that the key table grows
+static void test_generated (void)
+{
+  GenConfig config;
+  LineStream ls;
+  MrfEntry *currEntry;
+  MrfDedupStats stats;
+  Stringa contents,key;
+  Texta lines,keys;
+  char *fileName,*line,*copy;
+  int i,n,isDuplicate,numDuplicates,expectedDuplicate;
+
+  gen_initConfig (&config);
+  config.numRecords = 3000;
+  config.columns = MRF_COLUMN_MASK (MRF_COLUMN_TYPE_BLOCKS) |
+    MRF_COLUMN_MASK (MRF_COLUMN_TYPE_QUERY_ID);
+  fileName = test_generate ("generated.mrf",GEN_FORMAT_MRF,&config);
+  lines = textCreate (10000);
+  ls = ls_createFromFile (fileName);
+  while ((line = ls_nextLine (ls)) != NULL) {
+    if (line[0] != '#' && !strStartsWithC (line,"AlignmentBlocks")) {
+      textAdd (lines,line);
+    }
+  }
+  ls_destroy (ls);
+  hlr_free (fileName);
+  arraySort (lines,(ARRAYORDERF)test_compareLines);
+  contents = stringCreate (100000);
+  stringAppendf (contents,"AlignmentBlocks\tQueryId\n");
+  for (n = 0; n < arrayMax (lines); n++) {
+    stringAppendf (contents,"%s\n",textItem (lines,n));
+    if (n % 5 == 0) {
+      stringAppendf (contents,"%s\n",textItem (lines,n));
+    }
+  }
+  for (i = 0; i < 200; i++) {
+    stringAppendf (contents,"chrZ:+:100:%d:1:50\tgrow%d\n",200 + i,i);
+  }
+  textDestroy (lines);
+  fileName = test_writeFile ("repeated.mrf",string (contents));
+  stringDestroy (contents);
+
+  // Brute force: an entry is a duplicate if an earlier entry had its key
+  keys = textCreate (10000);
+  key = stringCreate (100);
+  ls = ls_createFromFile (fileName);
+  mrf_init (fileName);
+  mrfDedup_init (MRF_DEDUP_MARK);
+  numDuplicates = 0;
+  while ((line = ls_nextLine (ls)) != NULL) {
+    if (line[0] == '#' || strStartsWithC (line,"AlignmentBlocks")) {
+      continue;
+    }
+    copy = hlr_strdup (line);
+    *strchr (copy,'\t') = '\0';
+    stringClear (key);
+    if (strchr (copy,'|') != NULL) {
+      *strchr (copy,'|') = '\0';
+      test_appendKey (key,copy);
+      test_appendKey (key,copy + strlen (copy) + 1);
+    }
+    else {
+      test_appendKey (key,copy);
+    }
+    expectedDuplicate = 0;
+    for (i = arrayMax (keys) - 1; i >= 0 && i >= arrayMax (keys) - 500; i--) {
+      if (strEqual (textItem (keys,i),string (key))) {
+        expectedDuplicate = 1;
+        break;
+      }
+    }
+    textAdd (keys,string (key));
+    hlr_free (copy);
+    currEntry = mrfDedup_nextEntry (&isDuplicate);
+    if (!TEST_CHECK (currEntry != NULL)) {
+      break;
+    }
+    TEST_CHECK (isDuplicate == expectedDuplicate);
+    numDuplicates += expectedDuplicate;
+  }
+  TEST_CHECK (mrfDedup_nextEntry (&isDuplicate) == NULL);
+  TEST_CHECK (numDuplicates >= 600);
+  mrfDedup_getStats (&stats);
+  TEST_CHECK (stats.duplicates == numDuplicates);
+  mrfDedup_deInit ();
+  mrf_deInit ();
+  ls_destroy (ls);
+
+  // Removing returns exactly the entries that are not duplicates
+  mrf_init (fileName);
+  mrfDedup_init (MRF_DEDUP_REMOVE);
+  n = 0;
+  while (mrfDedup_nextEntry (NULL) != NULL) {
+    n++;
+  }
+  TEST_CHECK (n == arrayMax (keys) - numDuplicates);
+  mrfDedup_deInit ();
+  mrf_deInit ();
+  textDestroy (keys);
+  stringDestroy (key);
+  hlr_free (fileName);
+}
+
+int main (int argc, char *argv[])
+{
+  test_init ("dedupTest");
+  test_fixture (MRF_DEDUP_MARK);
+  test_fixture (MRF_DEDUP_REMOVE);
+  test_generated ();
+  return test_finish ();
+}
@@ -0,0 +1,189 @@
+/// @file idIndexTest.c
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Checks lookups and batch fetches by read ID against a sequential parse,
+/// including mate IDs, missing IDs, lines longer than the read window and
+/// an unterminated last line, and that a changed MRF file is rejected.
+
+#define _GNU_SOURCE
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include <bios/log.h>
+#include <bios/format.h>
+
+#include "mrf/idIndex.h"
+#include "mrf/mrf.h"
+#include "testUtil.h"
+
+typedef struct {
+  IdIndex *index;
+  char *fileName;
+  Texta ids;
+} FetchArgs;
+
+// Written lines of the fetched entries, separated by newlines
+static char* test_fetch (IdIndex *index, char *fileName, Texta ids)
+{
+  static Stringa buffer = NULL;
+  Array entries;
+  int i;
+
+  stringCreateClear (buffer,1000);
+  entries = mrf_fetchById (index,fileName,ids);
+  for (i = 0; i < arrayMax (entries); i++) {
+    stringAppendf (buffer,"%s\n",mrf_writeEntry (arru (entries,i,MrfEntry*)));
+    mrf_freeEntry (arru (entries,i,MrfEntry*));
+  }
+  arrayDestroy (entries);
+  return string (buffer);
+}
+
+static void test_fetchChild (void *arg)
+{
+  FetchArgs *args;
+
+  args = (FetchArgs*)arg;
+  test_fetch (args->index,args->fileName,args->ids);
+}
+
+static void test_fixture (void)
+{
+  IdIndex *index;
+  Array offsets;
+  Texta ids;
+  Stringa contents,longSequence;
+  FetchArgs args;
+  FILE *fp;
+  struct timespec times[2];
+  char *fileName,*indexFileName;
+  int i;
+
+  longSequence = stringCreate (200000);
+  for (i = 0; i < 150000; i++) {
+    stringCatChar (longSequence,"ACGT"[i % 4]);
+  }
+  contents = stringCreate (300000);
+  stringAppendf (contents,
+                 "# comment\n"
+                 "AlignmentBlocks\tSequence\tQueryId\n"
+                 "chr1:+:1:4:1:4\tACGT\tr1\n"
+                 "chr1:+:1:4:1:4|chr1:-:20:23:1:4\tACGT|TTTT\tp1/1|p1/2\n"
+                 "chr1:+:1:4:1:4|chr1:-:20:23:1:4\tACGT|TTTT\tp2|p2\n"
+                 "\n"
+                 "chr1:+:1:150000:1:150000\t%s\tlong\n"
+                 "chr2:+:1:4:1:4\tCCCC\tlast",string (longSequence));
+  fileName = test_writeFile ("fixture.mrf",string (contents));
+  indexFileName = test_path ("fixture.iidx");
+  idIndex_build (fileName,indexFileName);
+  index = idIndex_open (indexFileName);
+  TEST_CHECK (index->numSlots == 6);
+  TEST_CHECK (index->queryIdColumn == 2);
+
+  offsets = idIndex_lookup (index,"r1");
+  TEST_CHECK (arrayMax (offsets) == 1 && arru (offsets,0,long) == 43);
+  arrayDestroy (offsets);
+  offsets = idIndex_lookup (index,"missing");
+  TEST_CHECK (arrayMax (offsets) == 0);
+  arrayDestroy (offsets);
+
+  mrf_init (fileName);
+  // File order, one entry per line, either mate ID finds a pair
+  ids = textFieldtokP ("last,p1/2,missing,r1,p1/1,p2",",");
+  TEST_CHECK_STR (test_fetch (index,fileName,ids),
+                  "chr1:+:1:4:1:4\tACGT\tr1\n"
+                  "chr1:+:1:4:1:4|chr1:-:20:23:1:4\tACGT|TTTT\tp1/1|p1/2\n"
+                  "chr1:+:1:4:1:4|chr1:-:20:23:1:4\tACGT|TTTT\tp2|p2\n"
+                  "chr2:+:1:4:1:4\tCCCC\tlast\n");
+  textDestroy (ids);
+  // A prefix of an ID is not the ID
+  ids = textFieldtokP ("r,p1,lon,las",",");
+  TEST_CHECK_STR (test_fetch (index,fileName,ids),"");
+  textDestroy (ids);
+  // The window grows for a line longer than one read
+  ids = textFieldtokP ("long,last",",");
+  TEST_CHECK (strlen (test_fetch (index,fileName,ids)) == 25 + 150000 + 6 + 25);
+  textDestroy (ids);
+
+  // Same size, other modification time
+  ids = textFieldtokP ("r1",",");
+  args.index = index;
+  args.fileName = fileName;
+  args.ids = ids;
+  TEST_CHECK (!test_dies (test_fetchChild,&args));
+  if ((fp = fopen (fileName,"w")) == NULL) {
+    die ("Unable to rewrite %s",fileName);
+  }
+  string (contents)[stringLen (contents) - 1] = 'T';
+  fputs (string (contents),fp);
+  fclose (fp);
+  times[0].tv_sec = index->fileMtime + 1;
+  times[0].tv_nsec = index->fileMtimeNsec;
+  times[1] = times[0];
+  if (utimensat (AT_FDCWD,fileName,times,0) != 0) {
+    die ("Unable to set the modification time of %s",fileName);
+  }
+  TEST_CHECK (test_dies (test_fetchChild,&args));
+  textDestroy (ids);
+  mrf_deInit ();
+  idIndex_close (index);
+  stringDestroy (contents);
+  stringDestroy (longSequence);
+  hlr_free (indexFileName);
+  hlr_free (fileName);
+}
+
+// Fetching every seventh ID of a synthetic file returns those entries
+static void test_generated (void)
+{
+  GenConfig config;
+  IdIndex *index;
+  MrfEntry *currEntry;
+  Texta ids;
+  Stringa expected;
+  char *fileName,*indexFileName,*id;
+  int n;
+
+  gen_initConfig (&config);
+  config.numRecords = 20000;
+  config.columns = MRF_COLUMN_MASK (MRF_COLUMN_TYPE_BLOCKS) |
+    MRF_COLUMN_MASK (MRF_COLUMN_TYPE_SEQUENCE) | MRF_COLUMN_MASK (MRF_COLUMN_TYPE_QUERY_ID);
+  fileName = test_generate ("generated.mrf",GEN_FORMAT_MRF,&config);
+  indexFileName = test_path ("generated.iidx");
+  idIndex_build (fileName,indexFileName);
+  index = idIndex_open (indexFileName);
+  ids = textCreate (3000);
+  expected = stringCreate (100000);
+  mrf_init (fileName);
+  n = 0;
+  while ((currEntry = mrf_nextEntry ()) != NULL) {
+    if (n++ % 7 == 0) {
+      id = n % 2 == 0 && currEntry->isPairedEnd ? currEntry->read2.queryId :
+        currEntry->read1.queryId;
+      textAdd (ids,id);
+      stringAppendf (expected,"%s\n",mrf_writeEntry (currEntry));
+    }
+  }
+  mrf_deInit ();
+  TEST_CHECK (index->numSlots >= n);
+  mrf_init (fileName);
+  TEST_CHECK (strEqual (test_fetch (index,fileName,ids),string (expected)));
+  mrf_deInit ();
+  idIndex_close (index);
+  textDestroy (ids);
+  stringDestroy (expected);
+  hlr_free (indexFileName);
+  hlr_free (fileName);
+}
+
+int main (int argc, char *argv[])
+{
+  test_init ("idIndexTest");
+  test_fixture ();
+  test_generated ();
+  return test_finish ();
+}
@@ -0,0 +1,115 @@
+/// @file junctionTest.c
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Checks the junction definition of junction.h on hand-written entries,
+/// the BED output, and that the threaded counter agrees with a single table
+/// on a file with more junctions than the initial table holds.
+
+#define _GNU_SOURCE
+
+#include <bios/log.h>
+#include <bios/format.h>
+
+#include "mrf/junction.h"
+#include "testUtil.h"
+
+static char *fixture =
+  "AlignmentBlocks\tQueryId\n"
+  "chr1:+:100:149:1:50,chr1:+:300:349:51:100\tjunction\n"
+  "chr1:+:120:149:1:30,chr1:+:300:369:31:100\tshorter anchor\n"
+  "chr1:-:100:149:1:50,chr1:-:300:349:51:100\tother strand\n"
+  "chr1:+:100:149:1:50,chr1:+:160:209:51:100\tgap too short\n"
+  "chr1:+:100:149:1:50,chr1:+:300:347:53:100\tquery gap\n"
+  "chr2:+:10:59:1:50,chr2:+:100:149:51:100|chr1:+:130:149:1:20,chr1:+:300:379:21:100\tpaired\n";
+
+static char *expectedBed =
+  "chr1\t149\t299\tJ1\t3\t+\t20\t50\n"
+  "chr1\t149\t299\tJ2\t1\t-\t50\t50\n"
+  "chr2\t59\t99\tJ3\t1\t+\t50\t50\n";
+
+static void test_fixture (void)
+{
+  MrfJunctionTable *table;
+  MrfEntry *currEntry;
+  FILE *fp;
+  char *fileName,*bedName,*contents;
+
+  fileName = test_writeFile ("fixture.mrf",fixture);
+  mrf_init (fileName);
+  table = mrfJunction_createTable (20);
+  while ((currEntry = mrf_nextEntry ()) != NULL) {
+    mrfJunction_addEntry (table,currEntry);
+  }
+  mrf_deInit ();
+  TEST_CHECK (table->numJunctions == 3);
+  bedName = test_path ("junctions.bed");
+  if ((fp = fopen (bedName,"w")) == NULL) {
+    die ("Unable to create %s",bedName);
+  }
+  mrfJunction_writeBed (table,fp);
+  fclose (fp);
+  contents = test_readFile (bedName);
+  TEST_CHECK_STR (contents,expectedBed);
+  mrfJunction_destroyTable (table);
+  hlr_free (contents);
+  hlr_free (bedName);
+  hlr_free (fileName);
+}
+
+// Every junction is supported by two reads with anchors 10 and 25
+static void test_count (void)
+{
+  MrfJunctionTable *table;
+  MrfJunction *currJunction;
+  Array junctions;
+  Stringa contents;
+  char *fileName;
+  int i,k,length,numThreads,numJunctions,ok;
+
+  numJunctions = 5000;
+  contents = stringCreate (100000);
+  stringAppendf (contents,"AlignmentBlocks\tQueryId\n");
+  for (i = 0; i < 2 * numJunctions; i++) {
+    k = i % numJunctions;
+    length = i < numJunctions ? 25 : 10;
+    stringAppendf (contents,"chr%d:+:%d:%d:1:25,chr%d:+:%d:%d:26:%d\tr%d\n",
+                   k % 3,1000 + k,1024 + k,k % 3,2000 + k,2000 + k + length - 1,25 + length,i);
+  }
+  fileName = test_writeFile ("count.mrf",string (contents));
+  stringDestroy (contents);
+  for (numThreads = 1; numThreads <= 4; numThreads += 3) {
+    mrf_init (fileName);
+    table = mrfJunction_count (numThreads,20);
+    mrf_deInit ();
+    TEST_CHECK (table->numJunctions == numJunctions);
+    junctions = mrfJunction_getJunctions (table);
+    ok = arrayMax (junctions) == numJunctions;
+    for (i = 0; ok && i < arrayMax (junctions); i++) {
+      currJunction = arrp (junctions,i,MrfJunction);
+      ok = currJunction->count == 2 && currJunction->minAnchor == 10 &&
+        currJunction->maxAnchor == 25 && currJunction->strand == '+' &&
+        currJunction->acceptor - currJunction->donor == 976;
+      // Sorted by target name, then donor
+      if (ok && i > 0) {
+        ok = strcmp (targetDict_getName (table->targets,(currJunction - 1)->targetId),
+                     targetDict_getName (table->targets,currJunction->targetId)) < 0 ||
+          (currJunction - 1)->donor < currJunction->donor;
+      }
+    }
+    TEST_CHECK (ok);
+    arrayDestroy (junctions);
+    mrfJunction_destroyTable (table);
+  }
+  hlr_free (fileName);
+}
+
+int main (int argc, char *argv[])
+{
+  test_init ("junctionTest");
+  test_fixture ();
+  test_count ();
+  return test_finish ();
+}
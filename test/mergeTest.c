@@ -0,0 +1,213 @@
+/// @file mergeTest.c
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Checks the merge orders of merge.h on hand-written MRF and SAM files,
+/// including the natural name order of samtools sort -n, and that unsorted
+/// or incompatible inputs are rejected.
+
+#define _GNU_SOURCE
+
+#include <bios/log.h>
+#include <bios/format.h>
+
+#include "mrf/merge.h"
+#include "testUtil.h"
+
+static Texta test_files (char *name1, char *contents1, char *name2, char *contents2)
+{
+  Texta fileNames;
+  char *fileName;
+
+  fileNames = textCreate (2);
+  fileName = test_writeFile (name1,contents1);
+  textAdd (fileNames,fileName);
+  hlr_free (fileName);
+  if (name2 != NULL) {
+    fileName = test_writeFile (name2,contents2);
+    textAdd (fileNames,fileName);
+    hlr_free (fileName);
+  }
+  return fileNames;
+}
+
+// QueryIds of the merged MRF entries, separated by commas
+static char* test_mergeMrf (Texta fileNames, int order)
+{
+  static Stringa buffer = NULL;
+  MrfEntry *currEntry;
+
+  stringCreateClear (buffer,100);
+  mrfMerge_initMrf (fileNames,order,MRF_COLUMNS_ALL);
+  while ((currEntry = mrfMerge_nextMrfEntry ()) != NULL) {
+    stringAppendf (buffer,"%s%s",stringLen (buffer) > 0 ? "," : "",currEntry->read1.queryId);
+  }
+  mrfMerge_deInit ();
+  return string (buffer);
+}
+
+// QNAME/FLAG or RNAME:POS of the merged SAM entries
+static char* test_mergeSam (Texta fileNames, int order)
+{
+  static Stringa buffer = NULL;
+  SamEntry *currSamEntry;
+
+  stringCreateClear (buffer,100);
+  mrfMerge_initSam (fileNames,order);
+  while ((currSamEntry = mrfMerge_nextSamEntry ()) != NULL) {
+    if (stringLen (buffer) > 0) {
+      stringCatChar (buffer,',');
+    }
+    if (order == MRF_MERGE_BY_NAME) {
+      stringAppendf (buffer,"%s/%d",currSamEntry->qname,currSamEntry->flags);
+    }
+    else {
+      stringAppendf (buffer,"%s:%d",currSamEntry->rname,currSamEntry->pos);
+    }
+  }
+  mrfMerge_deInit ();
+  return string (buffer);
+}
+
+static void test_mrfByName (void *arg)
+{
+  test_mergeMrf ((Texta)arg,MRF_MERGE_BY_NAME);
+}
+
+static void test_mrfByPosition (void *arg)
+{
+  test_mergeMrf ((Texta)arg,MRF_MERGE_BY_POSITION);
+}
+
+static void test_samByName (void *arg)
+{
+  test_mergeSam ((Texta)arg,MRF_MERGE_BY_NAME);
+}
+
+static void test_samByPosition (void *arg)
+{
+  test_mergeSam ((Texta)arg,MRF_MERGE_BY_POSITION);
+}
+
+static void test_mrf (void)
+{
+  Texta fileNames;
+
+  // Digit runs compare by value; equal entries keep the order of the inputs
+  fileNames = test_files ("a.mrf",
+                          "AlignmentBlocks\tQueryId\n"
+                          "chr1:+:1:10:1:10\tr1\n"
+                          "chr1:+:1:10:1:10\tr2\n"
+                          "chr1:+:1:10:1:10\tr5\n"
+                          "chr1:+:1:10:1:10\tr10\n"
+                          "chr1:+:1:10:1:10\ts5\n",
+                          "b.mrf",
+                          "AlignmentBlocks\tQueryId\n"
+                          "chr2:+:1:10:1:10\tr3\n"
+                          "chr2:+:1:10:1:10\tr5\n"
+                          "chr2:+:1:10:1:10\tr9\n"
+                          "chr2:+:1:10:1:10\tr0010\n"
+                          "chr2:+:1:10:1:10\tr100\n"
+                          "chr2:+:1:10:1:10\ts\n");
+  TEST_CHECK_STR (test_mergeMrf (fileNames,MRF_MERGE_BY_NAME),
+                  "r1,r2,r3,r5,r5,r9,r10,r0010,r100,s,s5");
+  textDestroy (fileNames);
+
+  fileNames = test_files ("a.mrf",
+                          "AlignmentBlocks\tQueryId\n"
+                          "chr1:+:100:109:1:10\ta1\n"
+                          "chr1:+:300:309:1:10\ta2\n"
+                          "chr2:+:50:59:1:10\ta3\n",
+                          "b.mrf",
+                          "# comment\n"
+                          "AlignmentBlocks\tQueryId\n"
+                          "chr1:+:100:109:1:10\tb1\n"
+                          "chr1:+:200:209:1:10\tb2\n"
+                          "chr10:+:5:14:1:10\tb3\n");
+  TEST_CHECK_STR (test_mergeMrf (fileNames,MRF_MERGE_BY_POSITION),"a1,b1,b2,a2,b3,a3");
+  textDestroy (fileNames);
+
+  // In strcmp order, but not in natural order
+  fileNames = test_files ("a.mrf",
+                          "AlignmentBlocks\tQueryId\n"
+                          "chr1:+:1:10:1:10\tr10\n"
+                          "chr1:+:1:10:1:10\tr9\n",
+                          NULL,NULL);
+  TEST_CHECK (test_dies (test_mrfByName,fileNames));
+  textDestroy (fileNames);
+
+  fileNames = test_files ("a.mrf",
+                          "AlignmentBlocks\tQueryId\n"
+                          "chr1:+:1:10:1:10\tr1\n",
+                          "b.mrf",
+                          "AlignmentBlocks\tSequence\tQueryId\n"
+                          "chr1:+:1:10:1:10\tACGTACGTAC\tr2\n");
+  TEST_CHECK (test_dies (test_mrfByPosition,fileNames));
+  textDestroy (fileNames);
+}
+
+static char *samHeader =
+  "@HD\tVN:1.4\tSO:coordinate\n"
+  "@SQ\tSN:chr2\tLN:1000\n"
+  "@SQ\tSN:chr1\tLN:1000\n";
+
+static void test_sam (void)
+{
+  Texta fileNames;
+  Stringa a,b;
+
+  // samtools sort -n puts the first read of a pair before the second
+  fileNames = test_files ("a.sam",
+                          "q1\t65\tchr1\t5\t255\t10M\t=\t50\t55\t*\t*\n"
+                          "q1\t129\tchr1\t50\t255\t10M\t=\t5\t-55\t*\t*\n"
+                          "q10\t0\tchr1\t7\t255\t10M\t*\t0\t0\t*\t*\n",
+                          "b.sam",
+                          "q2\t65\tchr1\t5\t255\t10M\t=\t50\t55\t*\t*\n"
+                          "q2\t129\tchr1\t50\t255\t10M\t=\t5\t-55\t*\t*\n");
+  TEST_CHECK_STR (test_mergeSam (fileNames,MRF_MERGE_BY_NAME),
+                  "q1/65,q1/129,q2/65,q2/129,q10/0");
+  textDestroy (fileNames);
+
+  fileNames = test_files ("a.sam",
+                          "q1\t129\tchr1\t50\t255\t10M\t=\t5\t-55\t*\t*\n"
+                          "q1\t65\tchr1\t5\t255\t10M\t=\t50\t55\t*\t*\n",
+                          NULL,NULL);
+  TEST_CHECK (test_dies (test_samByName,fileNames));
+  textDestroy (fileNames);
+
+  // References in @SQ order, unmapped entries last
+  a = stringCreate (1000);
+  b = stringCreate (1000);
+  stringPrintf (a,"%s%s",samHeader,
+                "a1\t0\tchr2\t10\t255\t10M\t*\t0\t0\t*\t*\n"
+                "a2\t0\tchr1\t5\t255\t10M\t*\t0\t0\t*\t*\n"
+                "a3\t4\t*\t0\t0\t*\t*\t0\t0\t*\t*\n");
+  stringPrintf (b,"%s%s",samHeader,
+                "b1\t0\tchr2\t20\t255\t10M\t*\t0\t0\t*\t*\n"
+                "b2\t0\tchr1\t1\t255\t10M\t*\t0\t0\t*\t*\n");
+  fileNames = test_files ("a.sam",string (a),"b.sam",string (b));
+  TEST_CHECK_STR (test_mergeSam (fileNames,MRF_MERGE_BY_POSITION),
+                  "chr2:10,chr2:20,chr1:1,chr1:5,*:0");
+  mrfMerge_initSam (fileNames,MRF_MERGE_BY_POSITION);
+  TEST_CHECK_STR (mrfMerge_getSamHeader (),samHeader);
+  mrfMerge_deInit ();
+  textDestroy (fileNames);
+
+  stringPrintf (b,"@SQ\tSN:chr1\tLN:1000\n%s",
+                "b1\t0\tchr1\t20\t255\t10M\t*\t0\t0\t*\t*\n");
+  fileNames = test_files ("a.sam",string (a),"b.sam",string (b));
+  TEST_CHECK (test_dies (test_samByPosition,fileNames));
+  textDestroy (fileNames);
+  stringDestroy (a);
+  stringDestroy (b);
+}
+
+int main (int argc, char *argv[])
+{
+  test_init ("mergeTest");
+  test_mrf ();
+  test_sam ();
+  return test_finish ();
+}
@@ -0,0 +1,428 @@
+/// @file parserTest.c
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Checks that the tokenizer-based MRF, SAM and BED parsers return the same
+/// fields as field-by-field parsing with atoi(), as the parsers did before
+/// the tokenizer, with every search kernel the CPU supports. The fixtures
+/// are synthetic files and hand-written files with CRLF line ends, no
+/// final newline, empty mate halves and negative and overflowing numbers.
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <limits.h>
+#include <math.h>
+
+#include <bios/log.h>
+#include <bios/format.h>
+#include <bios/linestream.h>
+
+#include "mrf/mrf.h"
+#include "mrf/mrfUtil.h"
+#include "mrf/sam.h"
+#include "mrf/tokenizer.h"
+#include "testUtil.h"
+
+#define MAX_FIELDS 64
+
+static int keepsCarriageReturn = 0;
+
+static char *numbers[] = {
+  "0","-0","+0","7","-12","+7"," 42x","\t-3,","00012","2147483647","-2147483648",
+  "2147483648","-2147483649","4294967296","4294967306","-4294967306",
+  "9223372036854775807","9223372036854775808","-9223372036854775809",
+  "99999999999999999999","-99999999999999999999","abc","-","+"," ","",NULL
+};
+
+static char *doubles[] = {
+  "0","-0.0","1.5","-12.25","3e5","1e-3","2.5E+2",".5","5.","1e400","-1e-400",
+  "123456789012345678901234","0.1","nan","inf","-","1e","7.e2",NULL
+};
+
+static char *mrfFixture =
+  "# comment\n"
+  "AlignmentBlocks\tSequence\tQualityScores\tQueryId\n"
+  "chr1:+:100:175:1:76\tACGT\tIIII\tr1\n"
+  "chr2:-:-5:4294967306:-1:99999999999999999999|chr2:+:300:375:1:76\tACGT|\t|IIII\tr2|\n"
+  "\n"
+  "AlignmentBlocks\tSequence\tQualityScores\tQueryId\n"
+  "chrX:+:1:2:3:4,chrX:+:10:20:5:15|chrX:-:+7: 8:00009:-0\t|TT\tII|\t|r3b";
+
+static char *samFixture =
+  "@HD\tVN:1.4\tSO:unsorted\n"
+  "r1\t99\tchr1\t100\t60\t76M\t=\t300\t276\tACGT\tIIII\tNM:i:0\tNH:i:1\n"
+  "r2\t4\t*\t0\t0\t*\t*\t0\t0\t*\t*\n"
+  "r3\t-1\tchr2\t-5\t4294967296\t10M\tchr3\t-7\t-250\tAC\t*\n"
+  "r4\t2147483648\tchr2\t99999999999999999999\t-0\t5M\t=\t+12\t 13\t*\tII\tXA:Z:a\tXB:i:-1";
+
+static char *bedFixture =
+  "track name=x\n"
+  "browser position chr1\n"
+  "chr1\t10\t20\n"
+  "chr2\t-5\t4294967306\tname\t0\t+\n"
+  "chr3\t 7\t+8";
+
+// Cut s in place at every separator, keeping empty fields
+static int ref_split (char *s, char separator, char **fields)
+{
+  int n;
+
+  n = 0;
+  fields[n++] = s;
+  while ((s = strchr (s,separator)) != NULL && n < MAX_FIELDS) {
+    *s++ = '\0';
+    fields[n++] = s;
+  }
+  return n;
+}
+
+// Converts line endings of a fixture from LF to CRLF
+static char* ref_toCrlf (char *contents)
+{
+  Stringa s;
+  char *result;
+
+  s = stringCreate (1000);
+  for (; *contents != '\0'; contents++) {
+    if (*contents == '\n') {
+      stringCatChar (s,'\r');
+    }
+    stringCatChar (s,*contents);
+  }
+  stringCat (s,"\r");
+  result = hlr_strdup (string (s));
+  stringDestroy (s);
+  return result;
+}
+
+static void ref_parseBlocks (char *blockString, Array blocks)
+{
+  char *blockFields[MAX_FIELDS];
+  char *fields[MAX_FIELDS];
+  MrfBlock *currBlock;
+  int i,n;
+
+  n = ref_split (blockString,',',blockFields);
+  for (i = 0; i < n; i++) {
+    ref_split (blockFields[i],':',fields);
+    currBlock = arrayp (blocks,arrayMax (blocks),MrfBlock);
+    currBlock->targetName = fields[0];
+    currBlock->strand = fields[1][0];
+    currBlock->targetStart = atoi (fields[2]);
+    currBlock->targetEnd = atoi (fields[3]);
+    currBlock->queryStart = atoi (fields[4]);
+    currBlock->queryEnd = atoi (fields[5]);
+  }
+}
+
+// Field-by-field parse of an entry line, as mrf_nextEntry () used to do it
+static void ref_parseMrfLine (char *line, Texta columnNames, MrfEntry *currEntry)
+{
+  char *fields[MAX_FIELDS];
+  char *column,*mate;
+  int i,n;
+
+  memset (currEntry,0,sizeof (MrfEntry));
+  currEntry->isPairedEnd = strchr (line,'|') != NULL;
+  currEntry->read1.blocks = arrayCreate (2,MrfBlock);
+  currEntry->read2.blocks = arrayCreate (2,MrfBlock);
+  n = ref_split (line,'\t',fields);
+  for (i = 0; i < n && i < arrayMax (columnNames); i++) {
+    column = textItem (columnNames,i);
+    mate = strchr (fields[i],'|');
+    if (mate != NULL) {
+      *mate++ = '\0';
+    }
+    if (strEqual (column,MRF_COLUMN_NAME_BLOCKS)) {
+      ref_parseBlocks (fields[i],currEntry->read1.blocks);
+      if (mate != NULL) {
+        ref_parseBlocks (mate,currEntry->read2.blocks);
+      }
+    }
+    else if (strEqual (column,MRF_COLUMN_NAME_SEQUENCE)) {
+      currEntry->read1.sequence = fields[i];
+      currEntry->read2.sequence = mate;
+    }
+    else if (strEqual (column,MRF_COLUMN_NAME_QUALITY_SCORES)) {
+      currEntry->read1.qualityScores = fields[i];
+      currEntry->read2.qualityScores = mate;
+    }
+    else if (strEqual (column,MRF_COLUMN_NAME_QUERY_ID)) {
+      currEntry->read1.queryId = fields[i];
+      currEntry->read2.queryId = mate;
+    }
+  }
+}
+
+static void test_compareMrfReads (MrfRead *expected, MrfRead *actual)
+{
+  MrfBlock *a,*b;
+  int i;
+
+  if (!TEST_CHECK (arrayMax (expected->blocks) == arrayMax (actual->blocks))) {
+    return;
+  }
+  for (i = 0; i < arrayMax (expected->blocks); i++) {
+    a = arrp (expected->blocks,i,MrfBlock);
+    b = arrp (actual->blocks,i,MrfBlock);
+    TEST_CHECK_STR (a->targetName,b->targetName);
+    TEST_CHECK (a->strand == b->strand);
+    TEST_CHECK (a->targetStart == b->targetStart);
+    TEST_CHECK (a->targetEnd == b->targetEnd);
+    TEST_CHECK (a->queryStart == b->queryStart);
+    TEST_CHECK (a->queryEnd == b->queryEnd);
+  }
+  TEST_CHECK_STR (expected->sequence,actual->sequence);
+  TEST_CHECK_STR (expected->qualityScores,actual->qualityScores);
+  TEST_CHECK_STR (expected->queryId,actual->queryId);
+}
+
+static void test_compareMrf (char *fileName)
+{
+  LineStream ls;
+  MrfEntry expected;
+  MrfEntry *actual;
+  Texta columnNames;
+  char *line,*headerLine;
+  int numEntries;
+
+  ls = ls_createFromFile (fileName);
+  while ((line = ls_nextLine (ls)) != NULL && line[0] == '#') {
+  }
+  headerLine = hlr_strdup (line);
+  columnNames = textFieldtok (headerLine,"\t");
+  mrf_init (fileName);
+  numEntries = 0;
+  while ((line = ls_nextLine (ls)) != NULL) {
+    if (line[0] == '\0' || line[0] == '#' || strEqual (line,headerLine)) {
+      continue;
+    }
+    ref_parseMrfLine (line,columnNames,&expected);
+    actual = mrf_nextEntry ();
+    if (!TEST_CHECK (actual != NULL)) {
+      break;
+    }
+    TEST_CHECK (expected.isPairedEnd == actual->isPairedEnd);
+    test_compareMrfReads (&expected.read1,&actual->read1);
+    if (expected.isPairedEnd && actual->isPairedEnd) {
+      test_compareMrfReads (&expected.read2,&actual->read2);
+    }
+    arrayDestroy (expected.read1.blocks);
+    arrayDestroy (expected.read2.blocks);
+    numEntries++;
+  }
+  TEST_CHECK (mrf_nextEntry () == NULL);
+  TEST_CHECK (numEntries > 0);
+  mrf_deInit ();
+  ls_destroy (ls);
+  textDestroy (columnNames);
+  hlr_free (headerLine);
+}
+
+static void test_initMrf (void *fileName)
+{
+  mrf_init ((char*)fileName);
+}
+
+static void test_compareSam (char *fileName)
+{
+  LineStream ls;
+  SamEntry *actual;
+  char *fields[MAX_FIELDS];
+  char *line,*tags;
+  int n,numEntries;
+
+  ls = ls_createFromFile (fileName);
+  samParser_initFromFile (fileName);
+  numEntries = 0;
+  while ((line = ls_nextLine (ls)) != NULL) {
+    if (line[0] == '@') {
+      continue;
+    }
+    tags = NULL;
+    n = ref_split (line,'\t',fields);
+    if (!TEST_CHECK (n >= 11)) {
+      continue;
+    }
+    if (n > 11) {
+      // The optional fields are kept as the rest of the line
+      tags = fields[11];
+      for (; n > 12; n--) {
+        fields[n - 1][-1] = '\t';
+      }
+    }
+    actual = samParser_nextEntry ();
+    if (!TEST_CHECK (actual != NULL)) {
+      break;
+    }
+    TEST_CHECK_STR (fields[0],actual->qname);
+    TEST_CHECK (atoi (fields[1]) == actual->flags);
+    TEST_CHECK_STR (fields[2],actual->rname);
+    TEST_CHECK (atoi (fields[3]) == actual->pos);
+    TEST_CHECK (atoi (fields[4]) == actual->mapq);
+    TEST_CHECK_STR (fields[5],actual->cigar);
+    TEST_CHECK_STR (fields[6],actual->mrnm);
+    TEST_CHECK (atoi (fields[7]) == actual->mpos);
+    TEST_CHECK (atoi (fields[8]) == actual->isize);
+    TEST_CHECK_STR (strEqual (fields[9],"*") ? NULL : fields[9],actual->seq);
+    TEST_CHECK_STR (strEqual (fields[10],"*") ? NULL : fields[10],actual->qual);
+    TEST_CHECK_STR (tags,actual->tags);
+    numEntries++;
+  }
+  TEST_CHECK (samParser_nextEntry () == NULL);
+  TEST_CHECK (numEntries > 0);
+  samParser_deInit ();
+  ls_destroy (ls);
+}
+
+static void test_compareBed (char *fileName)
+{
+  LineStream ls;
+  Array tars;
+  Tar *currTar;
+  char *fields[MAX_FIELDS];
+  char *line;
+  int i;
+
+  tars = readTarsFromBedFile (fileName);
+  ls = ls_createFromFile (fileName);
+  i = 0;
+  while ((line = ls_nextLine (ls)) != NULL) {
+    if (strStartsWithC (line,"browser") || strStartsWithC (line,"track")) {
+      continue;
+    }
+    ref_split (line,'\t',fields);
+    if (!TEST_CHECK (i < arrayMax (tars))) {
+      break;
+    }
+    currTar = arrp (tars,i,Tar);
+    TEST_CHECK_STR (fields[0],currTar->targetName);
+    TEST_CHECK (atoi (fields[1]) == currTar->start);
+    TEST_CHECK (atoi (fields[2]) == currTar->end);
+    i++;
+  }
+  TEST_CHECK (i == arrayMax (tars));
+  ls_destroy (ls);
+  for (i = 0; i < arrayMax (tars); i++) {
+    hlr_free (arrp (tars,i,Tar)->targetName);
+  }
+  arrayDestroy (tars);
+}
+
+static void test_numbers (void)
+{
+  char *endA,*endB;
+  double a,b;
+  int i;
+
+  for (i = 0; numbers[i] != NULL; i++) {
+    if (!TEST_CHECK (tokenizer_parseInt (numbers[i],NULL) == atoi (numbers[i]))) {
+      fprintf (stderr,"  parseInt (\"%s\")\n",numbers[i]);
+    }
+  }
+  for (i = 0; doubles[i] != NULL; i++) {
+    a = tokenizer_parseDouble (doubles[i],&endA);
+    b = strtod (doubles[i],&endB);
+    if (!TEST_CHECK (((a == b && signbit (a) == signbit (b)) || (isnan (a) && isnan (b))) &&
+                     endA == endB)) {
+      fprintf (stderr,"  parseDouble (\"%s\")\n",doubles[i]);
+    }
+  }
+  TEST_CHECK (tokenizer_parseUnsigned ("4294967295",NULL) == 4294967295u);
+  TEST_CHECK (tokenizer_parseUnsigned (" +17:",&endA) == 17 && *endA == ':');
+  // Overflow saturates and sets errno, like strtoul(), and all digits are consumed
+  errno = 0;
+  TEST_CHECK (tokenizer_parseUnsigned ("4294967295",NULL) == UINT_MAX && errno == 0);
+  TEST_CHECK (tokenizer_parseUnsigned ("4294967296M",&endA) == UINT_MAX && errno == ERANGE &&
+              *endA == 'M');
+  errno = 0;
+  TEST_CHECK (tokenizer_parseUnsigned ("99999999999999999999",NULL) == UINT_MAX && errno == ERANGE);
+}
+
+// Every kernel must find the same delimiter, wherever the string starts
+static void test_kernels (void)
+{
+  static char buffer[512];
+  static const char alphabet[] = "ab\t:,|\nxyz0123";
+  char *s,*expected,*expectedBounded,*end;
+  unsigned int state;
+  int i,k,n,delimiters,length;
+
+  state = 1;
+  for (n = 0; n < 20000; n++) {
+    state = state * 1103515245 + 12345;
+    s = buffer + (state >> 8) % 64;
+    length = (state >> 16) % 300;
+    for (i = 0; i < length; i++) {
+      state = state * 1103515245 + 12345;
+      s[i] = (state >> 16) % 8 != 0 ? 'a' + (state >> 20) % 3 :
+        alphabet[(state >> 20) % (sizeof (alphabet) - 1)];
+    }
+    s[length] = '\0';
+    delimiters = (state >> 24) % 32;
+    end = s + (length > 0 ? (int)((state >> 4) % length) : 0);
+    tokenizer_setKernel (TOKENIZER_KERNEL_SCALAR);
+    expected = tokenizer_find (s,delimiters);
+    expectedBounded = tokenizer_findBounded (s,end,delimiters);
+    for (k = TOKENIZER_KERNEL_SSE2; k <= TOKENIZER_KERNEL_AVX2; k++) {
+      if (tokenizer_setKernel (k)) {
+        TEST_CHECK (tokenizer_find (s,delimiters) == expected);
+        TEST_CHECK (tokenizer_findBounded (s,end,delimiters) == expectedBounded);
+      }
+    }
+  }
+}
+
+int main (int argc, char *argv[])
+{
+  GenConfig config;
+  char *mrfFiles[2],*samFiles[3],*bedFiles[3];
+  char *crlfMrf,*line;
+  LineStream ls;
+  int i,kernel;
+
+  test_init ("parserTest");
+  gen_initConfig (&config);
+  config.numRecords = 2000;
+  config.spliceRate = 0.3;
+  mrfFiles[0] = test_generate ("generated.mrf",GEN_FORMAT_MRF,&config);
+  samFiles[0] = test_generate ("generated.sam",GEN_FORMAT_SAM,&config);
+  bedFiles[0] = test_generate ("generated.bed",GEN_FORMAT_BED,&config);
+  mrfFiles[1] = test_writeFile ("edge.mrf",mrfFixture);
+  samFiles[1] = test_writeFile ("edge.sam",samFixture);
+  samFiles[2] = test_writeFile ("crlf.sam",ref_toCrlf (samFixture));
+  bedFiles[1] = test_writeFile ("edge.bed",bedFixture);
+  bedFiles[2] = test_writeFile ("crlf.bed",ref_toCrlf (bedFixture));
+  crlfMrf = test_writeFile ("crlf.mrf",ref_toCrlf (mrfFixture));
+  ls = ls_createFromFile (crlfMrf);
+  line = ls_nextLine (ls);
+  keepsCarriageReturn = line[strlen (line) - 1] == '\r';
+  ls_destroy (ls);
+
+  test_numbers ();
+  test_kernels ();
+  for (kernel = TOKENIZER_KERNEL_SCALAR; kernel <= TOKENIZER_KERNEL_AVX2; kernel++) {
+    if (!tokenizer_setKernel (kernel)) {
+      continue;
+    }
+    for (i = 0; i < 2; i++) {
+      test_compareMrf (mrfFiles[i]);
+    }
+    for (i = 0; i < 3; i++) {
+      test_compareSam (samFiles[i]);
+      test_compareBed (bedFiles[i]);
+    }
+    // The column names of a CRLF header end in '\r' and are rejected, as
+    // they always were, unless the line reader removes the '\r'
+    if (keepsCarriageReturn) {
+      TEST_CHECK (test_dies (test_initMrf,crlfMrf));
+    }
+    else {
+      test_compareMrf (crlfMrf);
+    }
+  }
+  return test_finish ();
+}
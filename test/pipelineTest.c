@@ -0,0 +1,140 @@
+/// @file pipelineTest.c
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Checks that mrfPipeline_run writes what a sequential loop over
+/// mrf_nextEntry writes, with a transform that drops and modifies entries,
+/// for one and several workers and few batches in flight.
+
+#define _GNU_SOURCE
+
+#include <ctype.h>
+#include <time.h>
+
+#include <bios/log.h>
+#include <bios/format.h>
+
+#include "mrf/mrf.h"
+#include "mrf/pipeline.h"
+#include "testUtil.h"
+
+// Drops every fourth entry by position and lower-cases the sequence of
+// another quarter; returns 0 if the entry is dropped
+static int test_transformEntry (MrfEntry *currEntry)
+{
+  MrfBlock *firstBlock;
+  char *s;
+
+  firstBlock = arrp (currEntry->read1.blocks,0,MrfBlock);
+  if (firstBlock->targetStart % 4 == 0) {
+    return 0;
+  }
+  if (firstBlock->targetStart % 4 == 1) {
+    for (s = currEntry->read1.sequence; *s != '\0'; s++) {
+      *s = tolower (*s);
+    }
+  }
+  return 1;
+}
+
+// Some batches are slow, so that later ones finish first
+static void test_transform (MrfBatch *batch, void *userData)
+{
+  struct timespec delay;
+  int i;
+
+  if (batch->sequence % 3 == 0) {
+    delay.tv_sec = 0;
+    delay.tv_nsec = 200000;
+    nanosleep (&delay,NULL);
+  }
+  for (i = 0; i < batch->numEntries; i++) {
+    batch->keep[i] = test_transformEntry (batch->entries[i]);
+  }
+  __sync_fetch_and_add ((long*)userData,batch->numEntries);
+}
+
+static char* test_sequential (char *fileName, long *numKept)
+{
+  Stringa buffer;
+  MrfEntry *currEntry;
+  char *result;
+
+  buffer = stringCreate (1000000);
+  mrf_init (fileName);
+  *numKept = 0;
+  while ((currEntry = mrf_nextEntry ()) != NULL) {
+    if (test_transformEntry (currEntry)) {
+      stringAppendf (buffer,"%s\n",mrf_writeEntry (currEntry));
+      (*numKept)++;
+    }
+  }
+  mrf_deInit ();
+  result = hlr_strdup (string (buffer));
+  stringDestroy (buffer);
+  return result;
+}
+
+static void test_run (char *fileName, int numWorkers, int batchSize, int numBatches,
+                      char *expected, long expectedKept)
+{
+  MrfPipelineConfig config;
+  FILE *fp;
+  char *outName,*output;
+  long numKept,numSeen;
+
+  mrfPipeline_initConfig (&config);
+  config.numWorkers = numWorkers;
+  config.batchSize = batchSize;
+  config.numBatches = numBatches;
+  outName = test_path ("pipeline.mrf");
+  if ((fp = fopen (outName,"w")) == NULL) {
+    die ("Unable to open %s",outName);
+  }
+  numSeen = 0;
+  mrf_init (fileName);
+  numKept = mrfPipeline_run (&config,test_transform,&numSeen,fp);
+  mrf_deInit ();
+  fclose (fp);
+  output = test_readFile (outName);
+  TEST_CHECK (numKept == expectedKept);
+  TEST_CHECK (strEqual (output,expected));
+  hlr_free (output);
+  hlr_free (outName);
+}
+
+int main (int argc, char *argv[])
+{
+  GenConfig genConfig;
+  MrfPipelineConfig config;
+  char *fileName,*expected;
+  long numKept,numSeen;
+
+  test_init ("pipelineTest");
+  gen_initConfig (&genConfig);
+  genConfig.numRecords = 10000;
+  genConfig.columns = MRF_COLUMN_MASK (MRF_COLUMN_TYPE_BLOCKS) |
+    MRF_COLUMN_MASK (MRF_COLUMN_TYPE_SEQUENCE) | MRF_COLUMN_MASK (MRF_COLUMN_TYPE_QUERY_ID);
+  fileName = test_generate ("generated.mrf",GEN_FORMAT_MRF,&genConfig);
+  expected = test_sequential (fileName,&numKept);
+  TEST_CHECK (numKept > 0 && numKept < genConfig.numRecords);
+
+  test_run (fileName,1,7,1,expected,numKept);
+  test_run (fileName,1,100,3,expected,numKept);
+  test_run (fileName,4,7,2,expected,numKept);
+  test_run (fileName,8,1,3,expected,numKept);
+  test_run (fileName,8,50,16,expected,numKept);
+
+  // Without an output the kept entries are only counted
+  mrfPipeline_initConfig (&config);
+  numSeen = 0;
+  mrf_init (fileName);
+  TEST_CHECK (mrfPipeline_run (&config,test_transform,&numSeen,NULL) == numKept);
+  mrf_deInit ();
+  TEST_CHECK (numSeen == genConfig.numRecords);
+  hlr_free (expected);
+  hlr_free (fileName);
+  return test_finish ();
+}
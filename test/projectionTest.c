@@ -0,0 +1,206 @@
+/// @file projectionTest.c
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Checks column projection in the MRF reader: a blocks-only parse returns
+/// the blocks of a parse of all columns and leaves the other columns NULL,
+/// other projections write only their columns, all columns write the input
+/// back unchanged, and surplus columns are rejected.
+
+#define _GNU_SOURCE
+
+#include <bios/log.h>
+#include <bios/format.h>
+#include <bios/linestream.h>
+
+#include "mrf/mrf.h"
+#include "testUtil.h"
+
+static char *fixture =
+  "# comment\n"
+  "AlignmentBlocks\tSequence\tQualityScores\tQueryId\n"
+  "chr1:+:1:4:1:4\tACGT\tIIII\tr1\n"
+  "chr1:+:1:2:1:2,chr1:+:10:11:3:4\tACGT\tII#I\tr2\n"
+  "chr1:+:1:4:1:4|chr2:-:20:23:1:4\tACGT|TTTT\tIIII|####\tp1/1|p1/2\n"
+  "chr1:+:5:8:1:4\tGGGG\tIIII\tr3\n";
+
+// Blocks of an entry as written by mrf_writeEntry ()
+static char* test_blocks (MrfEntry *currEntry)
+{
+  static Stringa buffer = NULL;
+  MrfRead *currRead;
+  MrfBlock *currBlock;
+  int i,j;
+
+  stringCreateClear (buffer,100);
+  for (i = 0; i < 1 + (currEntry->isPairedEnd == 1); i++) {
+    currRead = i == 0 ? &currEntry->read1 : &currEntry->read2;
+    if (i > 0) {
+      stringCatChar (buffer,'|');
+    }
+    for (j = 0; j < arrayMax (currRead->blocks); j++) {
+      currBlock = arrp (currRead->blocks,j,MrfBlock);
+      stringAppendf (buffer,"%s%s:%c:%d:%d:%d:%d",j > 0 ? "," : "",currBlock->targetName,
+                     currBlock->strand,currBlock->targetStart,currBlock->targetEnd,
+                     currBlock->queryStart,currBlock->queryEnd);
+    }
+  }
+  return string (buffer);
+}
+
+// Header and entries written after reading a file with a projection
+static char* test_write (char *fileName, int columns)
+{
+  static Stringa buffer = NULL;
+  MrfEntry *currEntry;
+
+  stringCreateClear (buffer,100);
+  mrf_initWithColumns (fileName,columns);
+  stringAppendf (buffer,"%s\n",mrf_writeHeader ());
+  while ((currEntry = mrf_nextEntry ()) != NULL) {
+    stringAppendf (buffer,"%s\n",mrf_writeEntry (currEntry));
+  }
+  mrf_deInit ();
+  return string (buffer);
+}
+
+static void test_readAll (void *arg)
+{
+  test_write ((char*)arg,MRF_COLUMNS_ALL);
+}
+
+static void test_readBlocks (void *arg)
+{
+  test_write ((char*)arg,MRF_COLUMN_MASK (MRF_COLUMN_TYPE_BLOCKS));
+}
+
+static void test_fixture (void)
+{
+  MrfEntry *currEntry;
+  char *fileName;
+  int numEntries;
+
+  fileName = test_writeFile ("fixture.mrf",fixture);
+  TEST_CHECK_STR (test_write (fileName,MRF_COLUMNS_ALL),fixture);
+  TEST_CHECK_STR (test_write (fileName,MRF_COLUMN_MASK (MRF_COLUMN_TYPE_BLOCKS)),
+                  "# comment\n"
+                  "AlignmentBlocks\n"
+                  "chr1:+:1:4:1:4\n"
+                  "chr1:+:1:2:1:2,chr1:+:10:11:3:4\n"
+                  "chr1:+:1:4:1:4|chr2:-:20:23:1:4\n"
+                  "chr1:+:5:8:1:4\n");
+  // AlignmentBlocks are always loaded
+  TEST_CHECK_STR (test_write (fileName,MRF_COLUMN_MASK (MRF_COLUMN_TYPE_QUERY_ID)),
+                  "# comment\n"
+                  "AlignmentBlocks\tQueryId\n"
+                  "chr1:+:1:4:1:4\tr1\n"
+                  "chr1:+:1:2:1:2,chr1:+:10:11:3:4\tr2\n"
+                  "chr1:+:1:4:1:4|chr2:-:20:23:1:4\tp1/1|p1/2\n"
+                  "chr1:+:5:8:1:4\tr3\n");
+
+  mrf_initWithColumns (fileName,MRF_COLUMN_MASK (MRF_COLUMN_TYPE_SEQUENCE));
+  numEntries = 0;
+  while ((currEntry = mrf_nextEntry ()) != NULL) {
+    numEntries++;
+    TEST_CHECK (currEntry->read1.sequence != NULL);
+    TEST_CHECK (currEntry->read1.qualityScores == NULL && currEntry->read1.queryId == NULL);
+    TEST_CHECK (currEntry->isPairedEnd != 1 ||
+                (currEntry->read2.qualityScores == NULL && currEntry->read2.queryId == NULL));
+  }
+  mrf_deInit ();
+  TEST_CHECK (numEntries == 4);
+  hlr_free (fileName);
+
+  // Only the blocks make an entry paired; the other columns of a single-end
+  // entry are still split at '|', and both halves are freed
+  fileName = test_writeFile ("pipe.mrf",
+                             "AlignmentBlocks\tSequence\tQueryId\n"
+                             "chr1:+:1:4:1:4\tAC|GT\tread|x\n"
+                             "chr1:+:1:4:1:4\tACGT\tr2\n");
+  mrf_init (fileName);
+  currEntry = mrf_nextEntry ();
+  TEST_CHECK (currEntry != NULL && currEntry->isPairedEnd != 1);
+  TEST_CHECK_STR (currEntry->read1.queryId,"read");
+  currEntry = mrf_nextEntry ();
+  TEST_CHECK (currEntry != NULL && currEntry->read2.queryId == NULL);
+  TEST_CHECK (mrf_nextEntry () == NULL);
+  mrf_deInit ();
+  hlr_free (fileName);
+
+  // A surplus column is found only if the last column is requested
+  fileName = test_writeFile ("surplus.mrf",
+                             "AlignmentBlocks\tQueryId\n"
+                             "chr1:+:1:4:1:4\tr1\textra\n");
+  TEST_CHECK (test_dies (test_readAll,fileName));
+  TEST_CHECK (!test_dies (test_readBlocks,fileName));
+  hlr_free (fileName);
+  fileName = test_writeFile ("surplus.mrf",
+                             "AlignmentBlocks\n"
+                             "chr1:+:1:4:1:4\textra\n");
+  TEST_CHECK (test_dies (test_readBlocks,fileName));
+  hlr_free (fileName);
+}
+
+// Blocks-only parses return the blocks of full parses of a synthetic file
+static void test_generated (void)
+{
+  GenConfig config;
+  LineStream ls;
+  MrfEntry *currEntry;
+  Texta blocks,lines;
+  char *fileName,*line;
+  int i,ok;
+
+  gen_initConfig (&config);
+  config.numRecords = 5000;
+  config.columns = MRF_COLUMN_MASK (MRF_COLUMN_TYPE_BLOCKS) |
+    MRF_COLUMN_MASK (MRF_COLUMN_TYPE_SEQUENCE) | MRF_COLUMN_MASK (MRF_COLUMN_TYPE_QUALITY_SCORES) |
+    MRF_COLUMN_MASK (MRF_COLUMN_TYPE_QUERY_ID);
+  fileName = test_generate ("generated.mrf",GEN_FORMAT_MRF,&config);
+  lines = textCreate (config.numRecords);
+  ls = ls_createFromFile (fileName);
+  while ((line = ls_nextLine (ls)) != NULL) {
+    if (line[0] != '#' && !strStartsWithC (line,MRF_COLUMN_NAME_BLOCKS)) {
+      textAdd (lines,line);
+    }
+  }
+  ls_destroy (ls);
+
+  blocks = textCreate (config.numRecords);
+  mrf_init (fileName);
+  ok = 1;
+  i = 0;
+  while ((currEntry = mrf_nextEntry ()) != NULL) {
+    ok = ok && i < arrayMax (lines) && strEqual (mrf_writeEntry (currEntry),textItem (lines,i));
+    textAdd (blocks,test_blocks (currEntry));
+    i++;
+  }
+  mrf_deInit ();
+  TEST_CHECK (ok && i == arrayMax (lines));
+
+  mrf_initWithColumns (fileName,MRF_COLUMN_MASK (MRF_COLUMN_TYPE_BLOCKS));
+  ok = 1;
+  i = 0;
+  while ((currEntry = mrf_nextEntry ()) != NULL) {
+    ok = ok && i < arrayMax (blocks) && strEqual (test_blocks (currEntry),textItem (blocks,i)) &&
+      strEqual (mrf_writeEntry (currEntry),textItem (blocks,i)) &&
+      currEntry->read1.sequence == NULL && currEntry->read1.qualityScores == NULL &&
+      currEntry->read1.queryId == NULL && currEntry->read2.queryId == NULL;
+    i++;
+  }
+  mrf_deInit ();
+  TEST_CHECK (ok && i == arrayMax (blocks));
+  textDestroy (blocks);
+  textDestroy (lines);
+  hlr_free (fileName);
+}
+
+int main (int argc, char *argv[])
+{
+  test_init ("projectionTest");
+  test_fixture ();
+  test_generated ();
+  return test_finish ();
+}
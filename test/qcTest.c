@@ -0,0 +1,210 @@
+/// @file qcTest.c
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Checks the QC statistics against counts made one base at a time, on a
+/// hand-written file and on random reads of varying length, for the
+/// single-threaded accumulator and for mrfQc_run().
+
+#define _GNU_SOURCE
+
+#include <bios/log.h>
+#include <bios/format.h>
+
+#include "mrf/qc.h"
+#include "testUtil.h"
+
+#define NUM_READS 3000
+
+static char *fixture =
+  "AlignmentBlocks\tSequence\tQualityScores\n"
+  "chr1:+:1:4:1:4\tACGT\tII#~\n"
+  "chr1:+:1:2:1:2,chr1:+:10:11:3:4\tggnN\t!!! \n"
+  "chr1:+:1:3:1:3|chr1:-:20:22:1:3\tGCG|AAA\tIII|III\n";
+
+// Equal if the shorter Array is the longer one with trailing zeros removed
+static int test_equalCounts (Array a, Array b)
+{
+  long countA,countB;
+  int i;
+
+  for (i = 0; i < arrayMax (a) || i < arrayMax (b); i++) {
+    countA = i < arrayMax (a) ? arru (a,i,long) : 0;
+    countB = i < arrayMax (b) ? arru (b,i,long) : 0;
+    if (countA != countB) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+static void test_fixture (void)
+{
+  MrfQc *qc;
+  MrfEntry *currEntry;
+  long *counts;
+  char *fileName;
+
+  fileName = test_writeFile ("fixture.mrf",fixture);
+  mrf_init (fileName);
+  qc = mrfQc_create ();
+  while ((currEntry = mrf_nextEntry ()) != NULL) {
+    mrfQc_addEntry (qc,currEntry);
+  }
+  mrf_deInit ();
+  mrfQc_flush (qc);
+  TEST_CHECK (qc->entries == 3 && qc->pairedEntries == 1);
+  TEST_CHECK (qc->read1.reads == 3 && qc->read2.reads == 1);
+  TEST_CHECK (qc->read1.bases == 11 && qc->read1.gcBases == 7 && qc->read1.nBases == 2);
+  TEST_CHECK (qc->read2.bases == 3 && qc->read2.gcBases == 0);
+
+  // Cycle 1 holds A, g and G; cycle 3 holds G, n and G; cases are folded
+  counts = arrp (qc->read1.baseCounts,0,long);
+  TEST_CHECK (counts[MRF_QC_BASE_A] == 1 && counts[MRF_QC_BASE_G] == 2);
+  counts = arrp (qc->read1.baseCounts,2 * MRF_QC_NUM_BASES,long);
+  TEST_CHECK (counts[MRF_QC_BASE_G] == 2 && counts[MRF_QC_BASE_N] == 1);
+  TEST_CHECK (arrayMax (qc->read1.baseCounts) == 4 * MRF_QC_NUM_BASES);
+
+  // Qualities below '!' count as 0 and above Phred 63 as 63
+  TEST_CHECK (qc->read1.qualityBases == 11);
+  TEST_CHECK (qc->read1.qualitySum == 40 + 40 + 2 + 63 + 40 + 40 + 40);
+  counts = arrp (qc->read1.qualityCounts,3 * MRF_QC_NUM_QUALITIES,long);
+  TEST_CHECK (counts[0] == 1 && counts[MRF_QC_NUM_QUALITIES - 1] == 1);
+
+  TEST_CHECK (arru (qc->read1.lengthCounts,4,long) == 2 &&
+              arru (qc->read1.lengthCounts,3,long) == 1);
+  TEST_CHECK (arru (qc->read1.blockCounts,1,long) == 2 &&
+              arru (qc->read1.blockCounts,2,long) == 1);
+  // GC content over called bases: 50%, 100% and 100%
+  TEST_CHECK (arru (qc->read1.gcCounts,50,long) == 1 &&
+              arru (qc->read1.gcCounts,100,long) == 2);
+  TEST_CHECK (arru (qc->read2.gcCounts,0,long) == 1);
+  mrfQc_destroy (qc);
+  hlr_free (fileName);
+}
+
+// Expected statistics of read1, counted one base at a time
+typedef struct {
+  long bases,gcBases,nBases,qualityBases,qualitySum;
+  Array baseCounts,qualityCounts,lengthCounts,gcCounts;
+} Expected;
+
+static void test_increment (Array counts, int index)
+{
+  while (arrayMax (counts) <= index) {
+    array (counts,arrayMax (counts),long) = 0;
+  }
+  arru (counts,index,long)++;
+}
+
+static void test_checkStats (MrfQc *qc, Expected *expected)
+{
+  MrfQcReadStats *stats;
+
+  mrfQc_flush (qc);
+  stats = &qc->read1;
+  TEST_CHECK (qc->entries == NUM_READS && stats->reads == NUM_READS);
+  TEST_CHECK (stats->bases == expected->bases && stats->gcBases == expected->gcBases &&
+              stats->nBases == expected->nBases);
+  TEST_CHECK (stats->qualityBases == expected->qualityBases &&
+              stats->qualitySum == expected->qualitySum);
+  TEST_CHECK (test_equalCounts (stats->baseCounts,expected->baseCounts));
+  TEST_CHECK (test_equalCounts (stats->qualityCounts,expected->qualityCounts));
+  TEST_CHECK (test_equalCounts (stats->lengthCounts,expected->lengthCounts));
+  TEST_CHECK (test_equalCounts (stats->gcCounts,expected->gcCounts));
+}
+
+// Reads get longer and shorter, so the counters are extended between and
+// flushed at every 255 reads
+static void test_random (void)
+{
+  static const char letters[] = "ACGTNacgtnX";
+  Expected expected;
+  Stringa contents,sequence,qualities;
+  MrfQc *qc;
+  MrfEntry *currEntry;
+  char *fileName;
+  int i,j,length,base,quality,gc,called,numThreads;
+
+  memset (&expected,0,sizeof (Expected));
+  expected.baseCounts = arrayCreate (1000,long);
+  expected.qualityCounts = arrayCreate (10000,long);
+  expected.lengthCounts = arrayCreate (300,long);
+  expected.gcCounts = arrayCreate (101,long);
+  contents = stringCreate (100000);
+  sequence = stringCreate (300);
+  qualities = stringCreate (300);
+  stringAppendf (contents,"AlignmentBlocks\tSequence\tQualityScores\n");
+  srand (17);
+  for (i = 0; i < NUM_READS; i++) {
+    length = 1 + (i * 37 + rand () % 50) % 290;
+    stringClear (sequence);
+    stringClear (qualities);
+    gc = called = 0;
+    for (j = 0; j < length; j++) {
+      stringCatChar (sequence,letters[rand () % (sizeof (letters) - 1)]);
+      switch (string (sequence)[j] | 0x20) {
+      case 'a': base = MRF_QC_BASE_A; break;
+      case 'c': base = MRF_QC_BASE_C; break;
+      case 'g': base = MRF_QC_BASE_G; break;
+      case 't': base = MRF_QC_BASE_T; break;
+      default: base = MRF_QC_BASE_N;
+      }
+      test_increment (expected.baseCounts,j * MRF_QC_NUM_BASES + base);
+      gc += base == MRF_QC_BASE_C || base == MRF_QC_BASE_G;
+      called += base != MRF_QC_BASE_N;
+      quality = rand () % 80;
+      stringCatChar (qualities,'!' + quality);
+      if (quality >= MRF_QC_NUM_QUALITIES) {
+        quality = MRF_QC_NUM_QUALITIES - 1;
+      }
+      test_increment (expected.qualityCounts,j * MRF_QC_NUM_QUALITIES + quality);
+      expected.qualitySum += quality;
+    }
+    expected.bases += length;
+    expected.gcBases += gc;
+    expected.nBases += length - called;
+    expected.qualityBases += length;
+    test_increment (expected.lengthCounts,length);
+    if (called > 0) {
+      test_increment (expected.gcCounts,(200 * gc + called) / (2 * called));
+    }
+    stringAppendf (contents,"chr1:+:1:%d:1:%d\t%s\t%s\n",length,length,
+                   string (sequence),string (qualities));
+  }
+  fileName = test_writeFile ("random.mrf",string (contents));
+  stringDestroy (contents);
+  stringDestroy (sequence);
+  stringDestroy (qualities);
+
+  mrf_init (fileName);
+  qc = mrfQc_create ();
+  while ((currEntry = mrf_nextEntry ()) != NULL) {
+    mrfQc_addEntry (qc,currEntry);
+  }
+  mrf_deInit ();
+  test_checkStats (qc,&expected);
+  mrfQc_destroy (qc);
+  for (numThreads = 1; numThreads <= 4; numThreads += 3) {
+    mrf_init (fileName);
+    qc = mrfQc_run (numThreads);
+    mrf_deInit ();
+    test_checkStats (qc,&expected);
+    mrfQc_destroy (qc);
+  }
+  arrayDestroy (expected.baseCounts);
+  arrayDestroy (expected.qualityCounts);
+  arrayDestroy (expected.lengthCounts);
+  arrayDestroy (expected.gcCounts);
+  hlr_free (fileName);
+}
+
+int main (int argc, char *argv[])
+{
+  test_init ("qcTest");
+  test_fixture ();
+  test_random ();
+  return test_finish ();
+}
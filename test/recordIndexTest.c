@@ -0,0 +1,236 @@
+/// @file recordIndexTest.c
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Checks that the record index counts records like the parsers, that
+/// seeking to a record yields the entry a sequential parse returns at that
+/// position, that partitions cover all records, and that an index is
+/// rejected once its file has changed.
+
+#define _GNU_SOURCE
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include <bios/log.h>
+#include <bios/format.h>
+
+#include "mrf/recordIndex.h"
+#include "mrf/mrf.h"
+#include "mrf/sam.h"
+#include "testUtil.h"
+
+#define INTERVAL 7
+
+typedef struct {
+  RecordIndex *index;
+  char *fileName;
+} SeekArgs;
+
+static void test_seek (void *arg)
+{
+  SeekArgs *args;
+  long numSkipped;
+
+  args = (SeekArgs*)arg;
+  recordIndex_getSeekCommand (args->index,args->fileName,0,&numSkipped);
+}
+
+static void test_readSam (void *arg)
+{
+  samParser_initFromFile ((char*)arg);
+  while (samParser_nextEntry () != NULL) {
+  }
+}
+
+// Only the lines the parsers return are records
+static void test_skipRules (void)
+{
+  RecordIndex *index;
+  char *fileName;
+
+  fileName = test_writeFile ("skip.mrf",
+                             "# comment\n"
+                             "AlignmentBlocks\tQueryId\n"
+                             "chr1:+:1:10:1:10\tr1\n"
+                             "\n"
+                             "# comment\n"
+                             "AlignmentBlocks\tQueryId\n"
+                             "chr1:+:1:10:1:10\tr2\n");
+  index = recordIndex_build (fileName,RECORD_INDEX_MRF,1);
+  TEST_CHECK (index->numRecords == 2);
+  TEST_CHECK (index->headerLength == 34);
+  recordIndex_destroy (index);
+  hlr_free (fileName);
+
+  fileName = test_writeFile ("skip.sam",
+                             "@HD\tVN:1.4\n"
+                             "r1\t0\tchr1\t1\t255\t10M\t*\t0\t0\t*\t*\n"
+                             "@CO\tcomment\n"
+                             "r2\t0\tchr1\t1\t255\t10M\t*\t0\t0\t*\t*\n");
+  index = recordIndex_build (fileName,RECORD_INDEX_SAM,1);
+  TEST_CHECK (index->numRecords == 2);
+  recordIndex_destroy (index);
+  hlr_free (fileName);
+
+  // The SAM parser rejects an empty line, so it is not skipped either
+  fileName = test_writeFile ("empty.sam",
+                             "r1\t0\tchr1\t1\t255\t10M\t*\t0\t0\t*\t*\n"
+                             "\n"
+                             "r2\t0\tchr1\t1\t255\t10M\t*\t0\t0\t*\t*\n");
+  index = recordIndex_build (fileName,RECORD_INDEX_SAM,1);
+  TEST_CHECK (index->numRecords == 3);
+  TEST_CHECK (test_dies (test_readSam,fileName));
+  recordIndex_destroy (index);
+  hlr_free (fileName);
+}
+
+// Entries of a sequential parse, as written by the parser
+static Texta test_readAll (char *fileName, int format)
+{
+  Texta entries;
+  MrfEntry *currEntry;
+  SamEntry *currSamEntry;
+
+  entries = textCreate (1000);
+  if (format == RECORD_INDEX_MRF) {
+    mrf_init (fileName);
+    while ((currEntry = mrf_nextEntry ()) != NULL) {
+      textAdd (entries,mrf_writeEntry (currEntry));
+    }
+    mrf_deInit ();
+  }
+  else {
+    samParser_initFromFile (fileName);
+    while ((currSamEntry = samParser_nextEntry ()) != NULL) {
+      textAdd (entries,samParser_writeEntry (currSamEntry));
+    }
+    samParser_deInit ();
+  }
+  return entries;
+}
+
+static void test_seekFormat (int format)
+{
+  GenConfig config;
+  RecordIndex *index,*copy;
+  RecordPartition *currPartition;
+  MrfEntry *currEntry;
+  SamEntry *currSamEntry;
+  Array partitions;
+  Texta entries;
+  char *fileName,*indexFileName,*actual;
+  long records[] = {0,1,6,7,8,13,14,500,998,999,1000};
+  long record,nextRecord;
+  int i,ok;
+
+  gen_initConfig (&config);
+  config.numRecords = 1000;
+  fileName = test_generate (format == RECORD_INDEX_MRF ? "seek.mrf" : "seek.sam",
+                            format == RECORD_INDEX_MRF ? GEN_FORMAT_MRF : GEN_FORMAT_SAM,&config);
+  entries = test_readAll (fileName,format);
+  index = recordIndex_build (fileName,format,INTERVAL);
+  TEST_CHECK (index->numRecords == arrayMax (entries));
+  TEST_CHECK (arrayMax (index->offsets) == (arrayMax (entries) + INTERVAL - 1) / INTERVAL);
+
+  // The sidecar file holds the same index
+  indexFileName = test_path ("seek.ridx");
+  recordIndex_write (index,indexFileName);
+  copy = recordIndex_read (indexFileName);
+  TEST_CHECK (copy->format == format && copy->interval == INTERVAL &&
+              copy->numRecords == index->numRecords && copy->fileSize == index->fileSize &&
+              copy->fileMtime == index->fileMtime &&
+              copy->fileMtimeNsec == index->fileMtimeNsec &&
+              copy->headerLength == index->headerLength);
+  ok = arrayMax (copy->offsets) == arrayMax (index->offsets);
+  for (i = 0; ok && i < arrayMax (index->offsets); i++) {
+    ok = arru (copy->offsets,i,long) == arru (index->offsets,i,long);
+  }
+  TEST_CHECK (ok);
+  recordIndex_destroy (copy);
+
+  for (i = 0; i < (int)(sizeof (records) / sizeof (records[0])); i++) {
+    record = records[i];
+    if (format == RECORD_INDEX_MRF) {
+      recordIndex_initMrf (index,fileName,record,MRF_COLUMNS_ALL);
+      currEntry = mrf_nextEntry ();
+      actual = currEntry != NULL ? mrf_writeEntry (currEntry) : NULL;
+    }
+    else {
+      recordIndex_initSam (index,fileName,record);
+      currSamEntry = samParser_nextEntry ();
+      actual = currSamEntry != NULL ? samParser_writeEntry (currSamEntry) : NULL;
+    }
+    TEST_CHECK_STR (actual,record < arrayMax (entries) ? textItem (entries,record) : NULL);
+    if (format == RECORD_INDEX_MRF) {
+      mrf_deInit ();
+    }
+    else {
+      samParser_deInit ();
+    }
+  }
+
+  // Partitions start at checkpoints and cover all records
+  partitions = recordIndex_partition (index,4);
+  TEST_CHECK (arrayMax (partitions) == 4);
+  nextRecord = 0;
+  ok = 1;
+  for (i = 0; i < arrayMax (partitions); i++) {
+    currPartition = arrp (partitions,i,RecordPartition);
+    ok = ok && currPartition->firstRecord == nextRecord &&
+      currPartition->firstRecord % INTERVAL == 0 && currPartition->numRecords > 0 &&
+      currPartition->offset == arru (index->offsets,currPartition->firstRecord / INTERVAL,long);
+    nextRecord += currPartition->numRecords;
+  }
+  TEST_CHECK (ok && nextRecord == index->numRecords);
+  arrayDestroy (partitions);
+  recordIndex_destroy (index);
+  textDestroy (entries);
+  hlr_free (indexFileName);
+  hlr_free (fileName);
+}
+
+// A file of the same size but with another modification time is rejected
+static void test_stale (void)
+{
+  RecordIndex *index;
+  SeekArgs args;
+  struct timespec times[2];
+  char *fileName;
+  FILE *fp;
+  long numSkipped;
+
+  fileName = test_writeFile ("stale.sam","r1\t0\tchr1\t1\t255\t10M\t*\t0\t0\t*\t*\n");
+  index = recordIndex_build (fileName,RECORD_INDEX_SAM,1);
+  args.index = index;
+  args.fileName = fileName;
+  TEST_CHECK (!test_dies (test_seek,&args));
+  TEST_CHECK (recordIndex_getSeekCommand (index,fileName,1,&numSkipped) != NULL);
+  TEST_CHECK (numSkipped == 0);
+  if ((fp = fopen (fileName,"w")) == NULL) {
+    die ("Unable to rewrite %s",fileName);
+  }
+  fputs ("r2\t0\tchr1\t1\t255\t10M\t*\t0\t0\t*\t*\n",fp);
+  fclose (fp);
+  times[0].tv_sec = index->fileMtime + 1;
+  times[0].tv_nsec = index->fileMtimeNsec;
+  times[1] = times[0];
+  if (utimensat (AT_FDCWD,fileName,times,0) != 0) {
+    die ("Unable to set the modification time of %s",fileName);
+  }
+  TEST_CHECK (test_dies (test_seek,&args));
+  recordIndex_destroy (index);
+  hlr_free (fileName);
+}
+
+int main (int argc, char *argv[])
+{
+  test_init ("recordIndexTest");
+  test_skipRules ();
+  test_seekFormat (RECORD_INDEX_MRF);
+  test_seekFormat (RECORD_INDEX_SAM);
+  test_stale ();
+  return test_finish ();
+}
@@ -0,0 +1,151 @@
+/// @file samEntryTest.c
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Checks that the strings of a SamEntry live in its own packed buffer:
+/// the buffer is reused between lines, copies are independent of their
+/// source, and getAllEntries() returns the entries of a sequential parse.
+
+#define _GNU_SOURCE
+
+#include <bios/log.h>
+#include <bios/format.h>
+
+#include "mrf/sam.h"
+#include "testUtil.h"
+
+static char *longLine =
+  "read1\t99\tchr1\t100\t60\t10M\t=\t200\t110\tACGTACGTAC\tIIIIIIIIII\tNM:i:0\tMD:Z:10";
+static char *shortLine =
+  "r2\t4\t*\t0\t0\t*\t*\t0\t0\t*\t*";
+
+// The strings of an entry lie in its buffer, in field order
+static int test_isPacked (SamEntry *currSamEntry)
+{
+  char *end;
+
+  end = currSamEntry->data + currSamEntry->dataLength;
+  return currSamEntry->qname == currSamEntry->data &&
+    currSamEntry->rname > currSamEntry->qname && currSamEntry->rname < end &&
+    currSamEntry->cigar > currSamEntry->rname && currSamEntry->cigar < end &&
+    currSamEntry->mrnm > currSamEntry->cigar && currSamEntry->mrnm < end &&
+    (currSamEntry->seq == NULL || (currSamEntry->seq > currSamEntry->mrnm && currSamEntry->seq < end)) &&
+    (currSamEntry->qual == NULL || (currSamEntry->qual > currSamEntry->mrnm && currSamEntry->qual < end)) &&
+    (currSamEntry->tags == NULL || (currSamEntry->tags > currSamEntry->mrnm && currSamEntry->tags < end)) &&
+    currSamEntry->dataLength <= currSamEntry->dataCapacity;
+}
+
+static void test_checkLong (SamEntry *currSamEntry)
+{
+  TEST_CHECK_STR (currSamEntry->qname,"read1");
+  TEST_CHECK (currSamEntry->flags == 99);
+  TEST_CHECK_STR (currSamEntry->rname,"chr1");
+  TEST_CHECK (currSamEntry->pos == 100 && currSamEntry->mapq == 60);
+  TEST_CHECK_STR (currSamEntry->cigar,"10M");
+  TEST_CHECK_STR (currSamEntry->mrnm,"=");
+  TEST_CHECK (currSamEntry->mpos == 200 && currSamEntry->isize == 110);
+  TEST_CHECK_STR (currSamEntry->seq,"ACGTACGTAC");
+  TEST_CHECK_STR (currSamEntry->qual,"IIIIIIIIII");
+  TEST_CHECK_STR (currSamEntry->tags,"NM:i:0\tMD:Z:10");
+  TEST_CHECK (test_isPacked (currSamEntry));
+}
+
+static void test_checkShort (SamEntry *currSamEntry)
+{
+  TEST_CHECK_STR (currSamEntry->qname,"r2");
+  TEST_CHECK (currSamEntry->flags == 4);
+  TEST_CHECK_STR (currSamEntry->cigar,"*");
+  TEST_CHECK (currSamEntry->seq == NULL && currSamEntry->qual == NULL);
+  TEST_CHECK (currSamEntry->tags == NULL);
+  TEST_CHECK (test_isPacked (currSamEntry));
+}
+
+static void test_reuse (void)
+{
+  SamEntry *currSamEntry;
+  SamEntry *copy;
+  Stringa contents;
+  char *fileName,*data;
+
+  contents = stringCreate (200);
+  stringAppendf (contents,"%s\n%s\n%s\n%s\n",longLine,shortLine,longLine,shortLine);
+  fileName = test_writeFile ("reuse.sam",string (contents));
+  stringDestroy (contents);
+  samParser_initFromFile (fileName);
+  currSamEntry = samParser_nextEntry ();
+  test_checkLong (currSamEntry);
+
+  // A shorter line reuses the buffer
+  data = currSamEntry->data;
+  currSamEntry = samParser_nextEntry ();
+  TEST_CHECK (currSamEntry->data == data);
+  test_checkShort (currSamEntry);
+
+  // A copy keeps its values when the source is overwritten
+  copy = NULL;
+  samParser_copyEntry (&copy,currSamEntry);
+  currSamEntry = samParser_nextEntry ();
+  test_checkShort (copy);
+  test_checkLong (currSamEntry);
+
+  // Copying into an existing copy grows its buffer as needed
+  samParser_copyEntry (&copy,currSamEntry);
+  TEST_CHECK (copy->data != currSamEntry->data);
+  test_checkLong (copy);
+  currSamEntry = samParser_nextEntry ();
+  test_checkLong (copy);
+  data = copy->data;
+  samParser_copyEntry (&copy,currSamEntry);
+  TEST_CHECK (copy->data == data);
+  test_checkShort (copy);
+
+  TEST_CHECK (samParser_nextEntry () == NULL);
+  samParser_deInit ();
+  samParser_freeEntry (copy);
+  hlr_free (fileName);
+}
+
+static void test_getAllEntries (void)
+{
+  GenConfig config;
+  SamEntry *currSamEntry;
+  Array entries;
+  Texta lines;
+  char *fileName;
+  int i,ok;
+
+  gen_initConfig (&config);
+  config.numRecords = 2000;
+  fileName = test_generate ("all.sam",GEN_FORMAT_SAM,&config);
+  lines = textCreate (2000);
+  samParser_initFromFile (fileName);
+  while ((currSamEntry = samParser_nextEntry ()) != NULL) {
+    textAdd (lines,samParser_writeEntry (currSamEntry));
+  }
+  samParser_deInit ();
+  samParser_initFromFile (fileName);
+  entries = samParser_getAllEntries ();
+  samParser_deInit ();
+  TEST_CHECK (arrayMax (entries) == arrayMax (lines));
+  ok = arrayMax (entries) == arrayMax (lines);
+  for (i = 0; ok && i < arrayMax (entries); i++) {
+    currSamEntry = arrp (entries,i,SamEntry);
+    ok = test_isPacked (currSamEntry) && currSamEntry->dataCapacity == currSamEntry->dataLength &&
+      (i == 0 || currSamEntry->data != (currSamEntry - 1)->data) &&
+      strEqual (samParser_writeEntry (currSamEntry),textItem (lines,i));
+  }
+  TEST_CHECK (ok);
+  destroySamEArray (entries);
+  textDestroy (lines);
+  hlr_free (fileName);
+}
+
+int main (int argc, char *argv[])
+{
+  test_init ("samEntryTest");
+  test_reuse ();
+  test_getAllEntries ();
+  return test_finish ();
+}
@@ -0,0 +1,253 @@
+/// @file samFilterTest.c
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Checks the SAM parser filter: skip reasons and counts on a hand-written
+/// file, that kept alignments of a random file parse as without a filter,
+/// that malformed lines are still rejected, and that initializing the
+/// parser, also through recordIndex_initSam(), removes the filter.
+
+#define _GNU_SOURCE
+
+#include <bios/log.h>
+#include <bios/format.h>
+
+#include "mrf/sam.h"
+#include "mrf/recordIndex.h"
+#include "testUtil.h"
+
+#define NUM_ALIGNMENTS 5000
+
+static char *fixture =
+  "@HD\tVN:1.4\n"
+  "a\t0\tchr1\t10\t60\t4M\t*\t0\t0\tACGT\tIIII\tNM:i:0\n"
+  "b\t4\t*\t0\t0\t*\t*\t0\t0\t*\t*\n"
+  "c\t260\tchr1\t10\t60\t4M\t*\t0\t0\t*\t*\n"
+  "d\t256\tchr1\t10\t60\t4M\t*\t0\t0\t*\t*\n"
+  "e\t512\tchr1\t10\t60\t4M\t*\t0\t0\t*\t*\n"
+  "f\t1024\tchr1\t10\t60\t4M\t*\t0\t0\t*\t*\n"
+  "g\t16\tchr1\t10\t60\t4M\t*\t0\t0\t*\t*\n"
+  "h\t0\tchr1\t10\t19\t4M\t*\t0\t0\t*\t*\n"
+  "i\t0\tchr3\t10\t60\t4M\t*\t0\t0\t*\t*\n"
+  "j\t0\tchr2\t10\t20\t4M\t*\t0\t0\t*\t*\n";
+
+static void test_initFilter (SamFilter *filter)
+{
+  filter->requiredFlags = 0;
+  filter->excludedFlags = S_QUERY_UNMAPPED | S_NOT_PRIMARY | S_FAILS_CHECKS | S_DUPLICATE;
+  filter->minMapq = 20;
+  filter->targetNames = NULL;
+}
+
+// QNAMEs of the remaining alignments, separated by commas
+static char* test_names (void)
+{
+  static Stringa buffer = NULL;
+  SamEntry *currSamEntry;
+
+  stringCreateClear (buffer,100);
+  while ((currSamEntry = samParser_nextEntry ()) != NULL) {
+    stringAppendf (buffer,"%s%s",stringLen (buffer) > 0 ? "," : "",currSamEntry->qname);
+  }
+  return string (buffer);
+}
+
+static void test_readFiltered (void *arg)
+{
+  SamFilter filter;
+
+  test_initFilter (&filter);
+  samParser_initFromFile ((char*)arg);
+  samParser_setFilter (&filter);
+  test_names ();
+  samParser_deInit ();
+}
+
+static void test_fixture (void)
+{
+  SamFilter filter;
+  long counts[SAM_SKIP_NUM_REASONS];
+  char *fileName;
+  int i;
+
+  fileName = test_writeFile ("fixture.sam",fixture);
+  test_initFilter (&filter);
+  filter.excludedFlags |= S_QUERY_STRAND;
+  filter.targetNames = textFieldtokP ("chr1,chr2",",");
+  samParser_initFromFile (fileName);
+  samParser_setFilter (&filter);
+  // The filter keeps its own copy of the targets
+  textDestroy (filter.targetNames);
+  TEST_CHECK_STR (test_names (),"a,j");
+  samParser_getSkipCounts (counts);
+  // c is unmapped and not primary, and counted as unmapped only
+  TEST_CHECK (counts[SAM_SKIP_REQUIRED_FLAGS] == 0 && counts[SAM_SKIP_UNMAPPED] == 2);
+  TEST_CHECK (counts[SAM_SKIP_NOT_PRIMARY] == 1 && counts[SAM_SKIP_FAILS_CHECKS] == 1);
+  TEST_CHECK (counts[SAM_SKIP_DUPLICATE] == 1 && counts[SAM_SKIP_OTHER_FLAGS] == 1);
+  TEST_CHECK (counts[SAM_SKIP_MAPQ] == 1 && counts[SAM_SKIP_TARGET] == 1);
+  samParser_deInit ();
+
+  test_initFilter (&filter);
+  filter.requiredFlags = S_QUERY_STRAND;
+  filter.excludedFlags = 0;
+  filter.minMapq = 0;
+  samParser_initFromFile (fileName);
+  samParser_setFilter (&filter);
+  TEST_CHECK_STR (test_names (),"g");
+  samParser_getSkipCounts (counts);
+  TEST_CHECK (counts[SAM_SKIP_REQUIRED_FLAGS] == 9);
+  samParser_deInit ();
+
+  // Initializing again removes the filter and the counts
+  samParser_initFromFile (fileName);
+  samParser_setFilter (&filter);
+  samParser_initFromFile (fileName);
+  TEST_CHECK_STR (test_names (),"a,b,c,d,e,f,g,h,i,j");
+  samParser_getSkipCounts (counts);
+  for (i = 0; i < SAM_SKIP_NUM_REASONS; i++) {
+    TEST_CHECK (counts[i] == 0);
+    TEST_CHECK (samParser_getSkipReason (i) != NULL);
+  }
+  samParser_deInit ();
+  TEST_CHECK (samParser_getSkipReason (-1) == NULL);
+  TEST_CHECK (samParser_getSkipReason (SAM_SKIP_NUM_REASONS) == NULL);
+  hlr_free (fileName);
+
+  // Lines cut before or after MAPQ are rejected, not skipped or kept
+  fileName = test_writeFile ("short.sam","a\t0\tchr1\n");
+  TEST_CHECK (test_dies (test_readFiltered,fileName));
+  hlr_free (fileName);
+  fileName = test_writeFile ("short.sam","a\t0\tchr1\t10\t60\n");
+  TEST_CHECK (test_dies (test_readFiltered,fileName));
+  hlr_free (fileName);
+  fileName = test_writeFile ("short.sam","a\t0\tchr1\t10\t60\t4M\t*\t0\t0\t*\t*\n"
+                             "b\t0\n");
+  TEST_CHECK (test_dies (test_readFiltered,fileName));
+  hlr_free (fileName);
+}
+
+// Reason the fixture filter with targets chr1 and chr2 skips an alignment
+static int test_reason (int flags, int mapq, char *rname)
+{
+  if ((flags & S_QUERY_UNMAPPED) != 0) {
+    return SAM_SKIP_UNMAPPED;
+  }
+  if ((flags & S_NOT_PRIMARY) != 0) {
+    return SAM_SKIP_NOT_PRIMARY;
+  }
+  if ((flags & S_FAILS_CHECKS) != 0) {
+    return SAM_SKIP_FAILS_CHECKS;
+  }
+  if ((flags & S_DUPLICATE) != 0) {
+    return SAM_SKIP_DUPLICATE;
+  }
+  if (mapq < 20) {
+    return SAM_SKIP_MAPQ;
+  }
+  if (!strEqual (rname,"chr1") && !strEqual (rname,"chr2")) {
+    return SAM_SKIP_TARGET;
+  }
+  return -1;
+}
+
+// Kept alignments are written as without a filter, and every other one
+// is counted under its reason
+static void test_random (void)
+{
+  static char *targets[] = {"chr1","chr2","chr3","chr10","*"};
+  static int flagBits[] = {S_READ_PAIRED,S_QUERY_UNMAPPED,S_QUERY_STRAND,S_FIRST,
+                           S_NOT_PRIMARY,S_FAILS_CHECKS,S_DUPLICATE};
+  SamFilter filter;
+  SamEntry *currSamEntry;
+  Stringa contents,expected,observed;
+  long expectedCounts[SAM_SKIP_NUM_REASONS],counts[SAM_SKIP_NUM_REASONS];
+  char *fileName,*rname;
+  int i,j,flags,mapq,reason,ok;
+
+  contents = stringCreate (100000);
+  memset (expectedCounts,0,sizeof (expectedCounts));
+  srand (5);
+  stringAppendf (contents,"@HD\tVN:1.4\n");
+  for (i = 0; i < NUM_ALIGNMENTS; i++) {
+    flags = 0;
+    for (j = 0; j < (int)(sizeof (flagBits) / sizeof (flagBits[0])); j++) {
+      if (rand () % 6 == 0) {
+        flags |= flagBits[j];
+      }
+    }
+    rname = targets[rand () % 5];
+    mapq = rand () % 61;
+    stringAppendf (contents,"q%d\t%d\t%s\t%d\t%d\t%dM\t*\t0\t0\t*\t*%s\n",i,flags,rname,
+                   1 + rand () % 1000,mapq,1 + rand () % 100,i % 3 == 0 ? "\tNM:i:1\tXS:A:+" : "");
+    if ((reason = test_reason (flags,mapq,rname)) >= 0) {
+      expectedCounts[reason]++;
+    }
+  }
+  fileName = test_writeFile ("random.sam",string (contents));
+  expected = stringCreate (100000);
+  observed = stringCreate (100000);
+  samParser_initFromFile (fileName);
+  while ((currSamEntry = samParser_nextEntry ()) != NULL) {
+    if (test_reason (currSamEntry->flags,currSamEntry->mapq,currSamEntry->rname) < 0) {
+      stringAppendf (expected,"%s\n",samParser_writeEntry (currSamEntry));
+    }
+  }
+  samParser_deInit ();
+  test_initFilter (&filter);
+  filter.targetNames = textFieldtokP ("chr1,chr2",",");
+  samParser_initFromFile (fileName);
+  samParser_setFilter (&filter);
+  while ((currSamEntry = samParser_nextEntry ()) != NULL) {
+    stringAppendf (observed,"%s\n",samParser_writeEntry (currSamEntry));
+  }
+  samParser_getSkipCounts (counts);
+  samParser_deInit ();
+  TEST_CHECK (stringLen (expected) > 0);
+  TEST_CHECK (strEqual (string (expected),string (observed)));
+  ok = 1;
+  for (i = 0; i < SAM_SKIP_NUM_REASONS; i++) {
+    ok = ok && counts[i] == expectedCounts[i];
+  }
+  TEST_CHECK (ok);
+  textDestroy (filter.targetNames);
+  stringDestroy (contents);
+  stringDestroy (expected);
+  stringDestroy (observed);
+  hlr_free (fileName);
+}
+
+// Starting at a record counts every alignment, whatever filter was set
+// before; a filter set afterwards applies from that record on
+static void test_recordIndex (void)
+{
+  SamFilter filter;
+  SamEntry *currSamEntry;
+  RecordIndex *index;
+  char *fileName;
+
+  fileName = test_writeFile ("indexed.sam",fixture);
+  index = recordIndex_build (fileName,RECORD_INDEX_SAM,4);
+  test_initFilter (&filter);
+  samParser_setFilter (&filter);
+  recordIndex_initSam (index,fileName,6);
+  currSamEntry = samParser_nextEntry ();
+  TEST_CHECK (currSamEntry != NULL && strEqual (currSamEntry->qname,"g"));
+  samParser_deInit ();
+  recordIndex_initSam (index,fileName,1);
+  samParser_setFilter (&filter);
+  TEST_CHECK_STR (test_names (),"g,i,j");
+  samParser_deInit ();
+  recordIndex_destroy (index);
+  hlr_free (fileName);
+}
+
+int main (int argc, char *argv[])
+{
+  test_init ("samFilterTest");
+  test_fixture ();
+  test_random ();
+  test_recordIndex ();
+  return test_finish ();
+}
@@ -0,0 +1,123 @@
+/// @file statsTest.c
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Checks the instrumentation counters of the MRF and SAM readers and
+/// writers on small fixtures, and that nothing is counted while counting
+/// is switched off. Built with MRF_ENABLE_STATS.
+
+#define _GNU_SOURCE
+
+#include <bios/log.h>
+#include <bios/format.h>
+
+#include "mrf/mrf.h"
+#include "mrf/sam.h"
+#include "mrf/stats.h"
+#include "testUtil.h"
+
+static char *mrfFixture =
+  "# comment\n"
+  "# another comment\n"
+  "AlignmentBlocks\tSequence\tQueryId\n"
+  "chr1:+:1:4:1:4\tACGT\tr1\n"
+  "\n"
+  "chr1:+:1:2:1:2,chr1:+:10:11:3:4\tACGT\tr2\n"
+  "# late comment\n"
+  "AlignmentBlocks\tSequence\tQueryId\n"
+  "chr1:+:1:4:1:4|chr1:-:20:23:1:4\tACGT|TTTT\tp1|p1\n";
+
+static char *samFixture =
+  "@HD\tVN:1.4\n"
+  "@SQ\tSN:chr1\tLN:1000\n"
+  "q1\t99\tchr1\t5\t60\t4M\t=\t50\t49\tACGT\tIIII\tNM:i:0\n"
+  "q1\t147\tchr1\t50\t60\t4M\t=\t5\t-49\tTTTT\tIIII\tNM:i:0\n"
+  "q2\t0\tchr1\t7\t60\t4M\t*\t0\t0\tACGT\tIIII\tNM:i:1\n";
+
+static void test_mrf (char *fileName)
+{
+  MrfStats stats;
+  MrfEntry *currEntry;
+  long bytesWritten;
+
+  mrf_init (fileName);
+  bytesWritten = 0;
+  while ((currEntry = mrf_nextEntry ()) != NULL) {
+    bytesWritten += strlen (mrf_writeEntry (currEntry));
+  }
+  mrf_getStats (&stats);
+  mrf_deInit ();
+  TEST_CHECK (stats.bytesRead == strlen (mrfFixture));
+  TEST_CHECK (stats.lines == 9);
+  TEST_CHECK (stats.commentLines == 3 && stats.headerLines == 2 && stats.emptyLines == 1);
+  TEST_CHECK (stats.entries == 3 && stats.pairedEntries == 1 && stats.singleEntries == 2);
+  TEST_CHECK (stats.blocks == 5);
+  TEST_CHECK (stats.bytesAllocated > 0);
+  TEST_CHECK (stats.entriesWritten == 3 && stats.bytesWritten == bytesWritten);
+  TEST_CHECK (stats.nsParse > 0 && stats.nsWrite > 0);
+}
+
+static void test_sam (char *fileName)
+{
+  MrfStats stats;
+  SamEntry *currSamEntry;
+  long bytesWritten;
+
+  samParser_initFromFile (fileName);
+  bytesWritten = 0;
+  while ((currSamEntry = samParser_nextEntry ()) != NULL) {
+    bytesWritten += strlen (samParser_writeEntry (currSamEntry));
+  }
+  samParser_getStats (&stats);
+  samParser_deInit ();
+  TEST_CHECK (stats.bytesRead == strlen (samFixture));
+  TEST_CHECK (stats.lines == 5 && stats.headerLines == 2);
+  TEST_CHECK (stats.entries == 3 && stats.pairedEntries == 2 && stats.singleEntries == 1);
+  TEST_CHECK (stats.bytesAllocated > 0);
+  TEST_CHECK (stats.entriesWritten == 3 && stats.bytesWritten == bytesWritten);
+}
+
+// Switched off, the readers count nothing, and initializing resets the
+// counters of an earlier run
+static void test_disabled (char *mrfFileName, char *samFileName)
+{
+  MrfStats stats,zero;
+  MrfEntry *currEntry;
+
+  memset (&zero,0,sizeof (MrfStats));
+  mrfStats_setEnabled (0);
+  TEST_CHECK (!mrfStats_isEnabled ());
+  mrf_init (mrfFileName);
+  while ((currEntry = mrf_nextEntry ()) != NULL) {
+    mrf_writeEntry (currEntry);
+  }
+  mrf_getStats (&stats);
+  mrf_deInit ();
+  TEST_CHECK (memcmp (&stats,&zero,sizeof (MrfStats)) == 0);
+  samParser_initFromFile (samFileName);
+  while (samParser_nextEntry () != NULL) {
+  }
+  samParser_getStats (&stats);
+  samParser_deInit ();
+  TEST_CHECK (memcmp (&stats,&zero,sizeof (MrfStats)) == 0);
+}
+
+int main (int argc, char *argv[])
+{
+  char *mrfFileName,*samFileName;
+
+  test_init ("statsTest");
+  mrfFileName = test_writeFile ("fixture.mrf",mrfFixture);
+  samFileName = test_writeFile ("fixture.sam",samFixture);
+  TEST_CHECK (mrfStats_isCompiled ());
+  mrfStats_setEnabled (1);
+  TEST_CHECK (mrfStats_isEnabled ());
+  test_mrf (mrfFileName);
+  test_sam (samFileName);
+  test_disabled (mrfFileName,samFileName);
+  hlr_free (mrfFileName);
+  hlr_free (samFileName);
+  return test_finish ();
+}
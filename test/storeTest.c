@@ -0,0 +1,233 @@
+/// @file storeTest.c
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Checks MrfStore against the MRF reader: every entry, read, block and
+/// string loaded into a store matches what mrf_nextEntry returns for the
+/// same file, for all columns and for a subset of them. Packed stores give
+/// back the sequences with other symbols as 'N' and the binned qualities.
+
+#define _GNU_SOURCE
+
+#include <ctype.h>
+
+#include <bios/log.h>
+#include <bios/format.h>
+
+#include "mrf/mrf.h"
+#include "mrf/mrfStore.h"
+#include "mrf/seqPack.h"
+#include "testUtil.h"
+
+static char *fixture =
+  "AlignmentBlocks\tSequence\tQueryId\n"
+  "chr1:+:1:4:1:4\tACGT\tr1\n"
+  "chr2:-:10:11:1:2,chr2:-:20:21:3:4\tTTGG\tr2\n"
+  "chr1:+:5:8:1:4|chr3:-:30:33:1:4\tAAAA|CCCC\tp1/1|p1/2\n";
+
+// Strings are equal or both NULL
+static int test_sameString (char *a, char *b)
+{
+  if (a == NULL || b == NULL) {
+    return a == b;
+  }
+  return strEqual (a,b);
+}
+
+static int test_sameRead (MrfStore *store, int read, MrfRead *currRead)
+{
+  MrfStoreBlock *storeBlocks;
+  MrfBlock *currBlock;
+  int i;
+
+  if (mrfStore_numBlocks (store,read) != arrayMax (currRead->blocks) ||
+      mrfStore_getReadLength (store,read) != getReadLength (currRead)) {
+    return 0;
+  }
+  storeBlocks = mrfStore_getBlocks (store,read);
+  for (i = 0; i < arrayMax (currRead->blocks); i++) {
+    currBlock = arrp (currRead->blocks,i,MrfBlock);
+    if (!strEqual (mrfStore_getTargetName (store,storeBlocks[i].targetId),currBlock->targetName) ||
+        storeBlocks[i].strand != currBlock->strand ||
+        storeBlocks[i].targetStart != currBlock->targetStart ||
+        storeBlocks[i].targetEnd != currBlock->targetEnd ||
+        storeBlocks[i].queryStart != currBlock->queryStart ||
+        storeBlocks[i].queryEnd != currBlock->queryEnd) {
+      return 0;
+    }
+  }
+  return test_sameString (mrfStore_getSequence (store,read),currRead->sequence) &&
+    test_sameString (mrfStore_getQualityScores (store,read),currRead->qualityScores) &&
+    test_sameString (mrfStore_getQueryId (store,read),currRead->queryId);
+}
+
+// Reads fileName again and compares each entry with the store; returns the
+// number of entries that differ, or -1 if the counts differ
+static int test_compare (MrfStore *store, char *fileName, int columns)
+{
+  MrfEntry *currEntry;
+  int entry,numDiffs,ok;
+
+  mrf_initWithColumns (fileName,columns);
+  entry = 0;
+  numDiffs = 0;
+  while ((currEntry = mrf_nextEntry ()) != NULL) {
+    if (entry >= mrfStore_numEntries (store)) {
+      entry++;
+      continue;
+    }
+    ok = mrfStore_isPairedEnd (store,entry) == (currEntry->isPairedEnd == 1) &&
+      test_sameRead (store,mrfStore_getRead (store,entry,0),&currEntry->read1);
+    if (ok && currEntry->isPairedEnd == 1) {
+      ok = test_sameRead (store,mrfStore_getRead (store,entry,1),&currEntry->read2);
+    }
+    numDiffs += !ok;
+    entry++;
+  }
+  mrf_deInit ();
+  return entry == mrfStore_numEntries (store) ? numDiffs : -1;
+}
+
+static void test_fixture (void)
+{
+  MrfStore *store;
+  char *fileName;
+
+  fileName = test_writeFile ("fixture.mrf",fixture);
+  mrf_init (fileName);
+  store = mrfStore_parse ();
+  mrf_deInit ();
+  TEST_CHECK (mrfStore_numEntries (store) == 3 && mrfStore_numReads (store) == 4);
+  TEST_CHECK (!mrfStore_isPairedEnd (store,1) && mrfStore_isPairedEnd (store,2));
+  TEST_CHECK (mrfStore_numBlocks (store,mrfStore_getRead (store,1,0)) == 2);
+  TEST_CHECK (mrfStore_numTargets (store) == 3);
+  TEST_CHECK_STR (mrfStore_getTargetName (store,mrfStore_getBlocks (store,3)->targetId),"chr3");
+  TEST_CHECK_STR (mrfStore_getSequence (store,mrfStore_getRead (store,2,1)),"CCCC");
+  TEST_CHECK_STR (mrfStore_getQueryId (store,mrfStore_getRead (store,2,0)),"p1/1");
+  TEST_CHECK (mrfStore_getQualityScores (store,0) == NULL);
+  TEST_CHECK (test_compare (store,fileName,MRF_COLUMNS_ALL) == 0);
+  mrfStore_destroy (store);
+  hlr_free (fileName);
+}
+
+// Enough reads and targets to grow the string arena and the target index
+static void test_generated (void)
+{
+  GenConfig config;
+  MrfStore *store;
+  MrfEntry *currEntry;
+  char *fileName;
+  int columns;
+
+  gen_initConfig (&config);
+  config.numRecords = 20000;
+  config.numTargets = 600;
+  config.columns = MRF_COLUMN_MASK (MRF_COLUMN_TYPE_BLOCKS) |
+    MRF_COLUMN_MASK (MRF_COLUMN_TYPE_SEQUENCE) | MRF_COLUMN_MASK (MRF_COLUMN_TYPE_QUALITY_SCORES) |
+    MRF_COLUMN_MASK (MRF_COLUMN_TYPE_QUERY_ID);
+  fileName = test_generate ("generated.mrf",GEN_FORMAT_MRF,&config);
+
+  mrf_init (fileName);
+  store = mrfStore_parse ();
+  mrf_deInit ();
+  TEST_CHECK (mrfStore_numEntries (store) == config.numRecords);
+  TEST_CHECK (mrfStore_numTargets (store) > 512);
+  TEST_CHECK (test_compare (store,fileName,MRF_COLUMNS_ALL) == 0);
+  mrfStore_destroy (store);
+
+  // A store keeps only its own columns of the entries added to it
+  columns = MRF_COLUMN_MASK (MRF_COLUMN_TYPE_BLOCKS) | MRF_COLUMN_MASK (MRF_COLUMN_TYPE_QUERY_ID);
+  store = mrfStore_create (columns);
+  mrf_init (fileName);
+  while ((currEntry = mrf_nextEntry ()) != NULL) {
+    mrfStore_addEntry (store,currEntry);
+  }
+  mrf_deInit ();
+  TEST_CHECK (test_compare (store,fileName,columns) == 0);
+  mrfStore_destroy (store);
+  hlr_free (fileName);
+}
+
+// Sequences and qualities of a packed store expand to what packing and
+// binning the reader's strings gives
+static int test_samePacked (MrfStore *store, int read, MrfRead *currRead)
+{
+  char buffer[1000];
+  int i,length,base;
+
+  length = strlen (currRead->sequence);
+  if (mrfStore_getSequenceLength (store,read) != length ||
+      mrfStore_copySequence (store,read,buffer) != length) {
+    return 0;
+  }
+  for (i = 0; i < length; i++) {
+    base = toupper (currRead->sequence[i]);
+    if (buffer[i] != (strchr ("ACGT",base) != NULL ? base : 'N')) {
+      return 0;
+    }
+  }
+  if (mrfStore_copyQualityScores (store,read,buffer) != length) {
+    return 0;
+  }
+  for (i = 0; i < length; i++) {
+    if (buffer[i] != seqPack_getBinQuality (seqPack_getQualityBin (currRead->qualityScores[i]))) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+// Every read has exceptions, so the arena also grows while they are added
+static void test_packed (void)
+{
+  Stringa contents;
+  MrfStore *store;
+  MrfEntry *currEntry;
+  char *fileName;
+  int entry,i,ok;
+
+  contents = stringCreate (1000000);
+  stringCat (contents,"AlignmentBlocks\tSequence\tQualityScores\n");
+  for (entry = 0; entry < 5000; entry++) {
+    stringAppendf (contents,"chr1:+:%d:%d:1:100\t",entry + 1,entry + 100);
+    for (i = 0; i < 100; i++) {
+      stringCatChar (contents,(i * 7 + entry) % 5 == 0 ? "NRY."[(i + entry) % 4] : "ACGTacgt"[(i + entry) % 8]);
+    }
+    stringCatChar (contents,'\t');
+    for (i = 0; i < 100; i++) {
+      stringCatChar (contents,33 + (i * 3 + entry) % 42);
+    }
+    stringCatChar (contents,'\n');
+  }
+  fileName = test_writeFile ("packed.mrf",string (contents));
+  stringDestroy (contents);
+
+  mrf_init (fileName);
+  store = mrfStore_parsePacked (MRF_STORE_PACK_SEQUENCES | MRF_STORE_BIN_QUALITIES);
+  mrf_deInit ();
+  TEST_CHECK (mrfStore_numEntries (store) == 5000);
+  TEST_CHECK (mrfStore_getSequence (store,0) == NULL && mrfStore_getQualityScores (store,0) == NULL);
+  mrf_init (fileName);
+  ok = 1;
+  entry = 0;
+  while ((currEntry = mrf_nextEntry ()) != NULL) {
+    ok = ok && entry < mrfStore_numEntries (store) &&
+      test_samePacked (store,mrfStore_getRead (store,entry,0),&currEntry->read1);
+    entry++;
+  }
+  mrf_deInit ();
+  TEST_CHECK (ok && entry == mrfStore_numEntries (store));
+  mrfStore_destroy (store);
+  hlr_free (fileName);
+}
+
+int main (int argc, char *argv[])
+{
+  test_init ("storeTest");
+  test_fixture ();
+  test_generated ();
+  test_packed ();
+  return test_finish ();
+}
@@ -0,0 +1,257 @@
+/// @file tarCacheTest.c
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Checks the tar cache against readTarsFromBedFile(): sort order, target
+/// lookups and overlap queries on a hand-written file with nested tars and
+/// on a synthetic file, and that stale, corrupt or truncated caches are
+/// rejected and rebuilt.
+
+#define _GNU_SOURCE
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include <bios/log.h>
+#include <bios/format.h>
+
+#include "mrf/tarCache.h"
+#include "testUtil.h"
+
+// Tars as "target:start-end", separated by commas
+static char* test_tars (TarCache *cache)
+{
+  static Stringa buffer = NULL;
+  Array tars;
+  Tar *currTar;
+  int i;
+
+  stringCreateClear (buffer,100);
+  tars = tarCache_getTars (cache);
+  for (i = 0; i < arrayMax (tars); i++) {
+    currTar = arrp (tars,i,Tar);
+    stringAppendf (buffer,"%s%s:%d-%d",i > 0 ? "," : "",currTar->targetName,
+                   currTar->start,currTar->end);
+  }
+  arrayDestroy (tars);
+  return string (buffer);
+}
+
+// Overlapping tars as "start-end", separated by commas
+static char* test_overlaps (TarCache *cache, char *targetName, int start, int end)
+{
+  static Stringa buffer = NULL;
+  static Array overlaps = NULL;
+  CachedTar *currTar;
+  int i,n;
+
+  stringCreateClear (buffer,100);
+  if (overlaps == NULL) {
+    overlaps = arrayCreate (100,int);
+  }
+  n = tarCache_findOverlaps (cache,targetName,start,end,overlaps);
+  for (i = 0; i < arrayMax (overlaps); i++) {
+    currTar = cache->tars + arru (overlaps,i,int);
+    stringAppendf (buffer,"%s%d-%d",i > 0 ? "," : "",currTar->start,currTar->end);
+  }
+  return n == arrayMax (overlaps) ? string (buffer) : "count mismatch";
+}
+
+static void test_rewrite (char *fileName, char *contents, long mtime, long mtimeNsec)
+{
+  FILE *fp;
+  struct timespec times[2];
+
+  if ((fp = fopen (fileName,"w")) == NULL) {
+    die ("Unable to rewrite %s",fileName);
+  }
+  fputs (contents,fp);
+  fclose (fp);
+  times[0].tv_sec = mtime;
+  times[0].tv_nsec = mtimeNsec;
+  times[1] = times[0];
+  if (utimensat (AT_FDCWD,fileName,times,0) != 0) {
+    die ("Unable to set the modification time of %s",fileName);
+  }
+}
+
+static void test_fixture (void)
+{
+  TarCache *cache;
+  struct stat st;
+  FILE *fp;
+  char *bedFileName,*cacheFileName;
+
+  bedFileName = test_writeFile ("fixture.bed",
+                                "browser position chr1:1-100\n"
+                                "track name=tars\n"
+                                "chr2\t50\t60\tb\n"
+                                "chr1\t100\t200\n"
+                                "chr1\t0\t1000\tlong\n"
+                                "chr1\t300\t310\n"
+                                "chr10\t5\t6\n"
+                                "chr1\t100\t150\n");
+  cacheFileName = test_path ("fixture.tarc");
+  TEST_CHECK (tarCache_open (cacheFileName,bedFileName) == NULL);
+  cache = tarCache_attach (bedFileName,cacheFileName);
+  TEST_CHECK (cache->numTargets == 3 && cache->numTars == 6);
+  TEST_CHECK_STR (test_tars (cache),
+                  "chr1:0-1000,chr1:100-150,chr1:100-200,chr1:300-310,chr10:5-6,chr2:50-60");
+  TEST_CHECK (tarCache_getTargetId (cache,"chr10") == 1);
+  TEST_CHECK_STR (tarCache_getTargetName (cache,2),"chr2");
+  TEST_CHECK (tarCache_getTargetId (cache,"chr3") == -1);
+  TEST_CHECK (tarCache_getTargetId (cache,"chr") == -1);
+
+  // Start is 0-based and end exclusive; the long tar is found past the
+  // shorter ones that end before the query
+  TEST_CHECK_STR (test_overlaps (cache,"chr1",250,300),"0-1000");
+  TEST_CHECK_STR (test_overlaps (cache,"chr1",250,301),"0-1000,300-310");
+  TEST_CHECK_STR (test_overlaps (cache,"chr1",149,150),"0-1000,100-150,100-200");
+  TEST_CHECK_STR (test_overlaps (cache,"chr1",1000,2000),"");
+  TEST_CHECK_STR (test_overlaps (cache,"chr10",6,7),"");
+  TEST_CHECK_STR (test_overlaps (cache,"chr10",0,6),"5-6");
+  TEST_CHECK_STR (test_overlaps (cache,"chr3",0,100),"");
+  tarCache_close (cache);
+
+  // Without a BED file only the cache itself is checked
+  cache = tarCache_open (cacheFileName,NULL);
+  TEST_CHECK (cache != NULL && cache->numTars == 6);
+  tarCache_close (cache);
+
+  // Same size, other modification time: stale and rebuilt
+  if (stat (bedFileName,&st) != 0) {
+    die ("Unable to stat %s",bedFileName);
+  }
+  test_rewrite (bedFileName,
+                "browser position chr1:1-100\n"
+                "track name=tars\n"
+                "chr2\t50\t60\tb\n"
+                "chr1\t100\t200\n"
+                "chr1\t0\t1000\tlong\n"
+                "chr1\t300\t310\n"
+                "chr10\t5\t6\n"
+                "chr1\t100\t159\n",
+                st.st_mtim.tv_sec + 1,st.st_mtim.tv_nsec);
+  TEST_CHECK (tarCache_open (cacheFileName,bedFileName) == NULL);
+  cache = tarCache_open (cacheFileName,NULL);
+  TEST_CHECK (cache != NULL);
+  tarCache_close (cache);
+  cache = tarCache_attach (bedFileName,cacheFileName);
+  TEST_CHECK_STR (test_overlaps (cache,"chr1",149,150),"0-1000,100-159,100-200");
+  tarCache_close (cache);
+
+  // A changed byte fails the checksum
+  if ((fp = fopen (cacheFileName,"r+")) == NULL) {
+    die ("Unable to open %s",cacheFileName);
+  }
+  fseek (fp,-2,SEEK_END);
+  fputc ('x',fp);
+  fclose (fp);
+  TEST_CHECK (tarCache_open (cacheFileName,NULL) == NULL);
+  cache = tarCache_attach (bedFileName,cacheFileName);
+  TEST_CHECK (cache != NULL && tarCache_getTargetId (cache,"chr2") == 2);
+  tarCache_close (cache);
+
+  // A partial file fails the length check
+  if (stat (cacheFileName,&st) != 0 || truncate (cacheFileName,st.st_size - 1) != 0) {
+    die ("Unable to truncate %s",cacheFileName);
+  }
+  TEST_CHECK (tarCache_open (cacheFileName,NULL) == NULL);
+  if (truncate (cacheFileName,10) != 0) {
+    die ("Unable to truncate %s",cacheFileName);
+  }
+  TEST_CHECK (tarCache_open (cacheFileName,NULL) == NULL);
+  hlr_free (cacheFileName);
+  hlr_free (bedFileName);
+}
+
+static int test_sortTars (Tar *a, Tar *b)
+{
+  if (a->start != b->start) {
+    return a->start < b->start ? -1 : 1;
+  }
+  return a->end < b->end ? -1 : a->end > b->end;
+}
+
+// Overlaps of random queries against a scan of readTarsFromBedFile()
+static void test_generated (void)
+{
+  GenConfig config;
+  TarCache *cache;
+  Array tars,hits,overlaps;
+  Stringa expected,observed;
+  Tar *currTar;
+  CachedTar *cachedTar;
+  char *bedFileName,*cacheFileName,*targetName;
+  int i,j,start,end,ok,numHits;
+
+  gen_initConfig (&config);
+  config.numRecords = 5000;
+  bedFileName = test_generate ("generated.bed",GEN_FORMAT_BED,&config);
+  cacheFileName = test_path ("generated.tarc");
+  cache = tarCache_attach (bedFileName,cacheFileName);
+  tars = readTarsFromBedFile (bedFileName);
+  TEST_CHECK (cache->numTars == arrayMax (tars));
+  hits = arrayCreate (100,Tar);
+  overlaps = arrayCreate (100,int);
+  expected = stringCreate (1000);
+  observed = stringCreate (1000);
+  srand (11);
+  ok = 1;
+  numHits = 0;
+  for (i = 0; ok && i < 2000; i++) {
+    // Query around a random tar, so that most queries hit something
+    currTar = arrp (tars,rand () % arrayMax (tars),Tar);
+    targetName = currTar->targetName;
+    start = currTar->start - 5000 + rand () % 10000;
+    end = start + 1 + rand () % 3000;
+    arrayClear (hits);
+    for (j = 0; j < arrayMax (tars); j++) {
+      currTar = arrp (tars,j,Tar);
+      if (strEqual (currTar->targetName,targetName) && currTar->start < end &&
+          currTar->end > start) {
+        array (hits,arrayMax (hits),Tar) = *currTar;
+      }
+    }
+    // The scan is in file order, the cache in start and end order
+    arraySort (hits,(ARRAYORDERF)test_sortTars);
+    stringClear (expected);
+    for (j = 0; j < arrayMax (hits); j++) {
+      currTar = arrp (hits,j,Tar);
+      stringAppendf (expected,"%s:%d-%d,",targetName,currTar->start,currTar->end);
+    }
+    stringClear (observed);
+    tarCache_findOverlaps (cache,targetName,start,end,overlaps);
+    for (j = 0; j < arrayMax (overlaps); j++) {
+      cachedTar = cache->tars + arru (overlaps,j,int);
+      stringAppendf (observed,"%s:%d-%d,",tarCache_getTargetName (cache,cachedTar->targetId),
+                     cachedTar->start,cachedTar->end);
+    }
+    ok = strEqual (string (expected),string (observed));
+    numHits += arrayMax (overlaps) > 0;
+  }
+  TEST_CHECK (ok);
+  TEST_CHECK (numHits > 1000);
+  tarCache_close (cache);
+  for (i = 0; i < arrayMax (tars); i++) {
+    hlr_free (arrp (tars,i,Tar)->targetName);
+  }
+  arrayDestroy (tars);
+  arrayDestroy (hits);
+  arrayDestroy (overlaps);
+  stringDestroy (expected);
+  stringDestroy (observed);
+  hlr_free (cacheFileName);
+  hlr_free (bedFileName);
+}
+
+int main (int argc, char *argv[])
+{
+  test_init ("tarCacheTest");
+  test_fixture ();
+  test_generated ();
+  return test_finish ();
+}
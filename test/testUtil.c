@@ -0,0 +1,194 @@
+/// @file testUtil.c
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Helpers shared by the check programs run by make check.
+
+#define _GNU_SOURCE
+
+#include <fcntl.h>
+#include <ftw.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include <bios/log.h>
+#include <bios/format.h>
+
+#include "testUtil.h"
+
+static char *testName = NULL;
+static char scratchDir[4096];
+static int numChecks = 0;
+static int numFailures = 0;
+
+/**
+ * Create the scratch directory of a check program.
+ * @param[in] name Name of the program, used in messages
+ */
+void test_init (char *name)
+{
+  char *tmp;
+
+  testName = name;
+  tmp = getenv ("TMPDIR");
+  snprintf (scratchDir,sizeof (scratchDir),"%s/%s.XXXXXX",tmp != NULL ? tmp : "/tmp",name);
+  if (mkdtemp (scratchDir) == NULL) {
+    die ("Unable to create scratch directory");
+  }
+}
+
+static int test_removeFile (const char *path, const struct stat *sb, int flag, struct FTW *ftw)
+{
+  return remove (path);
+}
+
+/**
+ * Remove the scratch directory and report the result.
+ * @return Exit status of the program
+ */
+int test_finish (void)
+{
+  nftw (scratchDir,test_removeFile,16,FTW_DEPTH | FTW_PHYS);
+  fprintf (stderr,"%s: %d checks, %d failed\n",testName,numChecks,numFailures);
+  return numFailures == 0 ? 0 : 1;
+}
+
+/**
+ * Count a check and report it if it failed.
+ * @return ok
+ */
+int test_check (int ok, char *expression, char *file, int line)
+{
+  numChecks++;
+  if (!ok) {
+    numFailures++;
+    fprintf (stderr,"%s:%d: check failed: %s\n",file,line,expression);
+  }
+  return ok;
+}
+
+/**
+ * Check that two strings, either of which may be NULL, are equal.
+ * @return 1 if they are equal
+ */
+int test_checkString (char *a, char *b, char *expression, char *file, int line)
+{
+  int ok;
+
+  ok = (a == NULL && b == NULL) || (a != NULL && b != NULL && strEqual (a,b));
+  numChecks++;
+  if (!ok) {
+    numFailures++;
+    fprintf (stderr,"%s:%d: check failed: %s: \"%s\" != \"%s\"\n",file,line,expression,
+             a != NULL ? a : "(null)",b != NULL ? b : "(null)");
+  }
+  return ok;
+}
+
+/**
+ * Returns the path of a file in the scratch directory.
+ * @note The caller frees the path with hlr_free ().
+ */
+char* test_path (char *name)
+{
+  Stringa path;
+  char *result;
+
+  path = stringCreate (100);
+  stringPrintf (path,"%s/%s",scratchDir,name);
+  result = hlr_strdup (string (path));
+  stringDestroy (path);
+  return result;
+}
+
+/**
+ * Write a fixture into the scratch directory.
+ * @return Path of the file, see test_path ()
+ */
+char* test_writeFile (char *name, char *contents)
+{
+  FILE *fp;
+  char *path;
+
+  path = test_path (name);
+  if ((fp = fopen (path,"w")) == NULL) {
+    die ("Unable to create %s",path);
+  }
+  fputs (contents,fp);
+  fclose (fp);
+  return path;
+}
+
+/**
+ * Write a synthetic fixture into the scratch directory.
+ * @return Path of the file, see test_path ()
+ */
+char* test_generate (char *name, int format, GenConfig *config)
+{
+  FILE *fp;
+  char *path;
+
+  path = test_path (name);
+  if ((fp = fopen (path,"w")) == NULL) {
+    die ("Unable to create %s",path);
+  }
+  gen_write (fp,format,config);
+  fclose (fp);
+  return path;
+}
+
+/**
+ * Returns the contents of a file.
+ * @note The caller frees the contents with hlr_free ().
+ */
+char* test_readFile (char *path)
+{
+  Stringa contents;
+  FILE *fp;
+  char *result;
+  int c;
+
+  if ((fp = fopen (path,"r")) == NULL) {
+    die ("Unable to open %s",path);
+  }
+  contents = stringCreate (1000);
+  while ((c = getc (fp)) != EOF) {
+    stringCatChar (contents,c);
+  }
+  fclose (fp);
+  result = hlr_strdup (string (contents));
+  stringDestroy (contents);
+  return result;
+}
+
+/**
+ * Run a function in a child process, e.g. to check that it calls die ().
+ * Messages of the child on stderr are discarded.
+ * @return 1 if the child exited with a non-zero status or was killed
+ */
+int test_dies (void (*function) (void *arg), void *arg)
+{
+  pid_t pid;
+  int status,fd;
+
+  fflush (stdout);
+  fflush (stderr);
+  pid = fork ();
+  if (pid < 0) {
+    die ("Unable to fork");
+  }
+  if (pid == 0) {
+    if ((fd = open ("/dev/null",O_WRONLY)) >= 0) {
+      dup2 (fd,2);
+    }
+    function (arg);
+    _exit (0);
+  }
+  if (waitpid (pid,&status,0) != pid) {
+    die ("Unable to wait for the child");
+  }
+  return !WIFEXITED (status) || WEXITSTATUS (status) != 0;
+}
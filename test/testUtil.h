@@ -0,0 +1,34 @@
+/// @file testUtil.h
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Helpers shared by the check programs run by make check. Every program
+/// writes its fixtures into a fresh scratch directory, counts failed
+/// checks and exits with status 1 if any check failed.
+
+#ifndef DEF_TEST_UTIL_H
+#define DEF_TEST_UTIL_H
+
+#include "bench/generator.h"
+
+/// Record a failed check with its location; the program goes on.
+#define TEST_CHECK(cond) \
+  test_check ((cond) != 0,#cond,__FILE__,__LINE__)
+
+/// Compare two strings, either of which may be NULL.
+#define TEST_CHECK_STR(a,b) \
+  test_checkString ((a),(b),#a,__FILE__,__LINE__)
+
+void test_init (char *name);
+int test_finish (void);
+int test_check (int ok, char *expression, char *file, int line);
+int test_checkString (char *a, char *b, char *expression, char *file, int line);
+char* test_path (char *name);
+char* test_writeFile (char *name, char *contents);
+char* test_generate (char *name, int format, GenConfig *config);
+char* test_readFile (char *path);
+int test_dies (void (*function) (void *arg), void *arg);
+
+#endif /* DEF_TEST_UTIL_H */
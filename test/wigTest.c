@@ -0,0 +1,189 @@
+/// @file wigTest.c
+/// @version 0.8.0
+/// @since 18 Oct 2026
+///
+/// @section DESCRIPTION
+///
+/// Checks the wig and bedGraph reader on hand-written files covering
+/// declarations, span, step, CRLF and an unterminated last line, and on
+/// synthetic files against a line-by-line reference reader.
+
+#define _GNU_SOURCE
+
+#include <bios/log.h>
+#include <bios/format.h>
+#include <bios/linestream.h>
+
+#include "mrf/wigParser.h"
+#include "testUtil.h"
+
+// Positions and values of a target as "position=value" pairs
+static char* test_wigs (Array wigs)
+{
+  static Stringa buffer = NULL;
+  Wig *currWig;
+  int i;
+
+  stringCreateClear (buffer,100);
+  for (i = 0; i < arrayMax (wigs); i++) {
+    currWig = arrp (wigs,i,Wig);
+    stringAppendf (buffer,"%s%d=%g",i > 0 ? "," : "",currWig->position,currWig->value);
+  }
+  return string (buffer);
+}
+
+static char* test_intervals (Array intervals)
+{
+  static Stringa buffer = NULL;
+  WigInterval *currInterval;
+  int i;
+
+  stringCreateClear (buffer,100);
+  for (i = 0; i < arrayMax (intervals); i++) {
+    currInterval = arrp (intervals,i,WigInterval);
+    stringAppendf (buffer,"%s%d-%d=%g",i > 0 ? "," : "",currInterval->start,
+                   currInterval->end,currInterval->value);
+  }
+  return string (buffer);
+}
+
+static void test_fixture (void)
+{
+  Array wigs,intervals;
+  char *fileName;
+
+  wigs = arrayCreate (100,Wig);
+  intervals = arrayCreate (100,WigInterval);
+  fileName = test_writeFile ("fixture.wig",
+                             "track type=wiggle_0 name=test\n"
+                             "# comment\n"
+                             "fixedStep chrom=chr1 start=10 step=5 span=2\n"
+                             "1.5\n"
+                             "2\r\n"
+                             "\n"
+                             "fixedStep chrom=chr1 start=100 step=1\n"
+                             "3\n"
+                             "3\n"
+                             "variableStep chrom=chr2 span=3\n"
+                             "7\t0.25\n"
+                             "20 -1\n"
+                             "variableStep chrom=chr3\n"
+                             "5\t4");
+  wigParser_init (fileName);
+  TEST_CHECK_STR (wigParser_nextTarget (wigs),"chr1");
+  TEST_CHECK_STR (test_wigs (wigs),"10=1.5,11=1.5,15=2,16=2,100=3,101=3");
+  TEST_CHECK_STR (wigParser_nextTarget (wigs),"chr2");
+  TEST_CHECK_STR (test_wigs (wigs),"7=0.25,8=0.25,9=0.25,20=-1,21=-1,22=-1");
+  TEST_CHECK_STR (wigParser_nextTarget (wigs),"chr3");
+  TEST_CHECK_STR (test_wigs (wigs),"5=4");
+  TEST_CHECK (wigParser_nextTarget (wigs) == NULL);
+  wigParser_deInit ();
+
+  // Runs of consecutive positions with equal values are joined
+  wigParser_init (fileName);
+  TEST_CHECK_STR (wigParser_nextIntervals (intervals),"chr1");
+  TEST_CHECK_STR (test_intervals (intervals),"10-11=1.5,15-16=2,100-101=3");
+  wigParser_deInit ();
+  hlr_free (fileName);
+
+  fileName = test_writeFile ("fixture.bedGraph",
+                             "track type=bedGraph\r\n"
+                             "chr1\t0\t3\t1.5\r\n"
+                             "chr1\t3\t5\t1.5\r\n"
+                             "chr1\t10\t11\t2e1\r\n"
+                             "chr2\t99\t100\t0\n");
+  wigParser_init (fileName);
+  TEST_CHECK_STR (wigParser_nextIntervals (intervals),"chr1");
+  TEST_CHECK_STR (test_intervals (intervals),"1-5=1.5,11-11=20");
+  TEST_CHECK_STR (wigParser_nextTarget (wigs),"chr2");
+  TEST_CHECK_STR (test_wigs (wigs),"100=0");
+  TEST_CHECK (wigParser_nextIntervals (intervals) == NULL);
+  wigParser_deInit ();
+  hlr_free (fileName);
+
+  fileName = test_writeFile ("empty.wig","");
+  wigParser_init (fileName);
+  TEST_CHECK (wigParser_nextTarget (wigs) == NULL);
+  wigParser_deInit ();
+  hlr_free (fileName);
+  arrayDestroy (wigs);
+  arrayDestroy (intervals);
+}
+
+// Compare the reader with sscanf () on the lines of a synthetic file
+static void test_generated (int format)
+{
+  GenConfig config;
+  LineStream ls;
+  Array wigs;
+  Wig *currWig;
+  char target[100],name[100];
+  char *fileName,*line,*targetName;
+  int i,position,start,end,numTargets,ok;
+  double value;
+
+  gen_initConfig (&config);
+  config.numRecords = 20000;
+  fileName = test_generate (format == GEN_FORMAT_WIG ? "generated.wig" : "generated.bedGraph",
+                            format,&config);
+  wigs = arrayCreate (10000,Wig);
+  wigParser_init (fileName);
+  ls = ls_createFromFile (fileName);
+  ok = 1;
+  numTargets = 0;
+  i = 0;
+  position = 0;
+  targetName = NULL;
+  while (ok && (line = ls_nextLine (ls)) != NULL) {
+    if (strStartsWithC (line,"track")) {
+      continue;
+    }
+    if (format == GEN_FORMAT_WIG &&
+        sscanf (line,"fixedStep chrom=%99s start=%d",target,&position) == 2) {
+      continue;
+    }
+    if (format == GEN_FORMAT_BEDGRAPH) {
+      if (sscanf (line,"%99s %d %d %lf",target,&start,&end,&value) != 4) {
+        ok = 0;
+        break;
+      }
+    }
+    else {
+      value = atof (line);
+      start = position - 1;
+      end = position++;
+    }
+    if (targetName == NULL || !strEqual (target,name)) {
+      ok = i == arrayMax (wigs);
+      targetName = wigParser_nextTarget (wigs);
+      ok = ok && targetName != NULL && strEqual (targetName,target);
+      strcpy (name,target);
+      numTargets++;
+      i = 0;
+    }
+    for (start++; ok && start <= end; start++) {
+      ok = i < arrayMax (wigs);
+      if (ok) {
+        currWig = arrp (wigs,i,Wig);
+        ok = currWig->position == start && currWig->value == (float)value;
+      }
+      i++;
+    }
+  }
+  TEST_CHECK (ok && i == arrayMax (wigs));
+  TEST_CHECK (wigParser_nextTarget (wigs) == NULL);
+  TEST_CHECK (numTargets > 1);
+  ls_destroy (ls);
+  wigParser_deInit ();
+  arrayDestroy (wigs);
+  hlr_free (fileName);
+}
+
+int main (int argc, char *argv[])
+{
+  test_init ("wigTest");
+  test_fixture ();
+  test_generated (GEN_FORMAT_WIG);
+  test_generated (GEN_FORMAT_BEDGRAPH);
+  return test_finish ();
+}